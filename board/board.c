@@ -42,9 +42,16 @@ uint32_t BOARD_DebugConsoleSrcFreq(void)
 /* Initialize debug console. */
 void BOARD_InitDebugConsole(void)
 {
+#if BOARD_DEBUG_CONSOLE_SWO
+    /* GPIO_AD_B0_10 is muxed to ARM_TRACE_SWO by BOARD_InitPins(), the trace clock is gated off at boot. */
+    CLOCK_EnableClock(kCLOCK_Trace);
+    DbgConsole_Init(BOARD_DEBUG_SWO_PORT, BOARD_DEBUG_SWO_BAUDRATE, BOARD_DEBUG_UART_TYPE,
+                    CLOCK_GetClockRootFreq(kCLOCK_TraceClkRoot));
+#else
     uint32_t uartClkSrcFreq = BOARD_DebugConsoleSrcFreq();
 
     DbgConsole_Init(BOARD_DEBUG_UART_INSTANCE, BOARD_DEBUG_UART_BAUDRATE, BOARD_DEBUG_UART_TYPE, uartClkSrcFreq);
+#endif /* BOARD_DEBUG_CONSOLE_SWO */
 }
 
 #if defined(SDK_I2C_BASED_COMPONENT_USED) && SDK_I2C_BASED_COMPONENT_USED
@@ -335,13 +342,13 @@ void BOARD_ConfigMPU(void)
     MPU->RBAR = ARM_MPU_RBAR(4, 0x00000000U);
     MPU->RASR = ARM_MPU_RASR(0, ARM_MPU_AP_FULL, 2, 0, 0, 0, 0, ARM_MPU_REGION_SIZE_1GB);
 
-    /* Region 5 setting: Memory with Normal type, not shareable, outer/inner write back */
+    /* Region 5 setting: Memory with Normal type, not shareable, outer/inner write back, ITCM 64 KiB set by ResetISR() */
     MPU->RBAR = ARM_MPU_RBAR(5, 0x00000000U);
-    MPU->RASR = ARM_MPU_RASR(0, ARM_MPU_AP_FULL, 0, 0, 1, 1, 0, ARM_MPU_REGION_SIZE_128KB);
+    MPU->RASR = ARM_MPU_RASR(0, ARM_MPU_AP_FULL, 0, 0, 1, 1, 0, ARM_MPU_REGION_SIZE_64KB);
 
-    /* Region 6 setting: Memory with Normal type, not shareable, outer/inner write back */
+    /* Region 6 setting: Memory with Normal type, not shareable, outer/inner write back, DTCM 256 KiB set by ResetISR() */
     MPU->RBAR = ARM_MPU_RBAR(6, 0x20000000U);
-    MPU->RASR = ARM_MPU_RASR(0, ARM_MPU_AP_FULL, 0, 0, 1, 1, 0, ARM_MPU_REGION_SIZE_128KB);
+    MPU->RASR = ARM_MPU_RASR(0, ARM_MPU_AP_FULL, 0, 0, 1, 1, 0, ARM_MPU_REGION_SIZE_256KB);
 
     /* Region 7 setting: Memory with Normal type, not shareable, outer/inner write back */
     MPU->RBAR = ARM_MPU_RBAR(7, 0x20200000U);
@@ -19,8 +19,17 @@
 /*! @brief The board name */
 #define BOARD_NAME "MIMXRT1060-EVK"
 
+/* 1 sends the debug console over SWO (ITM stimulus ports) instead of LPUART1. */
+#ifndef BOARD_DEBUG_CONSOLE_SWO
+#define BOARD_DEBUG_CONSOLE_SWO 0
+#endif /* BOARD_DEBUG_CONSOLE_SWO */
+
 /* The UART to use for debug messages. */
+#if BOARD_DEBUG_CONSOLE_SWO
+#define BOARD_DEBUG_UART_TYPE     kSerialPort_Swo
+#else
 #define BOARD_DEBUG_UART_TYPE     kSerialPort_Uart
+#endif /* BOARD_DEBUG_CONSOLE_SWO */
 #define BOARD_DEBUG_UART_BASEADDR (uint32_t) LPUART1
 #define BOARD_DEBUG_UART_INSTANCE 1U
 
@@ -33,6 +42,12 @@
 #define BOARD_DEBUG_UART_BAUDRATE (115200U)
 #endif /* BOARD_DEBUG_UART_BAUDRATE */
 
+/* ITM stimulus port of PRINTF text and SWO bit rate, 132 MHz trace clock / 22. */
+#define BOARD_DEBUG_SWO_PORT 0U
+#ifndef BOARD_DEBUG_SWO_BAUDRATE
+#define BOARD_DEBUG_SWO_BAUDRATE (6000000U)
+#endif /* BOARD_DEBUG_SWO_BAUDRATE */
+
 /*! @brief The USER_LED used for board */
 #define LOGIC_LED_ON  (0U)
 #define LOGIC_LED_OFF (1U)
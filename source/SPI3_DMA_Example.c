@@ -11,55 +11,594 @@
 #include "pin_mux.h"
 #include "clock_config.h"
 #include "board.h"
+#include "spi3DMAApi.h"
+#include "spi3Bench.h"
+#include "spi3Buffer.h"
+#include "dbgLog.h"
+#include "cmdShell.h"
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-
+#define FRAME_SIZE (25)  // frame length at boot, the length command changes it
+#define FRAME_MAX_SIZE (512) // buffers are allocated for this length
+#define RX_SLOTS   (8)  // two IRQ batches of 4 at least, see SetSPI3RxBatch()
+#define SPI_INSTANCE       (3)  // LPSPI3
+#define TRIGGER_XBAR_INPUT (25) // XBAR1_IN25, GPIO_AD_B0_15
+#define PIT_PERIOD_US      (1000)
+#define RX_STREAM_LOG2     (16) // 64 KiB Rx stream
+#define RX_STREAM_SIZE     (1U << RX_STREAM_LOG2)
+#define DTCM_STREAM_LOG2   (17) // 128 KiB Rx stream, fits the 256 KiB DTCM set up by ResetISR()
+#define DTCM_STREAM_SIZE   (1U << DTCM_STREAM_LOG2)
+#define SDRAM_STREAM_LOG2  (23) // 8 MiB Rx stream, SEMC SDRAM brought up by dcd.c
+#define SDRAM_STREAM_SIZE  (1U << SDRAM_STREAM_LOG2)
+#define STREAM_MODES       (4)  // ring, OCRAM, DTCM and SDRAM stream
+#define DMA_POOL           (kSPI3_BufferCacheable) // any spi3_buffer_pool_t, Rx maintenance follows it
 
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
-extern void InitClocks();
-extern void InitSPI3Peripheral();
-extern void TxTest();
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static uint8_t *txBuffer;
+static uint8_t *rxBuffer;
+static uint8_t *rxRing;
+static spi3dma_handle_t *spi3;
+static uint8_t peripheralReady = 0; // init ran, the LPSPI3 registers are clocked
+static uint32_t frameLength = FRAME_SIZE;
+static uint32_t sckDivider = 50;    // the InitSPI3Peripheral() setting, 2 MHz
+static uint32_t pitPeriodUs = 0;    // 0 triggers on the GPIO edge
+static uint8_t captureArmed = 0;
+static uint8_t wordMode = 0;
+static uint32_t irqBatch = 1;
+static uint8_t streamMode = 0;
+// DMOD wraps on the low address bits, so the stream buffer is aligned to its size
+static uint8_t rxStream[RX_STREAM_SIZE] __attribute__((section(".bss.$SRAM_OC"), aligned(RX_STREAM_SIZE)));
+static uint8_t dtcmStream[DTCM_STREAM_SIZE] __attribute__((section(".bss.$SRAM_DTC"), aligned(DTCM_STREAM_SIZE)));
+// not zeroed by the startup code, 8 MiB of SDRAM writes would hold the boot up for nothing
+static uint8_t sdramStream[SDRAM_STREAM_SIZE] __attribute__((section(".noinit.$BOARD_SDRAM"), aligned(SDRAM_STREAM_SIZE)));
+
+static uint8_t * const streamBuffer[STREAM_MODES] = { 0, rxStream, dtcmStream, sdramStream };
+static const uint32_t streamLog2[STREAM_MODES] = { 0, RX_STREAM_LOG2, DTCM_STREAM_LOG2, SDRAM_STREAM_LOG2 };
+static const char * const streamName[STREAM_MODES] = { "off", "64 KiB OCRAM", "128 KiB DTCM", "8 MiB SDRAM" };
 
 /*******************************************************************************
  * Code
  ******************************************************************************/
+/*!
+ * @brief Print the frame that ends at writeIndex in a stream buffer
+ *
+ * The OCRAM and SDRAM stream buffers are cacheable, the lines the frame touches are
+ * invalidated before they are read since only the eDMA writes them.
+ */
+static void PrintStreamFrame(uint8_t *buffer, uint32_t size, uint32_t writeIndex)
+{
+    uint32_t start = (writeIndex + size - frameLength) & (size - 1);
+    uint32_t pos;
+
+    PRINTF("stream write index %u\r\n", writeIndex);
+    for (uint32_t idx = 0; idx < frameLength; idx++)
+    {
+        pos = (start + idx) & (size - 1);
+        if ((idx == 0) || ((pos & 31U) == 0))
+        {
+            SCB_InvalidateDCache_by_Addr(&buffer[pos & ~31U], 32);
+        }
+        PRINTF("%02x ", buffer[pos]);
+    }
+    PRINTF("\r\n");
+}
+
+/*!
+ * @brief Print the FlexRAM bank split ResetISR() configured
+ *
+ * Bank types come from IOMUXC_GPR17 when GPR16 FLEXRAM_BANK_CFG_SEL is set, from
+ * the fuses otherwise; the TCM sizes the core decodes are the GPR14 ones.
+ */
+static void PrintFlexRAMLayout(void)
+{
+    uint32_t bankCfg = IOMUXC_GPR->GPR17;
+    uint32_t banks[4] = {0};
+    uint32_t itcmSize = (IOMUXC_GPR->GPR14 & IOMUXC_GPR_GPR14_CM7_CFGITCMSZ_MASK) >> IOMUXC_GPR_GPR14_CM7_CFGITCMSZ_SHIFT;
+    uint32_t dtcmSize = (IOMUXC_GPR->GPR14 & IOMUXC_GPR_GPR14_CM7_CFGDTCMSZ_MASK) >> IOMUXC_GPR_GPR14_CM7_CFGDTCMSZ_SHIFT;
+
+    for (uint32_t bank = 0; bank < 16; bank++)
+    {
+        banks[(bankCfg >> (bank * 2)) & 3U]++;
+    }
+    PRINTF("FlexRAM %s: ITCM %u KiB, DTCM %u KiB, OCRAM %u KiB (GPR17 0x%08x)\r\n",
+           (IOMUXC_GPR->GPR16 & IOMUXC_GPR_GPR16_FLEXRAM_BANK_CFG_SEL_MASK) ? "GPR17" : "fuses",
+           itcmSize ? (1U << (itcmSize + 9)) / 1024U : 0, dtcmSize ? (1U << (dtcmSize + 9)) / 1024U : 0,
+           banks[1] * 32U, bankCfg);
+}
+
+
+/*
+ * Commands that touch LPSPI3 registers need the clocks of init.
+ */
+static uint8_t PeripheralReady(void)
+{
+    if (!peripheralReady)
+    {
+        PRINTF("run init first\r\n");
+    }
+    return peripheralReady;
+}
+
+static void FillTxBuffer(void)
+{
+    for (uint32_t idx = 0; idx < frameLength; idx++)
+    {
+        txBuffer[idx] = '0' + (idx % 10);
+    }
+    CleanSPI3Buffer(txBuffer, frameLength); // eDMA reads RAM, not the D-cache
+}
+
+static int32_t CmdInit(uint32_t argc, char *argv[])
+{
+    // initialize all clocks needed in this project
+    InitClocks();
+    InitSPI3Peripheral(spi3);
+    sckDivider = 50;
+    peripheralReady = 1;
+    return 0;
+}
+
+static int32_t CmdTxTest(uint32_t argc, char *argv[])
+{
+    // simple test to transmit ascii '0' to '9' out SPI3 port
+    if (PeripheralReady())
+    {
+        TxTest(spi3);
+    }
+    return 0;
+}
+
+static int32_t CmdLength(uint32_t argc, char *argv[])
+{
+    spi3_frame_t frame;
+    uint32_t length;
+    uint32_t previous = frameLength;
+
+    if (argc > 1)
+    {
+        if (CmdShellParseUint(argv[1], &length) || (length == 0) || (length > FRAME_MAX_SIZE))
+        {
+            return -1;
+        }
+        // takes effect on the next frame when the capture runs
+        frameLength = length;
+        FillTxBuffer();
+        frame.length = frameLength;
+        frame.txBuffer = txBuffer;
+        frame.rxBuffer = rxBuffer;
+        if (SetSPI3Frame(spi3, &frame))
+        {
+            frameLength = previous;
+            PRINTF("%u bytes not possible with this Rx setup, word mode with the Rx ring needs a multiple of 4\r\n", length);
+        }
+    }
+    PRINTF("frame %u bytes\r\n", frameLength);
+    return 0;
+}
+
+static int32_t CmdSck(uint32_t argc, char *argv[])
+{
+    uint32_t kHz;
+    uint32_t divider;
+
+    if (argc > 1)
+    {
+        if (CmdShellParseUint(argv[1], &kHz) || (kHz == 0))
+        {
+            return -1;
+        }
+        if (!PeripheralReady())
+        {
+            return 0;
+        }
+        // SCK = LPSPI_CLK_ROOT / (divider + 2), the closest rate not above the request
+        divider = (SPI3_LPSPI_CLK_HZ + (kHz * 1000U) - 1U) / (kHz * 1000U);
+        if (divider > 257)
+        {
+            // a divider of 255 would run faster than asked for
+            PRINTF("%u kHz at least, the divider ends at 255\r\n", ((SPI3_LPSPI_CLK_HZ / 257) + 999U) / 1000U);
+            return -1;
+        }
+        sckDivider = (divider < 2) ? 0 : (divider - 2);
+        SetSPI3SckDivider(spi3, sckDivider);
+    }
+    PRINTF("SCK %u kHz, divider %u\r\n", SPI3_LPSPI_CLK_HZ / 1000U / (sckDivider + 2), sckDivider);
+    return 0;
+}
+
+static int32_t CmdTrigger(uint32_t argc, char *argv[])
+{
+    uint32_t periodUs = PIT_PERIOD_US;
+
+    if (argc < 2)
+    {
+        return -1;
+    }
+    if (strcmp(argv[1], "gpio") == 0)
+    {
+        periodUs = 0;
+    }
+    else if ((strcmp(argv[1], "pit") != 0) || ((argc > 2) && (CmdShellParseUint(argv[2], &periodUs) || (periodUs == 0))))
+    {
+        return -1;
+    }
+
+    pitPeriodUs = periodUs;
+    if (captureArmed)
+    {
+        // a running capture switches over at once, otherwise start picks it up
+        StopPITTrigger(spi3);
+        if (pitPeriodUs)
+        {
+            StopGPIOTrigger(spi3);
+            if (InitPITTrigger(spi3, pitPeriodUs))
+            {
+                PRINTF("PIT period %u us not possible\r\n", pitPeriodUs);
+                return 0;
+            }
+        }
+        else
+        {
+            InitGPIOTrigger(spi3, TRIGGER_XBAR_INPUT);
+        }
+    }
+    if (pitPeriodUs)
+    {
+        PRINTF("trigger PIT channel 2 every %u us\r\n", pitPeriodUs);
+    }
+    else
+    {
+        PRINTF("trigger GPIO_AD_B0_15 falling edge\r\n");
+    }
+    return 0;
+}
+
+static int32_t CmdStart(uint32_t argc, char *argv[])
+{
+    spi3_frame_t frame;
+
+    if (!PeripheralReady())
+    {
+        return 0;
+    }
+    // arm the GPIO_AD_B0_15 falling edge -> XBAR1 -> eDMA -> LPSPI3 frame chain
+    FillTxBuffer();
+    frame.length = frameLength;
+    frame.txBuffer = txBuffer;
+    frame.rxBuffer = rxBuffer;
+    SetSPI3Frame(spi3, &frame);
+    if (!streamMode)
+    {
+        SetSPI3RxRing(spi3, rxRing, RX_SLOTS);
+    }
+    InitDMAandEDMA(spi3);
+    EnableIRQ(DMA0_DMA16_IRQn);
+    InitGPIOTrigger(spi3, TRIGGER_XBAR_INPUT);
+    EnableSPI3FrameTimestamp(spi3);
+    RestSPI3Peripheral(spi3, frame.txBuffer, frame.rxBuffer);
+    if (pitPeriodUs)
+    {
+        // fixed rate frames from PIT channel 2 through the DMAMUX periodic trigger instead
+        StopGPIOTrigger(spi3);
+        if (InitPITTrigger(spi3, pitPeriodUs))
+        {
+            PRINTF("PIT period %u us not possible\r\n", pitPeriodUs);
+            return 0;
+        }
+    }
+    captureArmed = 1;
+    PRINTF("capture armed, %u byte frames\r\n", frameLength);
+    return 0;
+}
+
+static int32_t CmdStop(uint32_t argc, char *argv[])
+{
+    // stop reacting on the GPIO trigger or the PIT
+    StopGPIOTrigger(spi3);
+    StopPITTrigger(spi3);
+    captureArmed = 0;
+    return 0;
+}
+
+static int32_t CmdShow(uint32_t argc, char *argv[])
+{
+    uint32_t producer;
+
+    // show the newest captured frame, a partial IRQ batch is flushed first
+    if (streamMode)
+    {
+        // the frame right behind the stream write pointer
+        PrintStreamFrame(streamBuffer[streamMode], 1U << streamLog2[streamMode], GetSPI3RxStreamWriteIndex(spi3));
+        return 0;
+    }
+    producer = FlushSPI3RxBatch(spi3);
+    PRINTF("frames %d\r\n", producer);
+    if (producer)
+    {
+        uint8_t *slot = GetSPI3RxSlot(spi3, producer - 1);
+        for (uint32_t idx = 0; idx < frameLength; idx++)
+        {
+            PRINTF("%02x ", slot[idx]);
+        }
+        PRINTF("\r\n");
+    }
+    return 0;
+}
+
+static int32_t CmdDrain(uint32_t argc, char *argv[])
+{
+    spi3_rx_frame_t rxFrame;
+
+    // drain the Rx frame queue, frames are read in place and given back to the ring
+    FlushSPI3RxBatch(spi3);
+    while (GetSPI3RxFrame(spi3, &rxFrame) == 0)
+    {
+        DBG_LOG("frame %d @%u: %02x .. %02x\r\n", rxFrame.sequence, rxFrame.timestamp, rxFrame.data[0], rxFrame.data[rxFrame.length - 1]);
+        ReleaseSPI3RxFrame(spi3, &rxFrame);
+    }
+    PRINTF("trigger paused %d times\r\n", GetSPI3RxPauseCount(spi3));
+    return 0;
+}
+
+static int32_t CmdBatch(uint32_t argc, char *argv[])
+{
+    uint32_t frames;
+    uint32_t divider;
+
+    if ((argc < 2) || CmdShellParseUint(argv[1], &frames))
+    {
+        return -1;
+    }
+    // one Rx interrupt every n frames
+    if (SetSPI3RxBatch(spi3, frames))
+    {
+        PRINTF("batch takes");
+        for (divider = 1; divider <= (RX_SLOTS / 2); divider++)
+        {
+            if ((RX_SLOTS % divider) == 0)
+            {
+                PRINTF(" %u", divider);
+            }
+        }
+        PRINTF(": it divides the %d ring slots, at most %d, above 1 only with the Rx ring set up by start\r\n",
+               RX_SLOTS, RX_SLOTS / 2);
+    }
+    else
+    {
+        irqBatch = frames;
+    }
+    PRINTF("Rx IRQ every %d frames\r\n", irqBatch);
+    return 0;
+}
+
+static int32_t CmdStream(uint32_t argc, char *argv[])
+{
+    static const char * const streamArg[STREAM_MODES] = { "off", "ocram", "dtcm", "sdram" };
+    uint32_t mode = STREAM_MODES;
+
+    for (uint32_t idx = 0; (argc > 1) && (idx < STREAM_MODES); idx++)
+    {
+        if (strcmp(argv[1], streamArg[idx]) == 0)
+        {
+            mode = idx;
+        }
+    }
+    if (mode == STREAM_MODES)
+    {
+        return -1;
+    }
+
+    // the Rx ring or a DMOD stream in OCRAM, DTCM or SDRAM
+    streamMode = mode;
+    if (streamMode)
+    {
+        irqBatch = 1;
+        SetSPI3RxBatch(spi3, irqBatch);
+        SetSPI3RxRing(spi3, 0, 0);
+        if (SetSPI3RxStream(spi3, streamBuffer[streamMode], streamLog2[streamMode]))
+        {
+            streamMode = 0;
+            PRINTF("stream not possible with this frame setup\r\n");
+        }
+    }
+    if (!streamMode)
+    {
+        SetSPI3RxStream(spi3, 0, 0);
+        SetSPI3RxRing(spi3, rxRing, RX_SLOTS);
+    }
+    PRINTF("Rx stream %s\r\n", streamName[streamMode]);
+    return 0;
+}
+
+static int32_t CmdWord(uint32_t argc, char *argv[])
+{
+    uint8_t enable;
+
+    if ((argc < 2) || ((strcmp(argv[1], "on") != 0) && (strcmp(argv[1], "off") != 0)))
+    {
+        return -1;
+    }
+    // 32 bit DMA beats / LPSPI3 words
+    enable = (strcmp(argv[1], "on") == 0);
+    if (SetSPI3WordMode(spi3, enable))
+    {
+        PRINTF("word mode needs a multiple of 4 byte frames with the Rx ring\r\n");
+    }
+    else
+    {
+        wordMode = enable;
+    }
+    PRINTF("word mode %s\r\n", wordMode ? "on" : "off");
+    return 0;
+}
+
+static void PrintStatus(void)
+{
+    PRINTF("frames %u, paused %u, Rx IRQ every %u frames, word mode %u\r\n",
+            GetSPI3RxProducerIndex(spi3), GetSPI3RxPauseCount(spi3), irqBatch, wordMode);
+}
+
+static int32_t CmdStats(uint32_t argc, char *argv[])
+{
+    PrintStatus();
+    PRINTF("frame %u bytes, SCK %u kHz, ", frameLength, SPI3_LPSPI_CLK_HZ / 1000U / (sckDivider + 2));
+    if (pitPeriodUs)
+    {
+        PRINTF("PIT trigger every %u us\r\n", pitPeriodUs);
+    }
+    else
+    {
+        PRINTF("GPIO trigger\r\n");
+    }
+    if (streamMode)
+    {
+        PRINTF("Rx %s, ", streamName[streamMode]);
+    }
+    else
+    {
+        PRINTF("Rx %d slot ring, ", RX_SLOTS);
+    }
+    PRINTF("DMA ISR last %u max %u cycles, %u console characters dropped\r\n", GetSPI3IsrCycles(spi3),
+           GetSPI3IsrMaxCycles(spi3), DbgConsole_GetDropCount());
+    return 0;
+}
+
+static int32_t CmdBench(uint32_t argc, char *argv[])
+{
+    uint32_t fieldCycles;
+    uint32_t imageCycles;
+    uint32_t printCycles;
+    uint32_t periodUs = PIT_PERIOD_US;
+
+    if (argc < 2)
+    {
+        return -1;
+    }
+    if (strcmp(argv[1], "latency") == 0)
+    {
+        // edge to frame end latency, GPIO_AD_B1_11 looped back to GPIO_AD_B0_15
+        InitBenchLoopback();
+        BenchTriggerLatency(BENCH_MAX_SAMPLES, 100);
+    }
+    else if (strcmp(argv[1], "rate") == 0)
+    {
+        // highest lossless trigger rate per SCK setting, same loopback
+        InitBenchLoopback();
+        BenchTriggerRate();
+    }
+    else if (strcmp(argv[1], "priority") == 0)
+    {
+        // trigger latency under a bulk memory copy, reset arbitration vs priority profile
+        InitBenchLoopback();
+        BenchDmaPriority();
+    }
+    else if (strcmp(argv[1], "period") == 0)
+    {
+        // fixed rate frames from PIT channel 2 instead of the GPIO edge, prints the period jitter
+        if ((argc > 2) && (CmdShellParseUint(argv[2], &periodUs) || (periodUs == 0)))
+        {
+            return -1;
+        }
+        BenchTriggerPeriod(BENCH_MAX_SAMPLES, periodUs);
+        pitPeriodUs = periodUs; // the chain stays in PIT mode until stop
+    }
+    else if (strcmp(argv[1], "memory") == 0)
+    {
+        // eDMA capture write rate into DTCM, OCRAM and SDRAM
+        BenchCaptureMemory();
+    }
+    else if (strcmp(argv[1], "buffers") == 0)
+    {
+        // consumer read rate of DMA filled buffers per spi3Buffer pool
+        BenchBufferPlacement();
+    }
+    else if (strcmp(argv[1], "isr") == 0)
+    {
+        // DMA ISR entry to exit time with warm and cold caches, same loopback as latency
+        InitBenchLoopback();
+        BenchIsrTime(BENCH_MAX_SAMPLES);
+    }
+    else if (strcmp(argv[1], "tcd") == 0)
+    {
+        // cycles to re-arm the Rx channel, old field by field path vs prebuilt TCD image
+        BenchmarkTcdRearm(spi3, &fieldCycles, &imageCycles);
+        PRINTF("TCD re-arm field by field %d cycles, image %d cycles\r\n", fieldCycles, imageCycles);
+    }
+    else if (strcmp(argv[1], "print") == 0)
+    {
+        // cost of one status line to the caller, queued with DEBUG_CONSOLE_TX_ASYNC, blocking without
+        printCycles = DWT->CYCCNT;
+        PrintStatus();
+        printCycles = DWT->CYCCNT - printCycles;
+        DbgConsole_Flush();
+        PRINTF("status line took %u cycles, %u characters dropped so far\r\n", printCycles, DbgConsole_GetDropCount());
+        // the same line as a tokenized record
+        printCycles = DWT->CYCCNT;
+        DBG_LOG("frames %u, paused %u, Rx IRQ every %u frames, word mode %u\r\n",
+                GetSPI3RxProducerIndex(spi3), GetSPI3RxPauseCount(spi3), irqBatch, wordMode);
+        printCycles = DWT->CYCCNT - printCycles;
+        DbgConsole_Flush();
+        PRINTF("DBG_LOG took %u cycles\r\n", printCycles);
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+static const cmd_shell_command_t shellCommands[] = {
+    { "init",    "",                   "initialize clocks and LPSPI3", CmdInit },
+    { "txtest",  "",                   "transmit ascii '0' to '9' on LPSPI3", CmdTxTest },
+    { "length",  "[bytes]",            "frame length, 1 to 512", CmdLength },
+    { "sck",     "[kHz]",              "LPSPI3 SCK, the closest rate not above", CmdSck },
+    { "trigger", "gpio | pit [us]",    "frame trigger for start, GPIO_AD_B0_15 edge or PIT period", CmdTrigger },
+    { "start",   "",                   "arm the capture with the trigger", CmdStart },
+    { "stop",    "",                   "disarm the GPIO trigger and the PIT", CmdStop },
+    { "show",    "",                   "number of frames and the newest one", CmdShow },
+    { "drain",   "",                   "read and release every queued frame (DBG_LOG)", CmdDrain },
+    { "batch",   "<frames>",           "Rx interrupt every 1, 2 or 4 frames", CmdBatch },
+    { "stream",  "off | ocram | dtcm | sdram", "capture into the Rx ring or a DMOD stream", CmdStream },
+    { "word",    "on | off",           "32 bit DMA beats and LPSPI3 words", CmdWord },
+    { "stats",   "",                   "capture counters and settings", CmdStats },
+    { "bench",   "latency | rate | priority | period [us] | memory | buffers | isr | tcd | print",
+                                       "run a measurement, see doc/readme.txt", CmdBench },
+};
+
 /*!
  * @brief Main function
  */
 int main(void)
 {
-    char ch;
-
     /* Init board hardware. */
     BOARD_ConfigMPU();
     BOARD_InitBootPins();
     BOARD_InitBootClocks();
     BOARD_InitDebugConsole();
 
+    DbgLogInit();
     PRINTF("SPI3 DMA from GPIO test\r\n");
+    PrintFlexRAMLayout();
+
+    spi3 = GetSPI3Handle(SPI_INSTANCE);
+    txBuffer = AllocSPI3Buffer(DMA_POOL, FRAME_MAX_SIZE);
+    rxBuffer = AllocSPI3Buffer(DMA_POOL, FRAME_MAX_SIZE);
+    rxRing = AllocSPI3Buffer(DMA_POOL, RX_SLOTS * FRAME_MAX_SIZE);
+    SetSPI3RxCacheMaintenance(spi3, IsSPI3BufferCacheable(DMA_POOL));
 
+    CmdShellInit(shellCommands, sizeof(shellCommands) / sizeof(shellCommands[0]));
 
     while (1)
     {
-        ch = GETCHAR();
-        PUTCHAR(ch);
-
-        switch(ch)
-        {
-        case '1':
-        	// initialize all clocks needed in this project
-        	InitClocks();
-        	InitSPI3Peripheral();
-        	break;
-        case '2':
-        	// simple test to transmit ascii '0' to '9' out SPI3 port
-        	TxTest();
-        	break;
-
-        }
+        // idle loop, frames move by eDMA and its interrupt, input by the LPUART interrupt
+        CmdShellPoll();
     }
 }
@@ -0,0 +1,178 @@
+/*
+ * cmdShell.c
+ *
+ *  Created on: Mar 20, 2023
+ *      Author: TBiberdorf
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fsl_debug_console.h"
+#include "cmdShell.h"
+
+static const cmd_shell_command_t *shellCommands;
+static uint32_t shellCommandCount;
+static char shellLine[CMD_SHELL_LINE_SIZE];
+static uint32_t shellLength;
+static uint32_t shellOverflow; // the line ran past CMD_SHELL_LINE_SIZE - 1 characters
+static int shellLast;
+
+static void ShellHelp(void)
+{
+	PRINTF("help\r\n      this list\r\n");
+	for(uint32_t idx = 0; idx < shellCommandCount; idx++)
+	{
+		PRINTF("%s %s\r\n      %s\r\n", shellCommands[idx].name, shellCommands[idx].usage, shellCommands[idx].help);
+	}
+}
+
+/*
+ * Split the line in place at blanks and run the command its first word names.
+ */
+static void ShellExecute(char *line)
+{
+	char *argv[CMD_SHELL_MAX_ARGS];
+	uint32_t argc = 0;
+	char *pos = line;
+
+	while(*pos)
+	{
+		if((*pos == ' ') || (*pos == '\t'))
+		{
+			*pos++ = '\0';
+			continue;
+		}
+		if(argc == CMD_SHELL_MAX_ARGS)
+		{
+			PRINTF("more than %d words\r\n", CMD_SHELL_MAX_ARGS);
+			return;
+		}
+		argv[argc++] = pos;
+		while(*pos && (*pos != ' ') && (*pos != '\t'))
+		{
+			pos++;
+		}
+	}
+	if(!argc)
+		return;
+
+	if(strcmp(argv[0], "help") == 0)
+	{
+		ShellHelp();
+		return;
+	}
+	for(uint32_t idx = 0; idx < shellCommandCount; idx++)
+	{
+		if(strcmp(argv[0], shellCommands[idx].name) == 0)
+		{
+			if(shellCommands[idx].handler(argc, argv))
+			{
+				PRINTF("usage: %s %s\r\n", shellCommands[idx].name, shellCommands[idx].usage);
+			}
+			return;
+		}
+	}
+	PRINTF("unknown command %s, try help\r\n", argv[0]);
+}
+
+/*
+ * Commands are looked up in the table in order, it is used in place and has to stay.
+ */
+void CmdShellInit(const cmd_shell_command_t *commands, uint32_t count)
+{
+	shellCommands = commands;
+	shellCommandCount = count;
+	shellLength = 0;
+	shellOverflow = 0;
+	shellLast = 0;
+	PRINTF("\r\ntype help for the commands\r\n> ");
+}
+
+/*
+ * Never waits for input: returns when the receive side is empty or after one
+ * command ran, so the idle loop gets a turn between commands.
+ */
+void CmdShellPoll(void)
+{
+	int ch;
+
+	while((ch = DbgConsole_TryGetchar()) >= 0)
+	{
+		if((ch == '\n') && (shellLast == '\r'))
+		{
+			// CR LF from the terminal, the CR ended the line already
+			shellLast = ch;
+			continue;
+		}
+		shellLast = ch;
+
+		if((ch == '\r') || (ch == '\n'))
+		{
+			PRINTF("\r\n");
+			shellLine[shellLength] = '\0';
+			shellLength = 0;
+			if(shellOverflow)
+			{
+				// a truncated line could run a different command, drop all of it
+				shellOverflow = 0;
+				PRINTF("line longer than %d characters, discarded\r\n", CMD_SHELL_LINE_SIZE - 1);
+			}
+			else
+			{
+				ShellExecute(shellLine);
+			}
+			PRINTF("> ");
+			return;
+		}
+		if((ch == '\b') || (ch == 0x7F))
+		{
+			if(shellLength)
+			{
+				shellLength--;
+				PRINTF("\b \b");
+			}
+		}
+		else if((ch >= ' ') && (ch < 0x7F))
+		{
+			if(shellLength < (CMD_SHELL_LINE_SIZE - 1))
+			{
+				shellLine[shellLength++] = (char)ch;
+				PUTCHAR(ch);
+			}
+			else
+			{
+				shellOverflow = 1;
+			}
+		}
+	}
+}
+
+/*
+ * Decimal or 0x hex, the whole word has to be a number that fits 32 bits.  A
+ * leading 0 is still decimal, strtoul() base 0 would take it as octal.
+ */
+int32_t CmdShellParseUint(const char *text, uint32_t *value)
+{
+	char *end;
+	unsigned long parsed;
+	int base = 10;
+
+	if(text == 0)
+		return -1;
+	if((text[0] == '0') && ((text[1] == 'x') || (text[1] == 'X')))
+	{
+		text += 2;
+		base = 16;
+	}
+	// strtoul() would skip blanks and take a sign
+	if(!isdigit((unsigned char)*text) && ((base == 10) || !isxdigit((unsigned char)*text)))
+		return -1;
+	errno = 0;
+	parsed = strtoul(text, &end, base);
+	if((*end != '\0') || (errno == ERANGE) || (parsed > UINT32_MAX))
+		return -1;
+	*value = (uint32_t)parsed;
+	return 0;
+}
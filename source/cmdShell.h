@@ -0,0 +1,37 @@
+/*
+ * cmdShell.h
+ *
+ *  Created on: Mar 20, 2023
+ *      Author: TBiberdorf
+ *
+ *  Line oriented command shell on the debug console.  CmdShellPoll() takes the
+ *  characters DbgConsole_TryGetchar() has without waiting, echoes them and runs
+ *  the line once return is pressed: the first word picks the command from the
+ *  table given to CmdShellInit(), the rest is split into arguments at blanks.
+ *  Call it from the idle loop, a command runs at thread level.
+ */
+
+#ifndef APPLICATIONS_NGRMSENSORSOURCE_SOURCE_CMDSHELL_H_
+#define APPLICATIONS_NGRMSENSORSOURCE_SOURCE_CMDSHELL_H_
+
+#include <stdint.h>
+
+#define CMD_SHELL_LINE_SIZE (80) // with the NUL, a longer line is discarded with an error
+#define CMD_SHELL_MAX_ARGS  (8)  // including the command name
+
+/* argv[0] is the command name, returning -1 prints the usage line */
+typedef int32_t (*cmd_shell_handler_t)(uint32_t argc, char *argv[]);
+
+typedef struct _cmd_shell_command
+{
+	const char *name;
+	const char *usage; // arguments, for help and after a -1 return
+	const char *help;  // one line description
+	cmd_shell_handler_t handler;
+} cmd_shell_command_t;
+
+void CmdShellInit(const cmd_shell_command_t *commands, uint32_t count);
+void CmdShellPoll(void);
+int32_t CmdShellParseUint(const char *text, uint32_t *value);
+
+#endif /* APPLICATIONS_NGRMSENSORSOURCE_SOURCE_CMDSHELL_H_ */
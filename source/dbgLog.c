@@ -0,0 +1,40 @@
+/*
+ * dbgLog.c
+ *
+ *  Created on: Mar 14, 2023
+ *      Author: TBiberdorf
+ */
+
+#include <string.h>
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "dbgLog.h"
+
+/*
+ * Records are timestamped with the DWT cycle counter, start it.
+ */
+void DbgLogInit(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*
+ * Build one record and hand it to the console as a single block, with
+ * DEBUG_CONSOLE_TX_ASYNC a full ring drops the whole record, never part of it.
+ * On SWO it goes out on DBG_LOG_PORT, on the UART mixed with the text.
+ * Called through DBG_LOG(), thread level only like PRINTF.
+ */
+void DbgLogRecord(const char *format, uint32_t argCount, const uint32_t *args)
+{
+	uint8_t record[DBG_LOG_HEADER + (DBG_LOG_MAX_ARGS * 4)];
+	uint32_t token = (uint32_t)format;
+	uint32_t timestamp = DWT->CYCCNT;
+
+	record[0] = (uint8_t)(DBG_LOG_MARKER | argCount);
+	memcpy(&record[1], &token, 4);
+	memcpy(&record[5], &timestamp, 4);
+	memcpy(&record[DBG_LOG_HEADER], args, argCount * 4);
+
+	(void)DbgConsole_WritePort(DBG_LOG_PORT, record, DBG_LOG_HEADER + (argCount * 4));
+}
@@ -0,0 +1,60 @@
+/*
+ * dbgLog.h
+ *
+ *  Created on: Mar 14, 2023
+ *      Author: TBiberdorf
+ *
+ *  Tokenized logging on the debug console.  DBG_LOG() keeps its format string in
+ *  the .dbglog section of the ELF and sends a binary record instead of text:
+ *
+ *    byte 0      DBG_LOG_MARKER | argument count (0..DBG_LOG_MAX_ARGS)
+ *    bytes 1..4  format string address, the token
+ *    bytes 5..8  DWT cycle count when the record was written
+ *    then        the arguments as raw 32 bit words
+ *
+ *  all little endian.  The marker never shows up in ASCII, so records and plain
+ *  PRINTF text share the link and tools/dbglog_decode.py turns both back into text
+ *  with the ELF.  Arguments are 32 bit integers only (%d %u %x %c, pointers cast to
+ *  uint32_t), %s would print the string address.  linkscripts/user.ldt links
+ *  .dbglog as a not loaded INFO section, the strings never reach the flash.
+ *
+ *  With the console on SWO (kSerialPort_Swo) the records go to their own ITM
+ *  stimulus port, DBG_LOG_PORT, and tools/swo_decode.py separates the two.
+ */
+
+#ifndef APPLICATIONS_NGRMSENSORSOURCE_SOURCE_DBGLOG_H_
+#define APPLICATIONS_NGRMSENSORSOURCE_SOURCE_DBGLOG_H_
+
+#include <stdint.h>
+
+/* 1 sends binary records, 0 makes DBG_LOG() a plain PRINTF */
+#ifndef DBG_LOG_BINARY
+#define DBG_LOG_BINARY   (1)
+#endif
+
+#define DBG_LOG_MARKER   (0xF0U) // record start, low nibble is the argument count
+#define DBG_LOG_MAX_ARGS (4)
+#define DBG_LOG_HEADER   (9)     // marker, token, timestamp
+#define DBG_LOG_PORT     (1)     // ITM stimulus port of the records with the console on SWO
+
+/* number of arguments after the format, counts up to 8 so too many can be refused */
+#define DBG_LOG_NARGS(...) DBG_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DBG_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, count, ...) count
+
+#if DBG_LOG_BINARY
+#define DBG_LOG(format, ...) \
+	do { \
+		_Static_assert(DBG_LOG_NARGS(__VA_ARGS__) <= DBG_LOG_MAX_ARGS, "DBG_LOG() takes 4 arguments at most"); \
+		static const char dbgLogFormat[] __attribute__((section(".dbglog"), aligned(4))) = format; \
+		const uint32_t dbgLogArgs[DBG_LOG_NARGS(__VA_ARGS__) + 1] = { __VA_ARGS__ }; \
+		DbgLogRecord(dbgLogFormat, DBG_LOG_NARGS(__VA_ARGS__), dbgLogArgs); \
+	} while(0)
+#else
+#include "fsl_debug_console.h"
+#define DBG_LOG(format, ...) PRINTF(format, ##__VA_ARGS__)
+#endif
+
+void DbgLogInit(void);
+void DbgLogRecord(const char *format, uint32_t argCount, const uint32_t *args);
+
+#endif /* APPLICATIONS_NGRMSENSORSOURCE_SOURCE_DBGLOG_H_ */
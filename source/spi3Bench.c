@@ -0,0 +1,599 @@
+/*
+ * spi3Bench.c
+ *
+ *  Created on: Feb 20, 2023
+ *      Author: TBiberdorf
+ */
+
+#include "fsl_device_registers.h"
+#include "fsl_debug_console.h"
+#include "fsl_gpio.h"
+#include "fsl_iomuxc.h"
+#include "spi3DMAApi.h"
+#include "spi3Bench.h"
+#include "spi3Buffer.h"
+
+/*
+ * Loopback output, wire GPIO_AD_B1_11 (GPIO1_IO27) to the trigger input GPIO_AD_B0_15.
+ * A falling edge on it starts one frame.
+ */
+#define LOOPBACK_GPIO     GPIO1
+#define LOOPBACK_PIN      (27U)
+#define LOOPBACK_TIMEOUT  (1000000U) // DWT cycles to wait for a frame, ~1.7ms at 600MHz
+#define RATE_BURST        (64U)       // edges per trigger rate step
+#define RATE_START_US     (200U)      // slowest trigger period of the sweep
+#define PULSE_CYCLES      (100U)      // loopback low time, well above the XBAR input sync
+#define BENCH_SPI_INSTANCE (3U)       // LPSPI3, the stream the start command arms
+#define BULK_DMA_CHANNEL  (15U)       // free channel in the LPSPI3 group, above it at reset
+#define BULK_BYTES        (4096U)     // buffer copied back and forth by the bulk channel
+#define BULK_MINOR_BYTES  (1024U)     // bytes per bulk request, what a frame waits for without preemption
+#define PRIORITY_SAMPLES  (128U)
+#define MEM_BENCH_BYTES   (16384U)    // per capture copy, byte beats have to fit one 15 bit CITER
+#define POOL_BENCH_BYTES  (8192U)     // buffer taken from each spi3Buffer pool
+#define POOL_BENCH_PASSES (16U)
+
+static uint32_t latencySample[BENCH_MAX_SAMPLES]; // edge to last Rx byte, GPT1 ticks
+static uint32_t frameSample[BENCH_MAX_SAMPLES];   // edge to DMA_irq(), DWT cycles
+
+static uint64_t bulkSource[BULK_BYTES / 8];
+static uint64_t bulkDest[BULK_BYTES / 8];
+
+/* capture targets of BenchCaptureMemory(), the SDRAM one is left out of the startup zeroing */
+static uint32_t memBenchDtcm[MEM_BENCH_BYTES / 4] __attribute__((section(".bss.$SRAM_DTC"), aligned(32)));
+static uint32_t memBenchOcram[MEM_BENCH_BYTES / 4] __attribute__((section(".bss.$SRAM_OC"), aligned(32)));
+static uint32_t memBenchSdram[MEM_BENCH_BYTES / 4] __attribute__((section(".noinit.$BOARD_SDRAM"), aligned(32)));
+static volatile uint32_t memBenchWord = 0x5AA5C33CU; // fixed source standing in for LPSPI RDR
+
+static const uint8_t sweepSckDivider[] = { 50, 22, 10, 4 }; // 2.0, 4.4, 8.8, 17.6 MHz SCK
+
+static void EnableCycleCounter(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static void SortSamples(uint32_t *sample, uint32_t count)
+{
+	uint32_t idx;
+	uint32_t pos;
+	uint32_t value;
+
+	// insertion sort, at most BENCH_MAX_SAMPLES entries
+	for(idx = 1; idx < count; idx++)
+	{
+		value = sample[idx];
+		for(pos = idx; (pos > 0) && (sample[pos - 1] > value); pos--)
+		{
+			sample[pos] = sample[pos - 1];
+		}
+		sample[pos] = value;
+	}
+}
+
+/*
+ * Print min/mean/p99/max of sorted samples converted to ns, plus an 8 bin histogram.
+ */
+static void PrintSamples(const char *name, uint32_t *sample, uint32_t count, uint32_t clockHz)
+{
+	uint64_t sum = 0;
+	uint32_t bin[8] = {0};
+	uint32_t span;
+	uint32_t idx;
+
+	SortSamples(sample, count);
+	for(idx = 0; idx < count; idx++)
+	{
+		sum += sample[idx];
+	}
+	span = sample[count - 1] - sample[0] + 1;
+	for(idx = 0; idx < count; idx++)
+	{
+		bin[((uint64_t)(sample[idx] - sample[0]) * 8) / span]++;
+	}
+
+	PRINTF("%s ns: min %u mean %u p99 %u max %u\r\n", name,
+			(uint32_t)(((uint64_t)sample[0] * 1000000000U) / clockHz),
+			(uint32_t)(((sum / count) * 1000000000U) / clockHz),
+			(uint32_t)(((uint64_t)sample[(count * 99) / 100] * 1000000000U) / clockHz),
+			(uint32_t)(((uint64_t)sample[count - 1] * 1000000000U) / clockHz));
+	for(idx = 0; idx < 8; idx++)
+	{
+		PRINTF("  %u.. : %u\r\n",
+				(uint32_t)(((uint64_t)(sample[0] + ((span * idx) / 8)) * 1000000000U) / clockHz), bin[idx]);
+	}
+}
+
+/*
+ * Pad mux and direction of the loopback output, idles high.
+ */
+void InitBenchLoopback(void)
+{
+	gpio_pin_config_t outConfig = { kGPIO_DigitalOutput, 1, kGPIO_NoIntmode };
+
+	IOMUXC_SetPinMux(IOMUXC_GPIO_AD_B1_11_GPIO1_IO27, 0U);
+	IOMUXC_SetPinConfig(IOMUXC_GPIO_AD_B1_11_GPIO1_IO27, 0x10B0U);
+	GPIO_PinInit(LOOPBACK_GPIO, LOOPBACK_PIN, &outConfig);
+}
+
+/*
+ * Edge to frame end latency of the trigger chain.  The chain has to be armed (start
+ * command) with frame timestamps, one interrupt per frame and the loopback wired.
+ * Every sample drives a falling edge and compares
+ *  - GPT1 read just before the edge with the GPT1 count the timestamp channel
+ *    latched after the last Rx byte, the frame time on the wire is constant
+ *  - DWT cycles at the edge with the DWT cycles DMA_irq() saw at frame completion
+ * tools/spi3dma_sim runs the same loop on simulated timing, with edge to SCK.
+ * Returns -1 when a frame does not come in.
+ */
+int32_t BenchTriggerLatency(uint32_t samples, uint32_t periodUs)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+	spi3_rx_frame_t frame;
+	uint32_t producer;
+	uint32_t edgeTicks;
+	uint32_t edgeCycles;
+	uint32_t idx;
+
+	if((samples == 0) || (samples > BENCH_MAX_SAMPLES))
+		return -1;
+
+	EnableCycleCounter();
+	SetSPI3RxBatch(spi3, 1);
+
+	for(idx = 0; idx < samples; idx++)
+	{
+		GPIO_PinWrite(LOOPBACK_GPIO, LOOPBACK_PIN, 1U);
+		SDK_DelayAtLeastUs(periodUs, SystemCoreClock);
+
+		producer = FlushSPI3RxBatch(spi3);
+		edgeTicks = GPT1->CNT;
+		edgeCycles = DWT->CYCCNT;
+		LOOPBACK_GPIO->DR_CLEAR = (1U << LOOPBACK_PIN);
+
+		while(GetSPI3RxProducerIndex(spi3) == producer)
+		{
+			if((DWT->CYCCNT - edgeCycles) > LOOPBACK_TIMEOUT)
+			{
+				PRINTF("\r\nno frame for sample %u, loopback wired and start run?\r\n", idx);
+				return -1;
+			}
+		}
+
+		latencySample[idx] = GetSPI3RxTimestamp(spi3, producer) - edgeTicks;
+		frameSample[idx] = GetSPI3RxIrqCycles(spi3) - edgeCycles;
+
+		// hand the slots back so the queue never holds the trigger off
+		while(GetSPI3RxFrame(spi3, &frame) == 0)
+		{
+			ReleaseSPI3RxFrame(spi3, &frame);
+		}
+	}
+	GPIO_PinWrite(LOOPBACK_GPIO, LOOPBACK_PIN, 1U);
+
+	PRINTF("\r\n%u samples, %u us apart\r\n", samples, periodUs);
+	PrintSamples("edge to Rx done", latencySample, samples, SPI3_TIMESTAMP_HZ);
+	PrintSamples("edge to frame done", frameSample, samples, SystemCoreClock);
+	return 0;
+}
+
+static void DrainRxFrames(void)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+	spi3_rx_frame_t frame;
+
+	while(GetSPI3RxFrame(spi3, &frame) == 0)
+	{
+		ReleaseSPI3RxFrame(spi3, &frame);
+	}
+}
+
+/*
+ * Entry to exit time of the DMA vector of LPSPI3 per frame, same setup as
+ * BenchTriggerLatency().  Run warm, and cold with both caches emptied before every
+ * edge: from XIP flash the cold run pays the FlexSPI refills of the vector, the ISR
+ * code and its literals, with SPI3_HOT_PATH_ITCM only the data misses remain.
+ */
+int32_t BenchIsrTime(uint32_t samples)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+	uint32_t producer;
+	uint32_t edgeCycles;
+	uint32_t isrCode = (uint32_t)&DMA_irq;
+	uint32_t pass;
+	uint32_t idx;
+
+	if((samples == 0) || (samples > BENCH_MAX_SAMPLES))
+		return -1;
+
+	EnableCycleCounter();
+	SetSPI3RxBatch(spi3, 1);
+
+	PRINTF("\r\nDMA_irq at 0x%08x (%s), vector table at 0x%08x\r\n", isrCode,
+			(isrCode < 0x00080000U) ? "ITCM" : "flash", SCB->VTOR);
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(idx = 0; idx < samples; idx++)
+		{
+			GPIO_PinWrite(LOOPBACK_GPIO, LOOPBACK_PIN, 1U);
+			SDK_DelayAtLeastUs(100, SystemCoreClock);
+
+			if(pass)
+			{
+				SCB_CleanInvalidateDCache();
+				SCB_InvalidateICache();
+			}
+			producer = FlushSPI3RxBatch(spi3);
+			edgeCycles = DWT->CYCCNT;
+			LOOPBACK_GPIO->DR_CLEAR = (1U << LOOPBACK_PIN);
+
+			// the ISR preempts this loop, it has returned once the producer index moved
+			while(GetSPI3RxProducerIndex(spi3) == producer)
+			{
+				if((DWT->CYCCNT - edgeCycles) > LOOPBACK_TIMEOUT)
+				{
+					PRINTF("\r\nno frame for sample %u, loopback wired and start run?\r\n", idx);
+					return -1;
+				}
+			}
+			frameSample[idx] = GetSPI3IsrCycles(spi3);
+			DrainRxFrames();
+		}
+		GPIO_PinWrite(LOOPBACK_GPIO, LOOPBACK_PIN, 1U);
+		PrintSamples(pass ? "ISR cold caches" : "ISR warm", frameSample, samples, SystemCoreClock);
+	}
+	PRINTF("ISR worst case since boot %u cycles\r\n", GetSPI3IsrMaxCycles(spi3));
+	return 0;
+}
+
+/*
+ * One burst of RATE_BURST edges periodCycles apart.  Returns 0 when every edge
+ * produced a complete frame, otherwise the number of dropped plus truncated frames.
+ */
+static uint32_t RunTriggerBurst(uint32_t periodCycles)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+	uint32_t producer;
+	uint32_t logFirst;
+	uint32_t logLast;
+	uint32_t frames;
+	uint32_t overruns;
+	uint32_t deadline;
+	uint32_t idx;
+
+	DrainRxFrames();
+	producer = FlushSPI3RxBatch(spi3);
+	logFirst = GetSPI3TriggerLogIndex(spi3);
+	deadline = DWT->CYCCNT + periodCycles;
+
+	for(idx = 0; idx < RATE_BURST; idx++)
+	{
+		while((int32_t)(DWT->CYCCNT - deadline) < 0)
+		{
+			DrainRxFrames(); // the queue must never hold the trigger off during the burst
+		}
+		deadline += periodCycles;
+		LOOPBACK_GPIO->DR_CLEAR = (1U << LOOPBACK_PIN);
+		while((DWT->CYCCNT - (deadline - periodCycles)) < PULSE_CYCLES)
+		{
+		}
+		LOOPBACK_GPIO->DR_SET = (1U << LOOPBACK_PIN);
+	}
+
+	// last frame out
+	deadline = DWT->CYCCNT;
+	while((DWT->CYCCNT - deadline) < LOOPBACK_TIMEOUT)
+	{
+		DrainRxFrames();
+	}
+
+	frames = FlushSPI3RxBatch(spi3) - producer;
+	logLast = GetSPI3TriggerLogIndex(spi3);
+	overruns = CountSPI3Overruns(spi3, logFirst, logLast);
+	if((frames == RATE_BURST) && (overruns == 0) && (((logLast - logFirst) % SPI3_TRIGGER_LOG_SIZE) == RATE_BURST))
+		return 0;
+	return (RATE_BURST - frames) + overruns;
+}
+
+/*
+ * Sweep the trigger rate up for a few SCK settings and report the highest rate
+ * that still delivered every frame complete.  Needs the chain armed (start command)
+ * and the loopback of BenchTriggerLatency().  Each step shortens the period by
+ * 1/16 until a burst loses or truncates a frame.
+ */
+void BenchTriggerRate(void)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+	uint32_t periodCycles;
+	uint32_t bestCycles;
+	uint32_t lost;
+	uint32_t idx;
+
+	EnableCycleCounter();
+	EnableSPI3OverrunLog(spi3);
+	SetSPI3RxBatch(spi3, 1);
+	GPIO_PinWrite(LOOPBACK_GPIO, LOOPBACK_PIN, 1U);
+
+	for(idx = 0; idx < sizeof(sweepSckDivider); idx++)
+	{
+		SetSPI3SckDivider(spi3, sweepSckDivider[idx]);
+		bestCycles = 0;
+		lost = 0;
+		for(periodCycles = RATE_START_US * cyclesPerUs; periodCycles > cyclesPerUs; periodCycles -= periodCycles / 16)
+		{
+			lost = RunTriggerBurst(periodCycles);
+			if(lost)
+				break;
+			bestCycles = periodCycles;
+		}
+
+		PRINTF("\r\nSCK %u kHz: ", (SPI3_LPSPI_CLK_HZ / (sweepSckDivider[idx] + 2)) / 1000);
+		if(bestCycles)
+			PRINTF("max lossless %u Hz, next step lost %u of %u frames", SystemCoreClock / bestCycles, lost, RATE_BURST);
+		else
+			PRINTF("frames lost at %u us already", RATE_START_US);
+	}
+	PRINTF("\r\n");
+
+	SetSPI3SckDivider(spi3, sweepSckDivider[0]); // back to the InitSPI3Peripheral() setting
+}
+
+/*
+ * Memory to memory copy on BULK_DMA_CHANNEL with the DMAMUX always on request, so
+ * the channel asks for the bus again as soon as a minor loop is done and keeps
+ * copying until StopBulkLoad().
+ */
+static void StartBulkLoad(void)
+{
+	DMA_Type *dmaBASE = DMA0;
+
+	dmaBASE->CERQ = DMA_CERQ_CERQ(BULK_DMA_CHANNEL);
+	dmaBASE->CDNE = DMA_CDNE_CDNE(BULK_DMA_CHANNEL);
+	dmaBASE->TCD[BULK_DMA_CHANNEL].SADDR = (uint32_t)bulkSource;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].SOFF = 8;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].ATTR = DMA_ATTR_SSIZE(3) | DMA_ATTR_DSIZE(3); // 64-bit
+	dmaBASE->TCD[BULK_DMA_CHANNEL].NBYTES_MLNO = BULK_MINOR_BYTES;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].SLAST = -(int32_t)BULK_BYTES;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].DADDR = (uint32_t)bulkDest;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].DOFF = 8;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].CITER_ELINKNO = BULK_BYTES / BULK_MINOR_BYTES;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].DLAST_SGA = -(int32_t)BULK_BYTES;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].CSR = 0; // no DREQ, starts over after every major loop
+	dmaBASE->TCD[BULK_DMA_CHANNEL].BITER_ELINKNO = BULK_BYTES / BULK_MINOR_BYTES;
+
+	DMAMUX->CHCFG[BULK_DMA_CHANNEL] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_A_ON_MASK;
+	dmaBASE->SERQ = DMA_SERQ_SERQ(BULK_DMA_CHANNEL);
+}
+
+static void StopBulkLoad(void)
+{
+	DMA0->CERQ = DMA_CERQ_CERQ(BULK_DMA_CHANNEL);
+	DMAMUX->CHCFG[BULK_DMA_CHANNEL] = 0;
+}
+
+/*
+ * Trigger latency of the chain without load, under a back to back
+ * memory copy on a channel that wins the reset arbitration, and under the same
+ * copy with the LPSPI3 priority profile and the copy marked bulk.  Needs the
+ * chain armed (start command) and the loopback of BenchTriggerLatency(), the
+ * arbitration is back at reset when done.
+ */
+void BenchDmaPriority(void)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+
+	SetSPI3PriorityProfile(spi3, 0);
+	SetSPI3BulkChannel(BULK_DMA_CHANNEL, 0);
+	PRINTF("\r\n-- no bulk load");
+	BenchTriggerLatency(PRIORITY_SAMPLES, 100);
+
+	StartBulkLoad();
+	PRINTF("\r\n-- bulk copy on channel %u, reset priorities", BULK_DMA_CHANNEL);
+	BenchTriggerLatency(PRIORITY_SAMPLES, 100);
+
+	SetSPI3BulkChannel(BULK_DMA_CHANNEL, 1);
+	SetSPI3PriorityProfile(spi3, 1);
+	PRINTF("\r\n-- bulk copy on channel %u, LPSPI3 profile with preemption", BULK_DMA_CHANNEL);
+	BenchTriggerLatency(PRIORITY_SAMPLES, 100);
+
+	StopBulkLoad();
+	SetSPI3PriorityProfile(spi3, 0);
+	SetSPI3BulkChannel(BULK_DMA_CHANNEL, 0);
+}
+
+/*
+ * Run the LPSPI3 stream from the PIT for samples frames and print the distribution
+ * of the spacing between consecutive frame timestamps, the spread is the jitter of
+ * the whole trigger chain.  Needs the chain armed (start command) with timestamps, no
+ * loopback, and stays in PIT mode afterwards.  Returns -1 when frames stop coming.
+ */
+int32_t BenchTriggerPeriod(uint32_t samples, uint32_t periodUs)
+{
+	spi3dma_handle_t *spi3 = GetSPI3Handle(BENCH_SPI_INSTANCE);
+	spi3_rx_frame_t frame;
+	uint32_t timeout = ((SystemCoreClock / 1000000U) * periodUs * 4U) + LOOPBACK_TIMEOUT;
+	uint32_t pauses;
+	uint32_t previous = 0;
+	uint32_t count = 0;
+	uint32_t start;
+
+	if((samples == 0) || (samples > BENCH_MAX_SAMPLES))
+		return -1;
+
+	EnableCycleCounter();
+	StopGPIOTrigger(spi3);
+	SetSPI3RxBatch(spi3, 1);
+	DrainRxFrames();
+	if(InitPITTrigger(spi3, periodUs))
+		return -1;
+	pauses = GetSPI3RxPauseCount(spi3);
+
+	start = DWT->CYCCNT;
+	while(count <= samples)
+	{
+		if(GetSPI3RxFrame(spi3, &frame) == 0)
+		{
+			if(count)
+				latencySample[count - 1] = frame.timestamp - previous;
+			previous = frame.timestamp;
+			count++;
+			ReleaseSPI3RxFrame(spi3, &frame);
+			start = DWT->CYCCNT;
+		}
+		else if((DWT->CYCCNT - start) > timeout)
+		{
+			PRINTF("\r\nno frame after %u of %u, start run?\r\n", count, samples);
+			return -1;
+		}
+	}
+
+	PRINTF("\r\n%u frames, PIT period %u us, trigger paused %u times\r\n", samples, periodUs,
+			GetSPI3RxPauseCount(spi3) - pauses);
+	PrintSamples("frame period", latencySample, samples, SPI3_TIMESTAMP_HZ);
+	PRINTF("jitter p-p %u ns\r\n",
+			(uint32_t)(((uint64_t)(latencySample[samples - 1] - latencySample[0]) * 1000000000U) / SPI3_TIMESTAMP_HZ));
+	return 0;
+}
+
+/*
+ * One Rx style capture of bytes into dest on BULK_DMA_CHANNEL: fixed source,
+ * beatBytes per always on request like the LPSPI Rx request, DWT cycles until DONE.
+ */
+static uint32_t RunCaptureCopy(uint32_t *dest, uint32_t bytes, uint32_t beatBytes)
+{
+	DMA_Type *dmaBASE = DMA0;
+	uint32_t size = (beatBytes == 4) ? 2 : 0; // 010b 32-bit, 000b 8-bit
+	uint32_t start;
+	uint32_t cycles;
+
+	dmaBASE->CERQ = DMA_CERQ_CERQ(BULK_DMA_CHANNEL);
+	dmaBASE->CDNE = DMA_CDNE_CDNE(BULK_DMA_CHANNEL);
+	dmaBASE->TCD[BULK_DMA_CHANNEL].SADDR = (uint32_t)&memBenchWord;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].SOFF = 0;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].ATTR = DMA_ATTR_SSIZE(size) | DMA_ATTR_DSIZE(size);
+	dmaBASE->TCD[BULK_DMA_CHANNEL].NBYTES_MLNO = beatBytes;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].SLAST = 0;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].DADDR = (uint32_t)dest;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].DOFF = beatBytes;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].CITER_ELINKNO = bytes / beatBytes;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].DLAST_SGA = 0;
+	dmaBASE->TCD[BULK_DMA_CHANNEL].CSR = DMA_CSR_DREQ_MASK; // one major loop
+	dmaBASE->TCD[BULK_DMA_CHANNEL].BITER_ELINKNO = bytes / beatBytes;
+	DMAMUX->CHCFG[BULK_DMA_CHANNEL] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_A_ON_MASK;
+
+	start = DWT->CYCCNT;
+	dmaBASE->SERQ = DMA_SERQ_SERQ(BULK_DMA_CHANNEL);
+	while(!(dmaBASE->TCD[BULK_DMA_CHANNEL].CSR & DMA_CSR_DONE_MASK))
+	{
+	}
+	cycles = DWT->CYCCNT - start;
+
+	DMAMUX->CHCFG[BULK_DMA_CHANNEL] = 0;
+	return cycles;
+}
+
+/*
+ * Sustained eDMA write rate of the Rx capture pattern into DTCM, OCRAM and the
+ * SEMC SDRAM, 32 bit beats (word mode) and 8 bit beats (byte mode), next to what
+ * LPSPI3 delivers at the fastest SCK of the rate sweep.  Runs without the trigger
+ * chain, the DMA clock is turned on here.
+ */
+void BenchCaptureMemory(void)
+{
+	static uint32_t * const target[] = { memBenchDtcm, memBenchOcram, memBenchSdram };
+	static const char * const targetName[] = { "DTCM ", "OCRAM", "SDRAM" };
+	uint32_t idx;
+	uint32_t wordCycles;
+	uint32_t byteCycles;
+
+	EnableCycleCounter();
+	CLOCK_EnableClock(kCLOCK_Dma);
+
+	PRINTF("\r\n%u byte capture, KiB/s with 32 bit / 8 bit beats\r\n", MEM_BENCH_BYTES);
+	for(idx = 0; idx < (sizeof(target) / sizeof(target[0])); idx++)
+	{
+		wordCycles = RunCaptureCopy(target[idx], MEM_BENCH_BYTES, 4);
+		byteCycles = RunCaptureCopy(target[idx], MEM_BENCH_BYTES, 1);
+		PRINTF("%s %u / %u\r\n", targetName[idx],
+				(uint32_t)(((uint64_t)MEM_BENCH_BYTES * SystemCoreClock) / wordCycles / 1024U),
+				(uint32_t)(((uint64_t)MEM_BENCH_BYTES * SystemCoreClock) / byteCycles / 1024U));
+	}
+	PRINTF("LPSPI3 at %u kHz SCK needs %u KiB/s\r\n",
+			(SPI3_LPSPI_CLK_HZ / (sweepSckDivider[sizeof(sweepSckDivider) - 1] + 2)) / 1000,
+			(SPI3_LPSPI_CLK_HZ / (sweepSckDivider[sizeof(sweepSckDivider) - 1] + 2)) / 8 / 1024);
+}
+
+/*
+ * DMA fill then CPU checksum of one pool buffer per pass, the source word changes
+ * every pass so a stale D-cache line shows up as a wrong sum.  Returns the CPU
+ * cycles of all passes, invalidate included when asked for.
+ */
+static uint32_t RunPoolRead(uint32_t *buffer, uint8_t invalidate, uint32_t *stale)
+{
+	uint32_t pass;
+	uint32_t idx;
+	uint32_t sum;
+	uint32_t start;
+	uint32_t cycles = 0;
+
+	*stale = 0;
+	for(pass = 0; pass < POOL_BENCH_PASSES; pass++)
+	{
+		memBenchWord = 0x01010101U * (pass + 1);
+		RunCaptureCopy(buffer, POOL_BENCH_BYTES, 4);
+
+		start = DWT->CYCCNT;
+		if(invalidate)
+			InvalidateSPI3Buffer(buffer, POOL_BENCH_BYTES);
+		sum = 0;
+		for(idx = 0; idx < (POOL_BENCH_BYTES / 4); idx++)
+		{
+			sum += buffer[idx];
+		}
+		cycles += DWT->CYCCNT - start;
+
+		if(sum != (memBenchWord * (POOL_BENCH_BYTES / 4)))
+			(*stale)++;
+	}
+	return cycles;
+}
+
+/*
+ * Consumer read rate of a DMA filled buffer from each spi3Buffer pool, with the
+ * maintenance the pool needs, plus the cacheable pool without invalidate to show
+ * the stale reads it avoids.  The buffers stay allocated for the next run.
+ */
+void BenchBufferPlacement(void)
+{
+	static uint32_t *poolBuffer[kSPI3_BufferPoolCount];
+	static const char * const poolName[kSPI3_BufferPoolCount] = { "NCACHE   ", "DTCM     ", "cacheable" };
+	uint32_t pool;
+	uint32_t cycles;
+	uint32_t stale;
+
+	EnableCycleCounter();
+	CLOCK_EnableClock(kCLOCK_Dma);
+
+	PRINTF("\r\n%u bytes x %u passes, DMA fill then CPU read\r\n", POOL_BENCH_BYTES, POOL_BENCH_PASSES);
+	for(pool = 0; pool < kSPI3_BufferPoolCount; pool++)
+	{
+		if(!poolBuffer[pool])
+			poolBuffer[pool] = (uint32_t *)AllocSPI3Buffer((spi3_buffer_pool_t)pool, POOL_BENCH_BYTES);
+		if(!poolBuffer[pool])
+		{
+			PRINTF("%s pool exhausted\r\n", poolName[pool]);
+			continue;
+		}
+
+		cycles = RunPoolRead(poolBuffer[pool], IsSPI3BufferCacheable((spi3_buffer_pool_t)pool), &stale);
+		PRINTF("%s %u KiB/s, %u stale passes\r\n", poolName[pool],
+				(uint32_t)(((uint64_t)POOL_BENCH_BYTES * POOL_BENCH_PASSES * SystemCoreClock) / cycles / 1024U), stale);
+	}
+
+	if(poolBuffer[kSPI3_BufferCacheable])
+	{
+		cycles = RunPoolRead(poolBuffer[kSPI3_BufferCacheable], 0, &stale);
+		PRINTF("cacheable without invalidate %u KiB/s, %u stale passes\r\n",
+				(uint32_t)(((uint64_t)POOL_BENCH_BYTES * POOL_BENCH_PASSES * SystemCoreClock) / cycles / 1024U), stale);
+	}
+}
@@ -0,0 +1,27 @@
+/*
+ * spi3Bench.h
+ *
+ *  Created on: Feb 20, 2023
+ *      Author: TBiberdorf
+ *
+ *  On target measurements of the GPIO triggered LPSPI3 DMA chain, results are
+ *  printed on the debug console.
+ */
+
+#ifndef APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3BENCH_H_
+#define APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3BENCH_H_
+
+#include <stdint.h>
+
+#define BENCH_MAX_SAMPLES (256)
+
+void InitBenchLoopback(void);
+int32_t BenchTriggerLatency(uint32_t samples, uint32_t periodUs);
+void BenchTriggerRate(void);
+void BenchDmaPriority(void);
+int32_t BenchTriggerPeriod(uint32_t samples, uint32_t periodUs);
+void BenchCaptureMemory(void);
+void BenchBufferPlacement(void);
+int32_t BenchIsrTime(uint32_t samples);
+
+#endif /* APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3BENCH_H_ */
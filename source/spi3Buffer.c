@@ -0,0 +1,85 @@
+/*
+ * spi3Buffer.c
+ *
+ *  Created on: Mar 6, 2023
+ *      Author: TBiberdorf
+ */
+
+#include "fsl_device_registers.h"
+#include "fsl_common.h"
+#include "spi3Buffer.h"
+
+/*
+ * One bump allocator per pool, buffers are handed out for the life of the
+ * application or until ResetSPI3BufferPool().  The pools sit in the memories the
+ * MCUXpresso managed linker script and BOARD_ConfigMPU() already set up.
+ */
+AT_NONCACHEABLE_SECTION_ALIGN(static uint8_t ncachePool[SPI3_NCACHE_POOL_SIZE], SPI3_BUFFER_LINE);
+static uint8_t dtcmPool[SPI3_DTCM_POOL_SIZE] __attribute__((section(".bss.$SRAM_DTC"), aligned(SPI3_BUFFER_LINE)));
+static uint8_t cacheablePool[SPI3_CACHEABLE_POOL_SIZE] __attribute__((section(".bss.$SRAM_OC"), aligned(SPI3_BUFFER_LINE)));
+
+static uint8_t * const poolBase[kSPI3_BufferPoolCount] = { ncachePool, dtcmPool, cacheablePool };
+static const uint32_t poolSize[kSPI3_BufferPoolCount] = { SPI3_NCACHE_POOL_SIZE, SPI3_DTCM_POOL_SIZE, SPI3_CACHEABLE_POOL_SIZE };
+static uint32_t poolUsed[kSPI3_BufferPoolCount];
+
+/*
+ * size bytes from pool, line aligned and padded to whole lines.  Returns 0 when
+ * the pool is exhausted.
+ */
+uint8_t *AllocSPI3Buffer(spi3_buffer_pool_t pool, uint32_t size)
+{
+	uint8_t *buffer;
+
+	if((pool >= kSPI3_BufferPoolCount) || (size == 0))
+		return 0;
+
+	size = (size + SPI3_BUFFER_LINE - 1) & ~(SPI3_BUFFER_LINE - 1);
+	if(size > (poolSize[pool] - poolUsed[pool]))
+		return 0;
+
+	buffer = poolBase[pool] + poolUsed[pool];
+	poolUsed[pool] += size;
+
+	if(pool == kSPI3_BufferCacheable)
+	{
+		// no dirty lines left that a later eviction could write over DMA data
+		SCB_CleanInvalidateDCache_by_Addr((uint32_t *)buffer, (int32_t)size);
+	}
+	return buffer;
+}
+
+/*
+ * Give every buffer of pool back, none of them may be used by a DMA channel any more.
+ */
+void ResetSPI3BufferPool(spi3_buffer_pool_t pool)
+{
+	if(pool < kSPI3_BufferPoolCount)
+		poolUsed[pool] = 0;
+}
+
+uint8_t IsSPI3BufferCacheable(spi3_buffer_pool_t pool)
+{
+	return (pool == kSPI3_BufferCacheable);
+}
+
+/*
+ * Consumer side invalidate for buffers the driver does not maintain (stream mode,
+ * buffers filled outside the trigger chain).  Widened to whole lines.
+ */
+void InvalidateSPI3Buffer(const void *buffer, uint32_t size)
+{
+	uint32_t start = (uint32_t)buffer & ~(SPI3_BUFFER_LINE - 1);
+
+	SCB_InvalidateDCache_by_Addr((void *)start, (int32_t)(((uint32_t)buffer + size) - start));
+}
+
+/*
+ * Write CPU filled Tx data back to RAM before the eDMA reads it, harmless for the
+ * non cacheable pools.
+ */
+void CleanSPI3Buffer(const void *buffer, uint32_t size)
+{
+	uint32_t start = (uint32_t)buffer & ~(SPI3_BUFFER_LINE - 1);
+
+	SCB_CleanDCache_by_Addr((uint32_t *)start, (int32_t)(((uint32_t)buffer + size) - start));
+}
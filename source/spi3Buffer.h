@@ -0,0 +1,39 @@
+/*
+ * spi3Buffer.h
+ *
+ *  Created on: Mar 6, 2023
+ *      Author: TBiberdorf
+ *
+ *  DMA buffer pools for the spi3DMA Rx/Tx buffers.  Every buffer starts on a
+ *  D-cache line and is padded to whole lines, so invalidating a buffer never
+ *  throws away CPU data sharing a line with it.
+ */
+
+#ifndef APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3BUFFER_H_
+#define APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3BUFFER_H_
+
+#include <stdint.h>
+
+#define SPI3_BUFFER_LINE         (32U)    // Cortex-M7 D-cache line
+#define SPI3_NCACHE_POOL_SIZE    (32768U) // NCACHE_REGION, MPU region 10 in BOARD_ConfigMPU()
+#define SPI3_DTCM_POOL_SIZE      (16384U)
+#define SPI3_CACHEABLE_POOL_SIZE (32768U) // OCRAM, write back cached
+
+/*!
+ * @brief Where a DMA buffer lives
+ */
+typedef enum _spi3_buffer_pool
+{
+	kSPI3_BufferNonCacheable = 0, /*!< NCACHE_REGION, CPU reads go to SDRAM every time */
+	kSPI3_BufferDtcm,             /*!< DTCM, never cached, single cycle CPU access */
+	kSPI3_BufferCacheable,        /*!< OCRAM, cached, Rx needs SetSPI3RxCacheMaintenance() */
+	kSPI3_BufferPoolCount
+} spi3_buffer_pool_t;
+
+uint8_t *AllocSPI3Buffer(spi3_buffer_pool_t pool, uint32_t size);
+void ResetSPI3BufferPool(spi3_buffer_pool_t pool);
+uint8_t IsSPI3BufferCacheable(spi3_buffer_pool_t pool);
+void InvalidateSPI3Buffer(const void *buffer, uint32_t size);
+void CleanSPI3Buffer(const void *buffer, uint32_t size);
+
+#endif /* APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3BUFFER_H_ */
@@ -7,11 +7,12 @@
 
 #include <stdint.h>
 //#include "config.h"
+#include "spi3DMAApi.h" // first, SPI3_HOT_PATH_ITCM selects the sections in spi3DMA.h
 #include "spi3DMA.h"
 
 
 
-void EDMATcdReset(edma_tcd_t *tcd)
+SPI3_ITCM_CODE void EDMATcdReset(edma_tcd_t *tcd)
 {
 
     /* Reset channel TCD */
@@ -29,141 +30,1507 @@ void EDMATcdReset(edma_tcd_t *tcd)
     tcd->BITER = 0U;
 }
 
-#define BUFFER_SIZE (25)
-#define TRANSFER_SIZE     25U     /* Transfer dataSize */
+#define BUFFER_SIZE (25)        /* default frame length until SetSPI3Frame() is called */
 
+/* eDMA channels of one instance, offsets from its first channel */
 #define LPSPI_MASTER_DMA_RX_CHANNEL (0)
 #define LPSPI_MASTER_DMA_TX_CHANNEL (1)
 
 #define TRIGGER_DMA_TX_CHANNEL (2)
 #define TRIGGER_DMA_RX_CHANNEL (3)
+#define TIMESTAMP_DMA_CHANNEL (4)
+#define OVERRUN_DMA_CHANNEL (5)
+
+#define TRIGGER_LOG_DMOD (9) // log2(sizeof(triggerCiterLog))
+
+/*
+ * Hardware one LPSPI instance runs on.  Rx channels 0/16 share DMA0_DMA16_IRQn and
+ * 8/24 share DMA8_DMA24_IRQn, each XBAR1 output 0..3 has its own DMAMUX request.
+ */
+typedef struct _spi3dma_instance
+{
+	LPSPI_Type *spiBASE;
+	uint16_t rxRequest;      // DMAMUX source of the LPSPI Rx FIFO
+	uint16_t txRequest;      // DMAMUX source of the LPSPI Tx FIFO
+	uint16_t triggerRequest; // DMAMUX source of the XBAR1 output below
+	uint8_t firstChannel;    // Rx channel, the other five follow it
+	uint8_t xbarOutput;      // XBAR1_OUTx feeding the trigger channel
+	uint32_t clockGate;      // CCM_CCGR1 bits of the LPSPI clock
+} spi3dma_instance_t;
+
+static const spi3dma_instance_t spi3Instance[SPI3_INSTANCE_COUNT] =
+{
+	{ LPSPI1, kDmaRequestMuxLPSPI1Rx, kDmaRequestMuxLPSPI1Tx, kDmaRequestMuxXBAR1Request1,  8, 1, 0x00000003 },
+	{ LPSPI2, kDmaRequestMuxLPSPI2Rx, kDmaRequestMuxLPSPI2Tx, kDmaRequestMuxXBAR1Request2, 16, 2, 0x0000000C },
+	{ LPSPI3, kDmaRequestMuxLPSPI3Rx, kDmaRequestMuxLPSPI3Tx, kDmaRequestMuxXBAR1Request0,  0, 0, 0x00000030 },
+	{ LPSPI4, kDmaRequestMuxLPSPI4Rx, kDmaRequestMuxLPSPI4Tx, kDmaRequestMuxXBAR1Request3, 24, 3, 0x000000C0 },
+};
+
+/*
+ * State of one triggered LPSPI DMA stream.  Everything the eDMA reads (TCD images,
+ * SERQ values, timestamp and overrun arrays) is part of it, so the handles live in
+ * DTCM.  The overrun log goes first for the 512 byte alignment DMOD needs.
+ */
+struct _spi3dma_handle
+{
+	/*
+	 * Overrun log.  The Rx trigger channel links the overrun channel which copies the
+	 * Rx channel CITER into triggerCiterLog on every trigger.  A frame that completed
+	 * leaves the next Rx TCD loaded with CITER == BITER, anything else means the edge
+	 * came in while a frame was still in flight.  CITER 1 with DLAST 0 keeps DADDR
+	 * moving, DMOD wraps it inside the 512 byte aligned log, so the channel can link
+	 * on every trigger.
+	 */
+	volatile uint16_t triggerCiterLog[SPI3_TRIGGER_LOG_SIZE] __attribute__((aligned(512)));
+
+	// TCD images of the frame, segment 0 is what gets loaded into the channel to (re)arm it.
+	// More than one segment is used for frames longer than one major loop, must be 32 byte aligned
+	edma_tcd_t rxSegmentTCD[SPI3_MAX_FRAME_SEGMENTS] __attribute__((aligned(32)));
+	edma_tcd_t txSegmentTCD[SPI3_MAX_FRAME_SEGMENTS] __attribute__((aligned(32)));
+	// Rx ring, one TCD per slot linked in a circle, each frame lands in the next slot
+	edma_tcd_t rxRingTCD[SPI3_RX_RING_MAX_SLOTS] __attribute__((aligned(32)));
+	edma_tcd_t triggerTxImage __attribute__((aligned(32)));
+	edma_tcd_t triggerRxImage __attribute__((aligned(32)));
+	edma_tcd_t timestampTCD __attribute__((aligned(32)));
+	edma_tcd_t overrunTCD __attribute__((aligned(32)));
+
+	/*
+	 * Frame timestamps.  The last Rx TCD of a frame links the timestamp channel which
+	 * copies the GPT1 counter into rxTimestamp[frame % slots] a few bus cycles after the
+	 * last byte is stored.  Linked from the frame end rather than the trigger, a trigger
+	 * dropped while a frame is in flight does not move the entries off their slots.
+	 * DWT->CYCCNT sits on the Cortex-M7 private peripheral bus which the eDMA can not
+	 * reach, so the free running GPT1 on PERCLK is used instead.
+	 */
+	volatile uint32_t rxTimestamp[SPI3_RX_RING_MAX_SLOTS];
+
+	LPSPI_Type *spiBASE;
+	const spi3dma_instance_t *instance;
+	uint8_t rxChannel;
+	uint8_t txChannel;
+	uint8_t triggerTxChannel;
+	uint8_t triggerRxChannel;
+	uint8_t timestampChannel;
+	uint8_t overrunChannel;
+	uint8_t triggerTxDMA; // SERQ value to enable Request Register for Tx DMA
+	uint8_t triggerRxDMA; // SERQ value to enable Request Register for Rx DMA
+
+	uint8_t firstTimeFlag;
+	uint8_t volatile gpioTriggerFlag; // trigger channel requested by hardware, GPIO edge or PIT
+	uint8_t volatile passRxSetupFlag;
+	uint8_t volatile passTxSetupFlag;
+	uint8_t volatile combineDMATriggerFlag;
+	uint8_t volatile triggerTxERQ;
+	uint8_t volatile triggerRxERQ;
+	uint8_t volatile timestampFlag;
+	uint8_t volatile overrunFlag;
+	uint8_t priorityFlag; // channels ranked on top of the eDMA arbitration, see SetSPI3PriorityProfile()
+	uint8_t rxInvalidateFlag; // Rx buffers are cacheable, DMA_irq() invalidates what completed
+
+	/*
+	 * Word mode, 4 bytes per DMA request and TDR/RDR access with FRAMESZ 31.  BYSW set in
+	 * RestSPI3Peripheral() keeps buffer[0] the first byte on the wire.  A tail of 1..3 bytes
+	 * is sent as 8 bit frames, the Tx chain rewrites TCR through the FIFO around it.
+	 */
+	uint8_t volatile wordModeFlag;
+	uint32_t tcrWordFrame; // TCR with FRAMESZ 31, DMA source
+	uint32_t tcrByteFrame; // TCR with FRAMESZ 7, DMA source
+
+	spi3_frame_t currentFrame;
+	uint8_t *rxRingBuffer;
+	uint32_t rxRingSlots;
+
+	/*
+	 * Rx stream, frames packed back to back into a power of 2 sized buffer aligned to
+	 * its size.  DMOD wraps DADDR inside it and DLAST is 0, so the Rx TCD is never
+	 * reloaded and DADDR is the write pointer, see GetSPI3RxStreamWriteIndex().
+	 */
+	uint8_t *rxStreamBuffer;
+	uint32_t rxStreamLog2;
+	volatile uint32_t rxFrameCount; // producer index, only written by DMA_irq()
+	volatile uint32_t rxFlushCount; // producer index, only written by FlushSPI3RxBatch()
+	volatile uint32_t rxIrqCycles;  // DWT cycle count when DMA_irq() last ran
+	uint32_t rxIrqBatch;            // ring slots per Rx interrupt
+	uint32_t irqDmaCnt;
+
+	/*
+	 * Zero-copy frame queue on top of the Rx ring.  DMA_irq() is the only producer
+	 * (rxFrameCount), the application the only consumer.  rxReadCount and
+	 * rxReleaseCount are written by the consumer only: frames between them are
+	 * handed out and must not be overwritten.  When DMA_irq() runs the next batch
+	 * may already be on its way into the ring, so it holds the GPIO trigger off
+	 * when the batch after that one would land in such a slot and
+	 * ReleaseSPI3RxFrame() re-arms it.  The ring needs two batches at least.
+	 */
+	uint32_t rxReadCount;
+	volatile uint32_t rxReleaseCount;
+	uint8_t volatile rxPausedFlag;
+	volatile uint32_t rxPauseCount;
+};
+
+static spi3dma_handle_t spi3Handle[SPI3_INSTANCE_COUNT] SPI3_DTCM_BSS;
+
+/*
+ * Handle of LPSPI1..4, set up with the defaults on first use: 25 byte frames, byte
+ * mode, no ring, one Rx interrupt per frame.
+ */
+spi3dma_handle_t *GetSPI3Handle(uint32_t lpspiInstance)
+{
+	spi3dma_handle_t *handle;
+	const spi3dma_instance_t *instance;
+
+	if((lpspiInstance < 1) || (lpspiInstance > SPI3_INSTANCE_COUNT))
+		return 0;
+
+	handle = &spi3Handle[lpspiInstance - 1];
+	if(!handle->instance)
+	{
+		instance = &spi3Instance[lpspiInstance - 1];
+		handle->spiBASE = instance->spiBASE;
+		handle->rxChannel = instance->firstChannel + LPSPI_MASTER_DMA_RX_CHANNEL;
+		handle->txChannel = instance->firstChannel + LPSPI_MASTER_DMA_TX_CHANNEL;
+		handle->triggerTxChannel = instance->firstChannel + TRIGGER_DMA_TX_CHANNEL;
+		handle->triggerRxChannel = instance->firstChannel + TRIGGER_DMA_RX_CHANNEL;
+		handle->timestampChannel = instance->firstChannel + TIMESTAMP_DMA_CHANNEL;
+		handle->overrunChannel = instance->firstChannel + OVERRUN_DMA_CHANNEL;
+		handle->triggerTxDMA = handle->txChannel;
+		handle->triggerRxDMA = handle->rxChannel;
+		handle->firstTimeFlag = 1;
+		handle->combineDMATriggerFlag = 1;
+		handle->triggerTxERQ = 1;
+		handle->triggerRxERQ = 1;
+		handle->currentFrame.length = BUFFER_SIZE;
+		handle->rxIrqBatch = 1;
+		handle->instance = instance;
+	}
+	return handle;
+}
 
 void InitClocks()
 {
-	// start GPIO1 clocks
-	// refer to Ref Manual, page 1146&1147, section 14.7.22
-	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 27..26
-	CCM->CCGR1 |= 0x03000000;
+	// start GPIO1 clocks
+	// refer to Ref Manual, page 1146&1147, section 14.7.22
+	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 27..26
+	CCM->CCGR1 |= 0x03000000;
+
+	// start GPIO2 clocks
+	// refer to Ref Manual, page 1144&1145, section 14.7.21
+	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 31..30
+	CCM->CCGR1 |= 0xC0000000;
+
+	// start GPIO3 clocks
+	// refer to Ref Manual, page 1147&1148, section 14.7.23
+	// CCM Clock Gating Register 2 (CCM_CCGR1) bits 27..26
+	CCM->CCGR2 |= 0x03000000;
+
+	// start XBAR1 clocks
+	// refer to Ref Manual, page 1147&1148, section 14.7.23
+	// CCM Clock Gating Register 2 (CCM_CCGR2) bits 23..22
+	CCM->CCGR2 |= 0x00C00000;
+
+	// start SPI3 clocks
+	// refer to Ref Manual, page 1146&1147, section 14.7.22
+	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 5..4
+	CCM->CCGR1 |= 0x00000030;
+}
+
+/*
+ * Clock and configure the LPSPI of the handle.  The LPSPI3 pads of this board are
+ * set up here, the pads of the other instances are up to the caller.
+ */
+void InitSPI3Peripheral(spi3dma_handle_t *handle)
+{
+	LPSPI_Type *spiBASE = handle->spiBASE;
+#define ALT2 (2)
+#define ALT5 (5)
+#define ALT7 (7)
+#define CTL_PAD (0x1088) // SRE 0,DSE 1,SPEED 2,ODE 0,PKE 1,PUE 0, HYS 0
+
+	// start LPSPIx clocks
+	// refer to Ref Manual, page 1146&1147, section 14.7.22
+	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 7..0
+	CCM->CCGR1 |= handle->instance->clockGate;
+
+	if(spiBASE == LPSPI3)
+	{
+		// GPIO_AD_B0_03 LPSP3 CS0
+		IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_03] = ALT7;
+		IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_03] = CTL_PAD;
+		// GPIO_AD_B0_00 LPSPI3 CLK
+		IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_00] = ALT7;
+		IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_00] = CTL_PAD;
+		// GPIO_AD_B0_02 LPSPI3 MISO
+		IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_02] = ALT7;
+		IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_02] = CTL_PAD;
+		// GPIO_AD_B1_14 LPSPI3 MOSI
+		IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B1_14] = ALT2;
+		IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B1_14] = CTL_PAD;
+	}
+
+	spiBASE->CR  = 0;  // disable
+	spiBASE->CFGR1 = 1; // master mode
+	spiBASE->CR  = 1;  // enable
+	spiBASE->CR  = 0x305; // reset Rx FIFO, TX FIFO, debug en, enable
+	spiBASE->CCR = 0x08082032; // SDK x8, PCS x8, DBT x20 DIV x32
+	spiBASE->TCR = 0xC0000007; // CPOL 1, CPHA 1, PRE 1, PCS0, LSBF 0, BYSW 0, CONT 0, CONTC 0, RXMSK 0, TXMSK 0, WID 1, FRAME 8
+	spiBASE->CR  = 0x05; // debug en, enable
+
+}
+
+void TxTest(spi3dma_handle_t *handle)
+{
+	LPSPI_Type *spiBASE = handle->spiBASE;
+	uint8_t idx;
+	volatile uint32_t readValue;
+#define START ('0')
+#define END ('9'+1)
+	for(idx=START; idx < END; idx++ )
+	{
+		spiBASE->TDR = idx;
+		while(spiBASE->RSR & 0x2)
+			;
+		readValue = spiBASE->RDR;
+		if( readValue != idx)
+			break;
+	}
+}
+
+#if SPI3_HOT_PATH_ITCM
+static uint32_t itcmVectors[SPI3_VECTOR_COUNT] SPI3_ITCM_BSS __attribute__((aligned(SPI3_VECTOR_ALIGN)));
+
+/*
+ * Serve every exception from a copy of the vector table in ITCM, the vector fetch on
+ * entry then never waits for a FlexSPI refill.  The copy is identical, so switching
+ * VTOR with interrupts enabled is safe.
+ */
+static void RelocateVectorsToItcm(void)
+{
+	const uint32_t *vectors = (const uint32_t *)SCB_VTOR_REG;
+	uint32_t idx;
+
+	if(vectors == itcmVectors)
+		return;
+
+	for(idx = 0; idx < SPI3_VECTOR_COUNT; idx++)
+	{
+		itcmVectors[idx] = vectors[idx];
+	}
+	SPI3_DSB();
+	SCB_VTOR_REG = (uint32_t)itcmVectors;
+	SPI3_DSB();
+	SPI3_ISB();
+}
+#endif
+
+void InitDMAandEDMA(spi3dma_handle_t *handle)
+{
+	edma_tcd_t *image;
+
+	// start DMA0 clocks
+	// refer to Ref Manual, page 1151&1152, section 14.7.26
+	// CCM Clock Gating Register 5 (CCM_CCGR5) bits 7..6
+	CCM->CCGR5 |= 0xC0;
+
+#if SPI3_HOT_PATH_ITCM
+	RelocateVectorsToItcm();
+#endif
+
+	// now configure the DMAMUX to the LPSPI RX/TX registers.
+	DMAMUX->CHCFG[handle->rxChannel] = 0x0;
+	DMAMUX->CHCFG[handle->rxChannel] = DMAMUX_CHCFG_SOURCE(handle->instance->rxRequest);  // set LPSPI RX
+	DMAMUX->CHCFG[handle->rxChannel] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+
+	DMAMUX->CHCFG[handle->txChannel] = 0x0;
+	DMAMUX->CHCFG[handle->txChannel] = DMAMUX_CHCFG_SOURCE(handle->instance->txRequest);  // set LPSPI TX
+	DMAMUX->CHCFG[handle->txChannel] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+
+	DMAMUX->CHCFG[handle->triggerTxChannel] = 0x0;
+	DMAMUX->CHCFG[handle->triggerTxChannel] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+
+	DMAMUX->CHCFG[handle->triggerRxChannel] = 0x0;
+	DMAMUX->CHCFG[handle->triggerRxChannel] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+
+	/* Configure TCD to set the Tx ERQ so as to start a Tx transfer */
+	image = &handle->triggerTxImage;
+	image->SADDR = (uint32_t)&handle->triggerTxDMA; // Tx channel number to be written into SERQ
+	image->SOFF = 0;                        // source address does not change
+	image->ATTR = 0;                        // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
+	image->NBYTES = 1;                      // number of bytes in each minor loop transfer.
+	image->SLAST = 0;
+	image->DADDR = (uint32_t)&(DMA0->SERQ); // DMA0->SERQ register
+	image->DOFF = 0;                        // destination is a hardware register, so we will not increment it
+	image->CITER = 1;                       // one SERQ write per trigger
+	image->BITER = 1;
+	image->DLAST_SGA = 0;
+	// no DREQ so the XBAR request stays enabled for the next edge, link the Rx trigger channel when done
+	image->CSR = DMA_CSR_MAJORLINKCH(handle->triggerRxChannel) | DMA_CSR_MAJORELINK_MASK;
+
+	/* Configure TCD to set the Rx ERQ so as to start a Rx transfer */
+	image = &handle->triggerRxImage;
+	image->SADDR = (uint32_t)&handle->triggerRxDMA; // Rx channel number to be written into SERQ
+	image->SOFF = 0;
+	image->ATTR = 0;
+	image->NBYTES = 1;
+	image->SLAST = 0;
+	image->DADDR = (uint32_t)&(DMA0->SERQ);
+	image->DOFF = 0;
+	image->CITER = 1;
+	image->BITER = 1;
+	image->DLAST_SGA = 0;
+	image->CSR = 0;                         // started by the Tx trigger link, ERQ is never set
+}
+
+#define REMOVE_CONT (1)
+
+/*
+ * Hardware trigger path, no CPU between the edge and the first SCK:
+ *   GPIO_AD_B0_15 -> XBAR1_IN25 -> XBAR1_OUTx -> DMA_CH_MUX_REQ30/31/94/95 -> trigger Tx channel
+ *   trigger Tx channel TCD writes the Tx channel number into SERQ and major links the trigger Rx channel
+ *   trigger Rx channel TCD writes the Rx channel number into SERQ
+ * The Tx/Rx TCDs clear their own ERQ (DREQ) once the frame is done, the trigger channel keeps
+ * its ERQ so the next edge starts the next frame.
+ */
+#define TRIGGER_PAD        kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_15
+#define TRIGGER_XBAR_INPUT (25) // XBAR1_IN25
+#define TRIGGER_EDGE       (2)  // 01b rising, 10b falling, 11b both
+
+/*
+ * Start frames of this handle from xbarInput through the XBAR1 output of its instance.
+ * The pad of XBAR1_IN25 (GPIO_AD_B0_15) is set up here, other inputs have to be muxed
+ * by the caller.
+ */
+void InitGPIOTrigger(spi3dma_handle_t *handle, uint8_t xbarInput)
+{
+	uint32_t output = handle->instance->xbarOutput;
+	uint32_t shift = (output & 1) * 8; // two outputs per SEL/CTRL register
+	volatile uint16_t *sel = &XBARA1->SEL0 + (output / 2);
+	volatile uint16_t *ctrl = &XBARA1->CTRL0 + (output / 2);
+#define ALT1 (1)
+#define TRIGGER_CTL_PAD (0x1B088) // SRE 0,DSE 1,SPEED 2,ODE 0,PKE 1,PUE 1,PUS 100K pull up,HYS 1
+	if(xbarInput == TRIGGER_XBAR_INPUT)
+	{
+		// GPIO_AD_B0_15 XBAR1_IN25
+		IOMUXC->SW_MUX_CTL_PAD[TRIGGER_PAD] = ALT1;
+		IOMUXC->SW_PAD_CTL_PAD[TRIGGER_PAD] = TRIGGER_CTL_PAD;
+		IOMUXC->SELECT_INPUT[kIOMUXC_XBAR1_IN25_SELECT_INPUT] = 0; // daisy XBAR1_IN25 from GPIO_AD_B0_15
+	}
+
+	// XBAR1_OUT0..3 are hard wired to DMA_CH_MUX_REQ30/31/94/95
+	// refer to Ref Manual, section 61.3.1 XBARA_SEL0 and 61.3.67 XBARA_CTRL0
+	*sel = (*sel & ~(XBARA_SEL0_SEL0_MASK << shift)) | (XBARA_SEL0_SEL0(xbarInput) << shift);
+	*ctrl = (*ctrl & ~((XBARA_CTRL0_DEN0_MASK | XBARA_CTRL0_IEN0_MASK | XBARA_CTRL0_EDGE0_MASK) << shift))
+			| ((XBARA_CTRL0_EDGE0(TRIGGER_EDGE)
+			| XBARA_CTRL0_STS0_MASK  // clear any edge seen before we were ready
+			| XBARA_CTRL0_DEN0_MASK) << shift); // edge raises a DMA request, the DMA acknowledge clears STS
+
+	// the trigger channel now takes its request from XBAR1 instead of software
+	DMAMUX->CHCFG[handle->triggerTxChannel] = 0x0;
+	DMAMUX->CHCFG[handle->triggerTxChannel] = DMAMUX_CHCFG_SOURCE(handle->instance->triggerRequest);
+	DMAMUX->CHCFG[handle->triggerTxChannel] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+
+	handle->gpioTriggerFlag = 1;
+
+	if(!handle->firstTimeFlag)
+	{
+		// TCDs are already in place, arm the trigger channel now
+		DMA0->SERQ = DMA_SERQ_SERQ(handle->triggerTxChannel);
+	}
+}
+
+void StopGPIOTrigger(spi3dma_handle_t *handle)
+{
+	uint32_t output = handle->instance->xbarOutput;
+	volatile uint16_t *ctrl = &XBARA1->CTRL0 + (output / 2);
+
+	DMA0->CERQ = DMA_CERQ_CERQ(handle->triggerTxChannel);
+	*ctrl &= ~((XBARA_CTRL0_DEN0_MASK | XBARA_CTRL0_EDGE0_MASK) << ((output & 1) * 8));
+	handle->gpioTriggerFlag = 0;
+}
+
+/*
+ * Fixed rate frames.  DMAMUX channels 0..3 can gate their request with PIT channel
+ * 0..3 (CHCFG TRIG), with the always on source the trigger Tx channel then gets one
+ * request per PIT period and runs the same chain a GPIO edge does, no CPU per frame.
+ * Only the LPSPI3 trigger channel (2) is in that range.
+ * refer to Ref Manual, DMAMUX chapter, Periodic Trigger Mode
+ */
+#define PIT_TRIGGER_CHANNELS (4)
+#define PIT_TICKS_PER_US     (SPI3_TIMESTAMP_HZ / 1000000) // PIT and GPT1 both count PERCLK_CLK_ROOT
+
+int32_t InitPITTrigger(spi3dma_handle_t *handle, uint32_t periodUs)
+{
+	PIT_Type *pitBASE = PIT;
+	uint32_t channel = handle->triggerTxChannel;
+
+	if(channel >= PIT_TRIGGER_CHANNELS)
+		return -1;
+	if((periodUs == 0) || (periodUs > (0xFFFFFFFFU / PIT_TICKS_PER_US)))
+		return -1;
+
+	// start PIT clocks
+	// refer to Ref Manual, page 1146&1147, section 14.7.22
+	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 13..12
+	CCM->CCGR1 |= 0x00003000;
+
+	pitBASE->MCR = PIT_MCR_FRZ_MASK; // module enabled, timers stop in debug
+	pitBASE->CHANNEL[channel].TCTRL = 0;
+	pitBASE->CHANNEL[channel].LDVAL = (periodUs * PIT_TICKS_PER_US) - 1;
+	pitBASE->CHANNEL[channel].TFLG = PIT_TFLG_TIF_MASK;
+
+	// the trigger channel now takes one always on request per PIT period
+	DMAMUX->CHCFG[channel] = 0x0;
+	DMAMUX->CHCFG[channel] = DMAMUX_CHCFG_A_ON_MASK | DMAMUX_CHCFG_TRIG_MASK;
+	DMAMUX->CHCFG[channel] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+
+	handle->gpioTriggerFlag = 1;
+	pitBASE->CHANNEL[channel].TCTRL = PIT_TCTRL_TEN_MASK;
+
+	if(!handle->firstTimeFlag)
+	{
+		// TCDs are already in place, arm the trigger channel now
+		DMA0->SERQ = DMA_SERQ_SERQ(channel);
+	}
+	return 0;
+}
+
+void StopPITTrigger(spi3dma_handle_t *handle)
+{
+	uint32_t channel = handle->triggerTxChannel;
+
+	if(channel >= PIT_TRIGGER_CHANNELS)
+		return;
+
+	DMA0->CERQ = DMA_CERQ_CERQ(channel);
+	PIT->CHANNEL[channel].TCTRL = 0;
+	DMAMUX->CHCFG[channel] = DMAMUX_CHCFG_ENBL_MASK; // back to software requests
+	handle->gpioTriggerFlag = 0;
+}
+
+static int32_t CheckFrameLength(uint32_t length, uint32_t singleTCD, uint8_t wordMode)
+{
+	if((length == 0) || (length > SPI3_MAX_FRAME_LENGTH))
+		return -1;
+	if(singleTCD && (length > SPI3_MAX_CITER))
+		return -1; // ring slots and the stream are one TCD each
+	if(wordMode && ((length / 4) > SPI3_MAX_CITER))
+		return -1; // one TCD for the words plus the tail
+	if(wordMode && singleTCD && (length & 3))
+		return -1; // ring slots and the stream have no room for a tail TCD
+	return 0;
+}
+
+/*
+ * Word mode moves 32 bit beats straight from and to the buffers, a buffer that is
+ * not 4 byte aligned would stop the channel with a SAE/DAE configuration error.
+ * ringBuffer 0 for none.  Frames shorter than 4 bytes always go as bytes.
+ */
+static int32_t CheckWordBuffers(const spi3_frame_t *frame, const uint8_t *ringBuffer, uint8_t wordMode)
+{
+	if(!wordMode || (frame->length < 4))
+		return 0;
+	if(((uint32_t)frame->txBuffer | (uint32_t)frame->rxBuffer | (uint32_t)ringBuffer) & 3)
+		return -1;
+	return 0;
+}
+
+/*
+ * Copy a 32 byte TCD image from RAM into the channel TCD as eight word stores.
+ * The CSR/BITER word goes last since writing ESG while DONE is still set from the
+ * previous major loop is a configuration error.
+ */
+SPI3_ITCM_CODE static void EDMATcdLoad(DMA_Type *dmaBASE, uint32_t channel, const edma_tcd_t *image)
+{
+	volatile uint32_t *tcd = (volatile uint32_t *)&dmaBASE->TCD[channel];
+	const volatile uint32_t *src = (const volatile uint32_t *)image;
+
+	dmaBASE->CDNE = DMA_CDNE_CDNE(channel);
+	tcd[0] = src[0]; // SADDR
+	tcd[1] = src[1]; // SOFF | ATTR
+	tcd[2] = src[2]; // NBYTES
+	tcd[3] = src[3]; // SLAST
+	tcd[4] = src[4]; // DADDR
+	tcd[5] = src[5]; // DOFF | CITER
+	tcd[6] = src[6]; // DLAST_SGA
+	tcd[7] = src[7]; // CSR | BITER
+}
+
+/*
+ * Hold the GPIO trigger of a running handle off while its TCDs are swapped.
+ */
+static void HoldTrigger(spi3dma_handle_t *handle)
+{
+	if(handle->gpioTriggerFlag && !handle->firstTimeFlag)
+		DMA0->CERQ = DMA_CERQ_CERQ(handle->triggerTxChannel);
+}
+
+static void ReleaseTrigger(spi3dma_handle_t *handle)
+{
+	if(handle->gpioTriggerFlag && !handle->firstTimeFlag)
+		DMA0->SERQ = DMA_SERQ_SERQ(handle->triggerTxChannel);
+}
+
+/*
+ * After HoldTrigger(): let a frame the trigger chain already started run out.
+ * Its SERQ writes land, then the Rx and Tx TCDs clear their own ERQ (DREQ) with
+ * the last byte.  Rewriting a TCD before that leaves Rx and Tx out of step.
+ * With the vector enabled DMA_irq() counts that frame before the reload starts
+ * the ring counters over.  Thread level only.
+ */
+static void WaitFrameIdle(spi3dma_handle_t *handle, DMA_Type *dmaBASE)
+{
+	uint32_t frameChannels = (1U << handle->rxChannel) | (1U << handle->txChannel);
+
+	while((dmaBASE->ERQ & frameChannels)
+			|| ((dmaBASE->TCD[handle->triggerTxChannel].CSR | dmaBASE->TCD[handle->triggerRxChannel].CSR)
+				& (DMA_CSR_START_MASK | DMA_CSR_ACTIVE_MASK)))
+	{
+		// let a frame in flight finish
+	}
+	while((dmaBASE->INT & (1U << handle->rxChannel)) && (NVIC_ISER0_REG & SPI3_DMA_IRQ_MASK(handle->rxChannel)))
+	{
+		// its interrupt is on the way
+	}
+}
+
+static void ConfigTimestampTCD(spi3dma_handle_t *handle, DMA_Type *dmaBASE)
+{
+	edma_tcd_t *tcd = &handle->timestampTCD;
+	uint32_t slots = handle->rxRingSlots ? handle->rxRingSlots : 1;
+
+	EDMATcdReset(tcd);
+	tcd->SADDR = (uint32_t)&(GPT1->CNT);
+	tcd->SOFF = 0;
+	tcd->DADDR = (uint32_t)&handle->rxTimestamp[0];
+	tcd->DOFF = 4;
+	tcd->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2); // transfer size of 32 bits (010b => 32-bit)
+	tcd->NBYTES = 4;
+	tcd->CITER = slots; // one entry per completed frame, wraps with the Rx ring
+	tcd->BITER = slots;
+	tcd->SLAST = 0;
+	tcd->DLAST_SGA = -(int32_t)(slots * 4);
+	tcd->CSR = 0;
+	EDMATcdLoad(dmaBASE, handle->timestampChannel, tcd);
+}
+
+/*
+ * Rx trigger channel -> overrun log, when it is enabled.
+ */
+static void UpdateTriggerLinks(spi3dma_handle_t *handle)
+{
+	if(handle->overrunFlag)
+		handle->triggerRxImage.CSR = DMA_CSR_MAJORLINKCH(handle->overrunChannel) | DMA_CSR_MAJORELINK_MASK;
+	else
+		handle->triggerRxImage.CSR = 0;
+}
+
+/*
+ * CSR bits of the last Rx TCD of a frame that start the timestamp channel.
+ */
+static uint16_t TimestampLink(spi3dma_handle_t *handle)
+{
+	if(!handle->timestampFlag)
+		return 0;
+	return DMA_CSR_MAJORLINKCH(handle->timestampChannel) | DMA_CSR_MAJORELINK_MASK;
+}
+
+/*
+ * Word mode Rx: frameLength/4 words straight from RDR, then the tail bytes from
+ * RDR+3 like the byte mode does.
+ */
+static void ConfigRxWordTCD(spi3dma_handle_t *handle, DMA_Type *dmaBASE, uint8_t *ptrRxBuffer, uint32_t frameLength)
+{
+	edma_tcd_t *rxTCD = &handle->rxSegmentTCD[0];
+	uint32_t words = frameLength / 4;
+	uint32_t tail = frameLength & 3;
+
+	EDMATcdReset(rxTCD);
+	rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR); // whole 32 bit Rx register
+	rxTCD->SOFF = 0;
+	rxTCD->DADDR = (uint32_t)ptrRxBuffer;
+	rxTCD->DOFF = 4;
+	rxTCD->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2); // transfer size of 32 bits (010b => 32-bit)
+	rxTCD->NBYTES = 4;
+	rxTCD->CITER = words;
+	rxTCD->BITER = words;
+	if(!tail)
+	{
+		rxTCD->DLAST_SGA = -(int32_t)frameLength;
+		rxTCD->CSR = DMA_CSR_DREQ_MASK | DMA_CSR_INTMAJOR_MASK | TimestampLink(handle);
+	}
+	else
+	{
+		rxTCD->DLAST_SGA = (uint32_t)&handle->rxSegmentTCD[1];
+		rxTCD->CSR = DMA_CSR_ESG_MASK;
+
+		rxTCD = &handle->rxSegmentTCD[1];
+		EDMATcdReset(rxTCD);
+		rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR)+3;
+		rxTCD->SOFF = 0;
+		rxTCD->DADDR = (uint32_t)(ptrRxBuffer + (words * 4));
+		rxTCD->DOFF = 1;
+		rxTCD->ATTR = 0;
+		rxTCD->NBYTES = 1;
+		rxTCD->CITER = tail;
+		rxTCD->BITER = tail;
+		rxTCD->DLAST_SGA = (uint32_t)&handle->rxSegmentTCD[0];
+		rxTCD->CSR = DMA_CSR_ESG_MASK | DMA_CSR_DREQ_MASK | DMA_CSR_INTMAJOR_MASK | TimestampLink(handle);
+	}
+	EDMATcdLoad(dmaBASE, handle->rxChannel, &handle->rxSegmentTCD[0]);
+}
+
+/*
+ * Word mode Tx: frameLength/4 words into TDR.  With a tail the chain goes on with
+ * TCR FRAMESZ 7, the tail bytes into TDR+3 and TCR FRAMESZ 31 again for the next frame.
+ */
+static void ConfigTxWordTCD(spi3dma_handle_t *handle, DMA_Type *dmaBASE, uint8_t *ptrTxBuffer, uint32_t frameLength)
+{
+	LPSPI_Type *spiBASE = handle->spiBASE;
+	edma_tcd_t *txTCD = &handle->txSegmentTCD[0];
+	uint32_t words = frameLength / 4;
+	uint32_t tail = frameLength & 3;
+
+	EDMATcdReset(txTCD);
+	txTCD->SADDR = (uint32_t)ptrTxBuffer;
+	txTCD->SOFF = 4;
+	txTCD->DADDR = (uint32_t)&(spiBASE->TDR); // whole 32 bit Tx register
+	txTCD->DOFF = 0;
+	txTCD->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2); // transfer size of 32 bits (010b => 32-bit)
+	txTCD->NBYTES = 4;
+	txTCD->CITER = words;
+	txTCD->BITER = words;
+	if(!tail)
+	{
+		txTCD->SLAST = -(int32_t)frameLength;
+		txTCD->DLAST_SGA = 0;
+		txTCD->CSR = DMA_CSR_DREQ_MASK;
+		EDMATcdLoad(dmaBASE, handle->txChannel, &handle->txSegmentTCD[0]);
+		return;
+	}
+	txTCD->SLAST = 0;
+	txTCD->DLAST_SGA = (uint32_t)&handle->txSegmentTCD[1];
+	txTCD->CSR = DMA_CSR_ESG_MASK;
+
+	// TCR goes through the Tx FIFO, so it takes effect right after the last word
+	txTCD = &handle->txSegmentTCD[1];
+	EDMATcdReset(txTCD);
+	txTCD->SADDR = (uint32_t)&handle->tcrByteFrame;
+	txTCD->SOFF = 0;
+	txTCD->DADDR = (uint32_t)&(spiBASE->TCR);
+	txTCD->DOFF = 0;
+	txTCD->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2);
+	txTCD->NBYTES = 4;
+	txTCD->CITER = 1;
+	txTCD->BITER = 1;
+	txTCD->DLAST_SGA = (uint32_t)&handle->txSegmentTCD[2];
+	txTCD->CSR = DMA_CSR_ESG_MASK;
+
+	txTCD = &handle->txSegmentTCD[2];
+	EDMATcdReset(txTCD);
+	txTCD->SADDR = (uint32_t)(ptrTxBuffer + (words * 4));
+	txTCD->SOFF = 1;
+	txTCD->DADDR = (uint32_t)&(spiBASE->TDR) + 3;
+	txTCD->DOFF = 0;
+	txTCD->ATTR = 0;
+	txTCD->NBYTES = 1;
+	txTCD->CITER = tail;
+	txTCD->BITER = tail;
+	txTCD->DLAST_SGA = (uint32_t)&handle->txSegmentTCD[3];
+	txTCD->CSR = DMA_CSR_ESG_MASK;
+
+	txTCD = &handle->txSegmentTCD[3];
+	EDMATcdReset(txTCD);
+	txTCD->SADDR = (uint32_t)&handle->tcrWordFrame;
+	txTCD->SOFF = 0;
+	txTCD->DADDR = (uint32_t)&(spiBASE->TCR);
+	txTCD->DOFF = 0;
+	txTCD->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2);
+	txTCD->NBYTES = 4;
+	txTCD->CITER = 1;
+	txTCD->BITER = 1;
+	txTCD->DLAST_SGA = (uint32_t)&handle->txSegmentTCD[0];
+	txTCD->CSR = DMA_CSR_ESG_MASK | DMA_CSR_DREQ_MASK;
+
+	EDMATcdLoad(dmaBASE, handle->txChannel, &handle->txSegmentTCD[0]);
+}
+
+/*
+ * Configure the Rx channel for a frame of frameLength bytes.  A frame that fits
+ * one major loop (15 bit CITER) is written straight into the channel TCD, longer
+ * frames are split into scatter-gather segments, the last one reloading the first
+ * so the next trigger starts again at the beginning of the buffer.
+ */
+static void ConfigRxTCD(spi3dma_handle_t *handle, DMA_Type *dmaBASE, uint8_t *ptrRxBuffer, uint32_t frameLength)
+{
+	edma_tcd_t *rxTCD;
+	uint32_t segments = (frameLength + SPI3_MAX_CITER - 1) / SPI3_MAX_CITER;
+	uint32_t idx;
+
+	if(handle->timestampFlag)
+		ConfigTimestampTCD(handle, dmaBASE); // keep the timestamp index in step with the Rx slots
+
+	if(handle->rxStreamBuffer)
+	{
+		// stream mode, ptrRxBuffer is ignored and the frames pack into the modulo buffer
+		rxTCD = &handle->rxSegmentTCD[0];
+		EDMATcdReset(rxTCD);
+		rxTCD->SOFF = 0;
+		rxTCD->DADDR = (uint32_t)handle->rxStreamBuffer;
+		if(handle->wordModeFlag)
+		{
+			rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR);
+			rxTCD->DOFF = 4;
+			rxTCD->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2) | DMA_ATTR_DMOD(handle->rxStreamLog2); // 32-bit
+			rxTCD->NBYTES = 4;
+			rxTCD->CITER = frameLength / 4;
+			rxTCD->BITER = frameLength / 4;
+		}
+		else
+		{
+			rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR)+3;
+			rxTCD->DOFF = 1;
+			rxTCD->ATTR = DMA_ATTR_DMOD(handle->rxStreamLog2);
+			rxTCD->NBYTES = 1;
+			rxTCD->CITER = frameLength;
+			rxTCD->BITER = frameLength;
+		}
+		rxTCD->DLAST_SGA = 0; // next frame goes right behind this one, DMOD does the wrap
+		rxTCD->CSR = DMA_CSR_DREQ_MASK | TimestampLink(handle); // no interrupt, the consumer follows DADDR
+		EDMATcdLoad(dmaBASE, handle->rxChannel, rxTCD);
+		return;
+	}
+
+	if(handle->rxRingSlots)
+	{
+		// ring mode, ptrRxBuffer is ignored and every frame goes into its own slot
+		for(idx = 0; idx < handle->rxRingSlots; idx++)
+		{
+			rxTCD = &handle->rxRingTCD[idx];
+			EDMATcdReset(rxTCD);
+			rxTCD->SOFF = 0;
+			rxTCD->DADDR = (uint32_t)(handle->rxRingBuffer + (idx * frameLength)); // this frame's slot
+			if(handle->wordModeFlag)
+			{
+				rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR);
+				rxTCD->DOFF = 4;
+				rxTCD->ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2); // 32-bit
+				rxTCD->NBYTES = 4;
+				rxTCD->CITER = frameLength / 4;
+				rxTCD->BITER = frameLength / 4;
+			}
+			else
+			{
+				rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR)+3; // our source address is the LPSPI Rx register
+				rxTCD->DOFF = 1;
+				rxTCD->ATTR = 0;
+				rxTCD->NBYTES = 1;
+				rxTCD->CITER = frameLength;
+				rxTCD->BITER = frameLength;
+			}
+			rxTCD->DLAST_SGA = (uint32_t)&handle->rxRingTCD[(idx + 1) % handle->rxRingSlots]; // next slot
+			rxTCD->CSR = DMA_CSR_ESG_MASK | DMA_CSR_DREQ_MASK | TimestampLink(handle);
+			if(((idx + 1) % handle->rxIrqBatch) == 0)
+				rxTCD->CSR |= DMA_CSR_INTMAJOR_MASK; // last slot of a batch
+		}
+		EDMATcdLoad(dmaBASE, handle->rxChannel, &handle->rxRingTCD[0]);
+		handle->rxFrameCount = 0;
+		handle->rxFlushCount = 0;
+		handle->rxReadCount = 0;
+		handle->rxReleaseCount = 0;
+		handle->rxPausedFlag = 0;
+		return;
+	}
+
+	if(handle->wordModeFlag && (frameLength >= 4))
+	{
+		ConfigRxWordTCD(handle, dmaBASE, ptrRxBuffer, frameLength);
+		return;
+	}
+
+	for(idx = 0; idx < segments; idx++)
+	{
+		uint32_t offset = idx * SPI3_MAX_CITER;
+		uint32_t count = frameLength - offset;
+
+		if(count > SPI3_MAX_CITER)
+			count = SPI3_MAX_CITER;
+
+		rxTCD = &handle->rxSegmentTCD[idx];
+		EDMATcdReset(rxTCD);
+		rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR)+3; // our source address is the LPSPI Rx register
+		rxTCD->SOFF = 0;            // source address offset set to zero as it does not change
+		rxTCD->DADDR = (uint32_t)(ptrRxBuffer + offset); // this segment's part of the buffer
+		rxTCD->DOFF = 1;            // each destination address write will increment by 1 byte
+		rxTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
+		rxTCD->NBYTES = 1;          // number of bytes in each minor loop transfer.
+		rxTCD->CITER = count;       // number of bytes(loops) in this segment
+		rxTCD->BITER = count;
+		if(segments == 1)
+		{
+			// subtract destination from beginning, stop and raise the frame IRQ
+			rxTCD->DLAST_SGA = -(int32_t)frameLength;
+			rxTCD->CSR = DMA_CSR_DREQ_MASK | DMA_CSR_INTMAJOR_MASK | TimestampLink(handle);
+		}
+		else if(idx == (segments - 1))
+		{
+			// back to the first segment, stop and raise the frame IRQ
+			rxTCD->DLAST_SGA = (uint32_t)&handle->rxSegmentTCD[0];
+			rxTCD->CSR = DMA_CSR_ESG_MASK | DMA_CSR_DREQ_MASK | DMA_CSR_INTMAJOR_MASK | TimestampLink(handle);
+		}
+		else
+		{
+			// keep the request enabled and go on with the next segment
+			rxTCD->DLAST_SGA = (uint32_t)&handle->rxSegmentTCD[idx + 1];
+			rxTCD->CSR = DMA_CSR_ESG_MASK;
+		}
+	}
+	EDMATcdLoad(dmaBASE, handle->rxChannel, &handle->rxSegmentTCD[0]);
+}
+
+/*
+ * Tx counterpart of ConfigRxTCD()
+ */
+static void ConfigTxTCD(spi3dma_handle_t *handle, DMA_Type *dmaBASE, uint8_t *ptrTxBuffer, uint32_t frameLength)
+{
+	edma_tcd_t *txTCD;
+	uint32_t segments = (frameLength + SPI3_MAX_CITER - 1) / SPI3_MAX_CITER;
+	uint32_t idx;
+
+	if(handle->wordModeFlag && (frameLength >= 4))
+	{
+		ConfigTxWordTCD(handle, dmaBASE, ptrTxBuffer, frameLength);
+		return;
+	}
+
+	for(idx = 0; idx < segments; idx++)
+	{
+		uint32_t offset = idx * SPI3_MAX_CITER;
+		uint32_t count = frameLength - offset;
+
+		if(count > SPI3_MAX_CITER)
+			count = SPI3_MAX_CITER;
+
+		txTCD = &handle->txSegmentTCD[idx];
+		EDMATcdReset(txTCD);
+		txTCD->SADDR = (uint32_t)(ptrTxBuffer + offset); // this segment's part of the buffer
+		txTCD->SOFF = 1;            // source address offset set to 1 to increment by one byte per transfer
+		txTCD->SLAST = 0;
+		txTCD->DADDR = (uint32_t)&(handle->spiBASE->TDR) + 3; // where the TX data will be placed LPSPI Tx Register
+		txTCD->DOFF = 0;            // each destination address is a hardware registers, so we will not increment it
+		txTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
+		txTCD->NBYTES = 1;          // number of bytes in each minor loop transfer.
+		txTCD->CITER = count;       // number of bytes(loops) in this segment
+		txTCD->BITER = count;
+		if(segments == 1)
+		{
+			// subtract source from beginning, stop after one frame, the next trigger sets ERQ again
+			txTCD->SLAST = -(int32_t)frameLength;
+			txTCD->DLAST_SGA = 0;
+			txTCD->CSR = DMA_CSR_DREQ_MASK;
+		}
+		else if(idx == (segments - 1))
+		{
+			txTCD->DLAST_SGA = (uint32_t)&handle->txSegmentTCD[0];
+			txTCD->CSR = DMA_CSR_ESG_MASK | DMA_CSR_DREQ_MASK;
+		}
+		else
+		{
+			txTCD->DLAST_SGA = (uint32_t)&handle->txSegmentTCD[idx + 1];
+			txTCD->CSR = DMA_CSR_ESG_MASK;
+		}
+	}
+	EDMATcdLoad(dmaBASE, handle->txChannel, &handle->txSegmentTCD[0]);
+}
+
+/*
+ * Reprogram a running channel pair for currentFrame, the trigger is held off
+ * while the TCDs and the LPSPI frame size are swapped.  A frame the trigger
+ * chain already started runs out first.
+ */
+static void ReloadSPI3Frame(spi3dma_handle_t *handle, DMA_Type *dmaBASE)
+{
+	spi3_frame_t *frame = &handle->currentFrame;
+
+	HoldTrigger(handle);
+	WaitFrameIdle(handle, dmaBASE);
+
+	handle->spiBASE->TCR = (handle->wordModeFlag && (frame->length >= 4)) ? handle->tcrWordFrame : handle->tcrByteFrame;
+	ConfigRxTCD(handle, dmaBASE, frame->rxBuffer, frame->length);
+	ConfigTxTCD(handle, dmaBASE, frame->txBuffer, frame->length);
+
+	ReleaseTrigger(handle);
+}
+
+/*
+ * Capture into a ring of slots frames of slotCount * frame length bytes instead of
+ * the single rxBuffer.  slotCount 0 goes back to the single buffer.
+ */
+int32_t SetSPI3RxRing(spi3dma_handle_t *handle, uint8_t *ringBuffer, uint32_t slotCount)
+{
+	if(slotCount > SPI3_RX_RING_MAX_SLOTS)
+		return -1;
+	if(slotCount && handle->rxStreamBuffer)
+		return -1; // stream mode owns the Rx channel
+	if(CheckFrameLength(handle->currentFrame.length, slotCount, handle->wordModeFlag))
+		return -1;
+	if(CheckWordBuffers(&handle->currentFrame, slotCount ? ringBuffer : 0, handle->wordModeFlag))
+		return -1;
+	if((handle->rxIrqBatch > 1) && (!slotCount || (slotCount % handle->rxIrqBatch)))
+		return -1; // batches must not straddle the ring wrap
+	if(slotCount && (slotCount < (2 * handle->rxIrqBatch)))
+		return -1; // one batch in flight plus one to pause in front of
+
+	handle->rxRingBuffer = ringBuffer;
+	handle->rxRingSlots = slotCount;
+
+	if(!handle->firstTimeFlag)
+	{
+		HoldTrigger(handle);
+		WaitFrameIdle(handle, DMA0);
+		ConfigRxTCD(handle, DMA0, handle->currentFrame.rxBuffer, handle->currentFrame.length);
+		ReleaseTrigger(handle);
+	}
+	return 0;
+}
+
+/*
+ * Capture every frame back to back into streamBuffer, 2^sizeLog2 bytes aligned to
+ * its size (e.g. 64 KiB in OCRAM with sizeLog2 16), instead of the single rxBuffer
+ * or the ring.  The Rx TCD is loaded once and never touched again per frame.  The
+ * ring has to be off, in word mode the frame length has to be a multiple of 4.
+ * streamBuffer 0 goes back to the single buffer.
+ */
+int32_t SetSPI3RxStream(spi3dma_handle_t *handle, uint8_t *streamBuffer, uint32_t sizeLog2)
+{
+	if(streamBuffer)
+	{
+		if(handle->rxRingSlots)
+			return -1;
+		if((sizeLog2 < SPI3_RX_STREAM_MIN_LOG2) || (sizeLog2 > SPI3_RX_STREAM_MAX_LOG2))
+			return -1;
+		if((uint32_t)streamBuffer & ((1U << sizeLog2) - 1))
+			return -1; // DMOD wraps on the address bits, the buffer has to be aligned to its size
+		if(CheckFrameLength(handle->currentFrame.length, 1, handle->wordModeFlag))
+			return -1;
+	}
+
+	handle->rxStreamBuffer = streamBuffer;
+	handle->rxStreamLog2 = sizeLog2;
+
+	if(!handle->firstTimeFlag)
+	{
+		HoldTrigger(handle);
+		WaitFrameIdle(handle, DMA0);
+		ConfigRxTCD(handle, DMA0, handle->currentFrame.rxBuffer, handle->currentFrame.length);
+		ReleaseTrigger(handle);
+	}
+	return 0;
+}
+
+/*
+ * Offset in the stream buffer the next Rx byte goes to, read from the live DADDR.
+ * Everything from the consumer's own read offset up to it has been written, the
+ * consumer has to keep up to less than one buffer lap and invalidate the D-cache
+ * over what it reads when the buffer is cacheable.
+ */
+uint32_t GetSPI3RxStreamWriteIndex(spi3dma_handle_t *handle)
+{
+	DMA_Type *dmaBASE = DMA0;
+
+	if(!handle->rxStreamBuffer)
+		return 0;
+	return ((uint32_t)dmaBASE->TCD[handle->rxChannel].DADDR - (uint32_t)handle->rxStreamBuffer) & ((1U << handle->rxStreamLog2) - 1);
+}
+
+/*
+ * Number of frames completed since the ring was set up.  Single writer (DMA_irq)
+ * and a 32 bit aligned read, so no interrupt lock is needed on the consumer side.
+ */
+uint32_t GetSPI3RxProducerIndex(spi3dma_handle_t *handle)
+{
+	uint32_t irqCount = handle->rxFrameCount;
+	uint32_t flushCount = handle->rxFlushCount;
+
+	// a flush can run ahead of the last batch interrupt, take whichever is newer
+	if((int32_t)(flushCount - irqCount) > 0)
+		return flushCount;
+	return irqCount;
+}
+
+/*
+ * Raise the Rx interrupt once every batchFrames ring slots instead of every frame.
+ * The ring has to be enabled and its slot count a multiple of batchFrames and at
+ * least two batches.
+ */
+int32_t SetSPI3RxBatch(spi3dma_handle_t *handle, uint32_t batchFrames)
+{
+	if(batchFrames == 0)
+		return -1;
+	if((batchFrames > 1) && (!handle->rxRingSlots || (handle->rxRingSlots % batchFrames)))
+		return -1;
+	if(handle->rxRingSlots && (handle->rxRingSlots < (2 * batchFrames)))
+		return -1;
+
+	handle->rxIrqBatch = batchFrames;
+
+	if(!handle->firstTimeFlag)
+	{
+		HoldTrigger(handle);
+		WaitFrameIdle(handle, DMA0);
+		ConfigRxTCD(handle, DMA0, handle->currentFrame.rxBuffer, handle->currentFrame.length);
+		ReleaseTrigger(handle);
+	}
+	return 0;
+}
+
+/*
+ * Drop the D-cache lines covering a completed Rx range so the CPU reads what the
+ * eDMA wrote.  The range is widened to whole lines, the buffer must not share its
+ * first or last line with CPU written data (AllocSPI3Buffer() pads to lines).
+ */
+SPI3_ITCM_CODE static void InvalidateRxLines(const uint8_t *buffer, uint32_t length)
+{
+	uint32_t addr = (uint32_t)buffer & ~(SCB_DCACHE_LINE_SIZE - 1);
+	uint32_t end = (uint32_t)buffer + length;
+
+	SPI3_DSB();
+	for(; addr < end; addr += SCB_DCACHE_LINE_SIZE)
+	{
+		SCB_DCIMVAC_REG = addr;
+	}
+	SPI3_DSB();
+}
+
+/*
+ * Publish the frames of a partial batch, to be called when no batch interrupt
+ * came in for a while (trigger stopped or slowed down).  The slot the Rx channel
+ * has loaded is the one being filled, every slot between the last batch
+ * interrupt and it is complete.  Returns the new producer index.
+ */
+uint32_t FlushSPI3RxBatch(spi3dma_handle_t *handle)
+{
+	DMA_Type *dmaBASE = DMA0;
+	uint32_t slots = handle->rxRingSlots;
+	uint32_t irqCount;
+	uint32_t loadedSlot;
+	uint32_t pending;
+	uint32_t published;
+
+	if(!slots || handle->firstTimeFlag)
+		return GetSPI3RxProducerIndex(handle);
+
+	irqCount = handle->rxFrameCount;
+	// the loaded TCD links to the slot after it
+	loadedSlot = ((uint32_t)dmaBASE->TCD[handle->rxChannel].DLAST_SGA - (uint32_t)&handle->rxRingTCD[0]) / sizeof(edma_tcd_t);
+	loadedSlot = (loadedSlot + slots - 1) % slots;
+	pending = (loadedSlot + slots - (irqCount % slots)) % slots;
+	if(pending < handle->rxIrqBatch)
+	{
+		published = GetSPI3RxProducerIndex(handle);
+		// inside one batch, so the slots not yet published are one range
+		if(handle->rxInvalidateFlag && ((int32_t)(irqCount + pending - published) > 0))
+			InvalidateRxLines(handle->rxRingBuffer + ((published % slots) * handle->currentFrame.length),
+					(irqCount + pending - published) * handle->currentFrame.length);
+		handle->rxFlushCount = irqCount + pending; // otherwise the batch interrupt is on its way
+	}
+
+	return GetSPI3RxProducerIndex(handle);
+}
+
+/*
+ * Hand out the oldest unread ring slot, no copy.  Returns -1 when the queue is empty.
+ * The slot stays valid until it is given back with ReleaseSPI3RxFrame().
+ */
+int32_t GetSPI3RxFrame(spi3dma_handle_t *handle, spi3_rx_frame_t *frame)
+{
+	uint32_t producer;
+	uint32_t slot;
 
-	// start GPIO2 clocks
-	// refer to Ref Manual, page 1144&1145, section 14.7.21
-	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 31..30
-	CCM->CCGR1 |= 0xC0000000;
+	if(!handle->rxRingSlots)
+		return -1;
 
-	// start GPIO3 clocks
-	// refer to Ref Manual, page 1147&1148, section 14.7.23
-	// CCM Clock Gating Register 2 (CCM_CCGR1) bits 27..26
-	CCM->CCGR2 |= 0x03000000;
+	producer = GetSPI3RxProducerIndex(handle);
+	if(producer == handle->rxReadCount)
+		return -1;
+	SPI3_DMB(); // producer index before the slot data
 
-	// start XBAR1 clocks
-	// refer to Ref Manual, page 1147&1148, section 14.7.23
-	// CCM Clock Gating Register 2 (CCM_CCGR2) bits 23..22
-	CCM->CCGR2 |= 0x00C00000;
+	slot = handle->rxReadCount % handle->rxRingSlots;
+	frame->sequence = handle->rxReadCount;
+	frame->length = handle->currentFrame.length;
+	frame->data = handle->rxRingBuffer + (slot * handle->currentFrame.length);
+	frame->timestamp = handle->rxTimestamp[slot];
+	handle->rxReadCount++;
+	return 0;
+}
 
-	// start SPI3 clocks
+/*
+ * Give the oldest handed out slot back to the ring, frames are released in the
+ * order GetSPI3RxFrame() returned them.
+ */
+SPI3_ITCM_CODE int32_t ReleaseSPI3RxFrame(spi3dma_handle_t *handle, const spi3_rx_frame_t *frame)
+{
+	uint32_t irqMask;
+	uint32_t irqEnabled;
+
+	if(frame->sequence != handle->rxReleaseCount)
+		return -1;
+
+	SPI3_DMB(); // done reading the slot before it is reused
+	handle->rxReleaseCount = handle->rxReleaseCount + 1;
+
+	// a DMA_irq() after this reads the new release index and only pauses when it has to
+	if(!handle->rxPausedFlag)
+		return 0;
+
+	// a batch completing between the test and the SERQ would have its CERQ undone,
+	// hold this handle's vector off in the NVIC, a batch that completed meanwhile is taken after
+	irqMask = SPI3_DMA_IRQ_MASK(handle->rxChannel);
+	irqEnabled = NVIC_ISER0_REG & irqMask;
+	NVIC_ICER0_REG = irqMask;
+	SPI3_DSB();
+	SPI3_ISB();
+	if(handle->rxPausedFlag
+			&& ((handle->rxFrameCount + handle->rxIrqBatch - handle->rxReleaseCount) <= (handle->rxRingSlots - handle->rxIrqBatch)))
+	{
+		handle->rxPausedFlag = 0;
+		if(handle->gpioTriggerFlag)
+			DMA0->SERQ = DMA_SERQ_SERQ(handle->triggerTxChannel);
+	}
+	NVIC_ISER0_REG = irqEnabled;
+	return 0;
+}
+
+/*
+ * Number of times the trigger was held off because the consumer kept all slots.
+ */
+uint32_t GetSPI3RxPauseCount(spi3dma_handle_t *handle)
+{
+	return handle->rxPauseCount;
+}
+
+/*
+ * Start GPT1 free running on PERCLK and link the timestamp channel from the end
+ * of every Rx frame.  Call before RestSPI3Peripheral(), or while running to add it.
+ * GPT1 is shared by all handles and only set up by the first one.
+ */
+void EnableSPI3FrameTimestamp(spi3dma_handle_t *handle)
+{
+	DMA_Type *dmaBASE = DMA0;
+	GPT_Type *gptBASE = GPT1;
+
+	// start GPT1 clocks
 	// refer to Ref Manual, page 1146&1147, section 14.7.22
-	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 5..4
-	CCM->CCGR1 |= 0x00000030;
+	// CCM Clock Gating Register 1 (CCM_CCGR1) bits 23..20
+	CCM->CCGR1 |= 0x00F00000;
+
+	if(!(gptBASE->CR & GPT_CR_EN_MASK))
+	{
+		gptBASE->CR = 0;
+		gptBASE->PR = 0; // count every PERCLK cycle
+		gptBASE->CR = GPT_CR_CLKSRC(1) | GPT_CR_FRR_MASK | GPT_CR_ENMOD_MASK | GPT_CR_DBGEN_MASK | GPT_CR_WAITEN_MASK;
+		gptBASE->CR |= GPT_CR_EN_MASK;
+	}
+
+	handle->timestampFlag = 1;
+
+	if(!handle->firstTimeFlag)
+	{
+		HoldTrigger(handle);
+		WaitFrameIdle(handle, dmaBASE);
+		ConfigRxTCD(handle, dmaBASE, handle->currentFrame.rxBuffer, handle->currentFrame.length);
+		ReleaseTrigger(handle);
+	}
 }
 
-void InitSPI3Peripheral()
+/*
+ * GPT1 count latched when the last byte of the frame with this sequence number
+ * was stored, valid once the frame is published and until its slot is reused.
+ */
+uint32_t GetSPI3RxTimestamp(spi3dma_handle_t *handle, uint32_t sequence)
 {
-#define ALT2 (2)
-#define ALT5 (5)
-#define ALT7 (7)
-#define CTL_PAD (0x1088) // SRE 0,DSE 1,SPEED 2,ODE 0,PKE 1,PUE 0, HYS 0
-	// GPIO_AD_B0_03 LPSP3 CS0
-	IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_03] = ALT7;
-	IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_03] = CTL_PAD;
-	// GPIO_AD_B0_00 LPSPI3 CLK
-	IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_00] = ALT7;
-	IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_00] = CTL_PAD;
-	// GPIO_AD_B0_02 LPSPI3 MISO
-	IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_02] = ALT7;
-	IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_02] = CTL_PAD;
-	// GPIO_AD_B1_14 LPSPI3 MOSI
-	IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B1_14] = ALT2;
-	IOMUXC->SW_PAD_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B1_14] = CTL_PAD;
-
-	LPSPI3->CR  = 0;  // disable
-	LPSPI3->CFGR1 = 1; // master mode
-	LPSPI3->CR  = 1;  // enable
-	LPSPI3->CR  = 0x305; // reset Rx FIFO, TX FIFO, debug en, enable
-	LPSPI3->CCR = 0x08082032; // SDK x8, PCS x8, DBT x20 DIV x32
-	LPSPI3->TCR = 0xC0000007; // CPOL 1, CPHA 1, PRE 1, PCS0, LSBF 0, BYSW 0, CONT 0, CONTC 0, RXMSK 0, TXMSK 0, WID 1, FRAME 8
-	LPSPI3->CR  = 0x05; // debug en, enable
-
-}
-
-void TxTest()
+	uint32_t slots = handle->rxRingSlots ? handle->rxRingSlots : 1;
+
+	return handle->rxTimestamp[sequence % slots];
+}
+
+uint32_t GetSPI3RxIrqCycles(spi3dma_handle_t *handle)
 {
-	uint8_t idx;
-	volatile uint32_t readValue;
-#define START ('0')
-#define END ('9'+1)
-	for(idx=START; idx < END; idx++ )
+	return handle->rxIrqCycles;
+}
+
+/*
+ * Log the Rx channel state on every trigger, see triggerCiterLog.  Call after
+ * InitDMAandEDMA(), before RestSPI3Peripheral() or while running.
+ */
+void EnableSPI3OverrunLog(spi3dma_handle_t *handle)
+{
+	DMA_Type *dmaBASE = DMA0;
+	edma_tcd_t *tcd = &handle->overrunTCD;
+	uint32_t idx;
+
+	HoldTrigger(handle);
+
+	for(idx = 0; idx < SPI3_TRIGGER_LOG_SIZE; idx++)
 	{
-		LPSPI3->TDR = idx;
-		while(LPSPI3->RSR & 0x2)
-			;
-		readValue = LPSPI3->RDR;
-		if( readValue != idx)
-			break;
+		handle->triggerCiterLog[idx] = 0;
+	}
+
+	EDMATcdReset(tcd);
+	tcd->SADDR = (uint32_t)&(dmaBASE->TCD[handle->rxChannel].CITER_ELINKNO);
+	tcd->SOFF = 0;
+	tcd->DADDR = (uint32_t)&handle->triggerCiterLog[0];
+	tcd->DOFF = 2;
+	tcd->ATTR = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1) | DMA_ATTR_DMOD(TRIGGER_LOG_DMOD); // 16-bit, wrap in the log
+	tcd->NBYTES = 2;
+	tcd->CITER = 1;
+	tcd->BITER = 1;
+	tcd->SLAST = 0;
+	tcd->DLAST_SGA = 0;
+	handle->overrunFlag = 1;
+	UpdateTriggerLinks(handle);
+	EDMATcdLoad(dmaBASE, handle->overrunChannel, tcd);
+
+	if(!handle->firstTimeFlag)
+	{
+		EDMATcdLoad(dmaBASE, handle->triggerRxChannel, &handle->triggerRxImage);
+		ReleaseTrigger(handle);
 	}
 }
 
-void InitDMAandEDMA()
+/*
+ * Position the overrun log will write next, counts triggers modulo SPI3_TRIGGER_LOG_SIZE.
+ */
+uint32_t GetSPI3TriggerLogIndex(spi3dma_handle_t *handle)
 {
-	// start DMA0 clocks
-	// refer to Ref Manual, page 1151&1152, section 14.7.26
-	// CCM Clock Gating Register 5 (CCM_CCGR5) bits 7..6
-	CCM->CCGR5 |= 0xC0;
+	DMA_Type *dmaBASE = DMA0;
+
+	return ((uint32_t)dmaBASE->TCD[handle->overrunChannel].DADDR - (uint32_t)&handle->triggerCiterLog[0]) / 2;
+}
 
-	// now configure the DMAMUX to the SPI3 RX/TX registers.
-	DMAMUX->CHCFG[LPSPI_MASTER_DMA_RX_CHANNEL] = 0x0;
-	DMAMUX->CHCFG[LPSPI_MASTER_DMA_RX_CHANNEL] = kDmaRequestMuxLPSPI3Rx;  // set SPI3 RX
-	DMAMUX->CHCFG[LPSPI_MASTER_DMA_RX_CHANNEL] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+/*
+ * Number of logged triggers from index first up to, not including, last that
+ * found a frame still in flight.
+ */
+uint32_t CountSPI3Overruns(spi3dma_handle_t *handle, uint32_t first, uint32_t last)
+{
+	uint16_t fullCount = handle->rxRingSlots ? handle->rxRingTCD[0].BITER : handle->rxSegmentTCD[0].BITER;
+	uint32_t overruns = 0;
 
-	DMAMUX->CHCFG[LPSPI_MASTER_DMA_TX_CHANNEL] = 0x0;
-	DMAMUX->CHCFG[LPSPI_MASTER_DMA_TX_CHANNEL] = kDmaRequestMuxLPSPI3Tx;  // set SPI3 TX
-	DMAMUX->CHCFG[LPSPI_MASTER_DMA_TX_CHANNEL] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+	for(; (first % SPI3_TRIGGER_LOG_SIZE) != (last % SPI3_TRIGGER_LOG_SIZE); first++)
+	{
+		if(handle->triggerCiterLog[first % SPI3_TRIGGER_LOG_SIZE] != fullCount)
+			overruns++;
+	}
+	return overruns;
+}
 
-	DMAMUX->CHCFG[TRIGGER_DMA_TX_CHANNEL] = 0x0;
-	DMAMUX->CHCFG[TRIGGER_DMA_TX_CHANNEL] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+/*
+ * SCK = LPSPI_CLK_ROOT / (sckDivider + 2), the module has to be disabled while
+ * CCR changes so the trigger is held off around it.  MBF alone is no sign of
+ * the frame end, it drops between words the Tx DMA has not refilled yet and
+ * before the trigger chain wrote TCR.
+ */
+void SetSPI3SckDivider(spi3dma_handle_t *handle, uint8_t sckDivider)
+{
+	LPSPI_Type *spiBASE = handle->spiBASE;
 
-	DMAMUX->CHCFG[TRIGGER_DMA_RX_CHANNEL] = 0x0;
-	DMAMUX->CHCFG[TRIGGER_DMA_RX_CHANNEL] |= DMAMUX_CHCFG_ENBL_MASK; // enable
+	HoldTrigger(handle);
+	WaitFrameIdle(handle, DMA0);
 
+	while(spiBASE->SR & LPSPI_SR_MBF_MASK)
+	{
+		// the last word leaves the shifter
+	}
+	spiBASE->CR &= ~LPSPI_CR_MEN_MASK;
+	spiBASE->CCR = (spiBASE->CCR & ~LPSPI_CCR_SCKDIV_MASK) | LPSPI_CCR_SCKDIV(sckDivider);
+	spiBASE->CR |= LPSPI_CR_MEN_MASK;
 
+	ReleaseTrigger(handle);
 }
 
-#define REMOVE_CONT (1)
-static uint8_t firstTimeFlag = 1;
-static uint8_t volatile passRxSetupFlag = 0;
-static uint8_t volatile passTxSetupFlag = 0;
-static uint8_t volatile combineDMATriggerFlag = 1;
-static uint8_t volatile triggerTxERQ = 1;
-static uint8_t volatile triggerRxERQ = 1;
+/*
+ * eDMA arbitration.  DMA0 runs fixed priority inside each group of 16 channels and
+ * between the two groups, CHPRI has to stay unique inside a group or the eDMA flags
+ * a priority error on the next request.  Every channel gets a rank: handles with
+ * the profile on above the untouched channels above the bulk channels.  Inside a
+ * rank the higher channel number wins, which is the reset order.
+ */
+#define DMA_GROUP_CHANNELS (16)
+#define DMA_RANK_BULK      (0)
+#define DMA_RANK_DEFAULT   (1)
+#define DMA_RANK_COUNT     (8)
 
-void RestSPI3Peripheral(uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
+// rank of a profiled handle's channels by offset: the trigger chain starts the frame
+// so it goes first, the one beat log and timestamp copies next, Rx before Tx keeps the
+// Rx FIFO drained
+static const uint8_t streamRank[] =
+{
+	3, // LPSPI_MASTER_DMA_RX_CHANNEL
+	2, // LPSPI_MASTER_DMA_TX_CHANNEL
+	7, // TRIGGER_DMA_TX_CHANNEL
+	6, // TRIGGER_DMA_RX_CHANNEL
+	4, // TIMESTAMP_DMA_CHANNEL
+	5, // OVERRUN_DMA_CHANNEL
+};
+
+static uint32_t dmaBulkMask = 0; // channels set up by SetSPI3BulkChannel()
+
+static uint32_t DmaChannelRank(uint32_t channel)
+{
+	uint32_t idx;
+	spi3dma_handle_t *handle;
+
+	if(dmaBulkMask & (1U << channel))
+		return DMA_RANK_BULK;
+
+	for(idx = 0; idx < SPI3_INSTANCE_COUNT; idx++)
+	{
+		handle = &spi3Handle[idx];
+		if(handle->instance && handle->priorityFlag
+				&& (channel >= handle->instance->firstChannel)
+				&& (channel < (handle->instance->firstChannel + sizeof(streamRank))))
+			return streamRank[channel - handle->instance->firstChannel];
+	}
+	return DMA_RANK_DEFAULT;
+}
+
+/*
+ * Write DCHPRI of all 32 channels and the group priorities from the current ranks.
+ * The eDMA is halted around it so no channel arbitrates with half written priorities.
+ * Bulk channels may be preempted (ECP) and never preempt (DPA), everything else
+ * keeps the reset ECP 0 / DPA 0, so a ranked channel that becomes ready preempts a
+ * bulk channel between two of its read/write pairs instead of waiting for its
+ * minor loop to end.
+ */
+static void ApplyDmaPriority(void)
+{
+	DMA_Type *dmaBASE = DMA0;
+	volatile uint8_t *dchpri = &dmaBASE->DCHPRI3; // byte swapped, channel n at index n ^ 3
+	uint8_t streamGroup[2] = { 0, 0 };
+	uint32_t group;
+	uint32_t rank;
+	uint32_t channel;
+	uint32_t priority;
+	uint32_t cr;
+
+	dmaBASE->CR |= DMA_CR_HALT_MASK;
+	while(dmaBASE->CR & DMA_CR_ACTIVE_MASK)
+	{
+		// let the channel being serviced finish its read/write
+	}
+
+	for(group = 0; group < 2; group++)
+	{
+		priority = DMA_GROUP_CHANNELS;
+		for(rank = DMA_RANK_COUNT; rank-- > 0; )
+		{
+			for(channel = (group + 1) * DMA_GROUP_CHANNELS; channel-- > (group * DMA_GROUP_CHANNELS); )
+			{
+				if(DmaChannelRank(channel) != rank)
+					continue;
+				priority--;
+				dchpri[channel ^ 3] = DMA_DCHPRI0_CHPRI(priority)
+						| ((rank == DMA_RANK_BULK) ? (DMA_DCHPRI0_ECP_MASK | DMA_DCHPRI0_DPA_MASK) : 0);
+				if(rank > DMA_RANK_DEFAULT)
+					streamGroup[group] = 1;
+			}
+		}
+	}
+
+	// fixed channel and group arbitration, preemption does not work with round robin.
+	// group 1 wins at reset, hand it to group 0 when only group 0 has ranked channels
+	cr = dmaBASE->CR & ~(DMA_CR_ERCA_MASK | DMA_CR_ERGA_MASK | DMA_CR_GRP0PRI_MASK | DMA_CR_GRP1PRI_MASK | DMA_CR_HALT_MASK);
+	if(streamGroup[0] && !streamGroup[1])
+		cr |= DMA_CR_GRP0PRI(1) | DMA_CR_GRP1PRI(0);
+	else
+		cr |= DMA_CR_GRP0PRI(0) | DMA_CR_GRP1PRI(1);
+	dmaBASE->CR = cr;
+}
+
+/*
+ * Rank the six eDMA channels of the handle above every other channel of their
+ * group, with the group itself ahead when the other group has no ranked handle.
+ * 0 puts them back to the reset order.
+ */
+void SetSPI3PriorityProfile(spi3dma_handle_t *handle, uint8_t enable)
+{
+	handle->priorityFlag = enable;
+	ApplyDmaPriority();
+}
+
+/*
+ * Move a channel that is not part of a handle (LPUART DMA, memory copies) to the
+ * bottom of its group and let any other channel preempt it.  0 puts it back to
+ * the reset order.
+ */
+int32_t SetSPI3BulkChannel(uint32_t channel, uint8_t enable)
+{
+	if(channel >= (2 * DMA_GROUP_CHANNELS))
+		return -1;
+
+	if(enable)
+		dmaBulkMask |= (1U << channel);
+	else
+		dmaBulkMask &= ~(1U << channel);
+	ApplyDmaPriority();
+	return 0;
+}
+
+uint8_t *GetSPI3RxSlot(spi3dma_handle_t *handle, uint32_t index)
+{
+	if(!handle->rxRingSlots)
+		return handle->currentFrame.rxBuffer;
+	return handle->rxRingBuffer + ((index % handle->rxRingSlots) * handle->currentFrame.length);
+}
+
+int32_t SetSPI3Frame(spi3dma_handle_t *handle, const spi3_frame_t *frame)
+{
+	if(CheckFrameLength(frame->length, handle->rxRingSlots || handle->rxStreamBuffer, handle->wordModeFlag))
+		return -1;
+	if(CheckWordBuffers(frame, handle->rxRingSlots ? handle->rxRingBuffer : 0, handle->wordModeFlag))
+		return -1;
+
+	handle->currentFrame = *frame;
+
+	if(!handle->firstTimeFlag)
+		ReloadSPI3Frame(handle, DMA0);
+	return 0;
+}
+
+/*
+ * Select the frame size used for every DMA request and LPSPI data word, 1 for
+ * 32 bit words, 0 for bytes.  Frames shorter than 4 bytes always go as bytes.
+ * Words need the Tx, Rx and ring buffers 4 byte aligned.
+ */
+int32_t SetSPI3WordMode(spi3dma_handle_t *handle, uint8_t enable)
+{
+	if(CheckFrameLength(handle->currentFrame.length, handle->rxRingSlots || handle->rxStreamBuffer, enable))
+		return -1;
+	if(CheckWordBuffers(&handle->currentFrame, handle->rxRingSlots ? handle->rxRingBuffer : 0, enable))
+		return -1;
+
+	handle->wordModeFlag = enable;
+
+	if(!handle->firstTimeFlag)
+		ReloadSPI3Frame(handle, DMA0);
+	return 0;
+}
+
+SPI3_ITCM_CODE void RestSPI3Peripheral(spi3dma_handle_t *handle, uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
 {
-	edma_tcd_t *rxTCD;
-	edma_tcd_t *txTCD;
-	edma_tcd_t *triggerTxTCD;
-	edma_tcd_t *triggerRxTCD;
 	DMA_Type *dmaBASE = DMA0;
-	LPSPI_Type *spiBASE = LPSPI3;
+	LPSPI_Type *spiBASE = handle->spiBASE;
+#ifndef REMOVE_CONT
+	edma_tcd_t *txTCD;
 	static uint32_t trasmitCommand;
-	static uint8_t triggerTxDMA = 0x2; // bit setting to enable Request Register for Tx DMA
-	static uint8_t triggerRxDMA = 0x1; // bit setting to enable Request Register for Rx DMA
 	static volatile edma_tcd_t softwareTCD_pcsContinuous; // store in RAM
+#endif
 
-	if(firstTimeFlag)
+	if(handle->firstTimeFlag)
 	{
-		firstTimeFlag = 0;
+		handle->firstTimeFlag = 0;
 
 
-		spiBASE->CR &= ~LPSPI_CR_MEN_MASK ; // disable LPSPI3
+		spiBASE->CR &= ~LPSPI_CR_MEN_MASK ; // disable LPSPI
 		spiBASE->CR |= (1<<FLUSH_TX_FIFO_SHIFT) | (1<<FLUSH_RX_FIFO_SHIFT); // flush FIFOs
 		spiBASE->SR = kLPSPI_AllStatusFlag; // set bits to clear them
 		spiBASE->IER &= ~kLPSPI_AllInterruptEnable; // clear all interrupts
@@ -175,7 +1542,7 @@ void RestSPI3Peripheral(uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
 		spiBASE->CFGR1 &= (~LPSPI_CFGR1_NOSTALL_MASK);
 
 		/* Enable module for following configuration of TCR to take effect. */
-		spiBASE->CR |= LPSPI_CR_MEN_MASK ; // enable LPSPI3
+		spiBASE->CR |= LPSPI_CR_MEN_MASK ; // enable LPSPI
 
 		/* For DMA transfer , we'd better not masked the transmit data and receive data in TCR since the transfer flow is
 		 * hard to controlled by software. */
@@ -184,10 +1551,10 @@ void RestSPI3Peripheral(uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
 		spiBASE->TCR |= (LPSPI_TCR_CONT_MASK | LPSPI_TCR_BYSW_MASK ) ;
 
 		EDMATcdReset(&softwareTCD_pcsContinuous);
-		trasmitCommand = LPSPI3->TCR & ~(LPSPI_TCR_CONTC_MASK | LPSPI_TCR_CONT_MASK);
+		trasmitCommand = spiBASE->TCR & ~(LPSPI_TCR_CONTC_MASK | LPSPI_TCR_CONT_MASK);
 		softwareTCD_pcsContinuous.SADDR = (uint32_t)(&trasmitCommand);
 		softwareTCD_pcsContinuous.SOFF = 0;                          // source address offset set to 4 bytes
-		softwareTCD_pcsContinuous.DADDR = (uint32_t)&(LPSPI3->TCR);    // source address offset set to zero as it does not change
+		softwareTCD_pcsContinuous.DADDR = (uint32_t)&(spiBASE->TCR);    // source address offset set to zero as it does not change
 		softwareTCD_pcsContinuous.DOFF = 0;                      // each destination address write will increment by 1 byte
 		softwareTCD_pcsContinuous.ATTR = DMA_ATTR_SSIZE(2) | DMA_ATTR_DSIZE(2); // transfer size of 32 bits (002b => 32-bit) refer to page 134 of RM spec.
 		softwareTCD_pcsContinuous.NBYTES = 4;                    // number of bytes in each minor loop transfer.
@@ -198,74 +1565,27 @@ void RestSPI3Peripheral(uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
 #else
 		spiBASE->TCR |= ( LPSPI_TCR_BYSW_MASK ) ;
 #endif
+		handle->tcrByteFrame = (spiBASE->TCR & ~LPSPI_TCR_FRAMESZ_MASK) | LPSPI_TCR_FRAMESZ(7);
+		handle->tcrWordFrame = (spiBASE->TCR & ~LPSPI_TCR_FRAMESZ_MASK) | LPSPI_TCR_FRAMESZ(31);
+		if(handle->wordModeFlag && (handle->currentFrame.length >= 4))
+			spiBASE->TCR = handle->tcrWordFrame;
 
-		/* Configure rx EDMA transfer channel 0*/
-		rxTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[LPSPI_MASTER_DMA_RX_CHANNEL];
-		EDMATcdReset(rxTCD);
-		rxTCD->SADDR = (uint32_t)&(LPSPI3->RDR)+3; // our source address is the SPI3 Rx register
-		rxTCD->SOFF = 0;            // source address offset set to zero as it does not change
-		rxTCD->DADDR = ptrRxBuffer; // where the RX data will be placed
-		rxTCD->DOFF = 1;            // each destination address write will increment by 1 byte
-		rxTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
-		rxTCD->NBYTES = 1;           // number of bytes in each minor loop transfer.
-		rxTCD->CITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		rxTCD->BITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		rxTCD->DLAST_SGA = (BUFFER_SIZE*-1); // subtract destination from beginning
+		handle->currentFrame.txBuffer = ptrTxBuffer;
+		handle->currentFrame.rxBuffer = ptrRxBuffer;
 
-		// in our case will will trigger a IRQ when the major cycle count completes
-		rxTCD->CSR |= DMA_CSR_INTMAJOR_MASK;
+		/* Configure rx EDMA transfer channel */
+		ConfigRxTCD(handle, dmaBASE, ptrRxBuffer, handle->currentFrame.length);
 
-		/* Configure Tx EDMA transfer, channel 1 */
-		txTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[LPSPI_MASTER_DMA_TX_CHANNEL];
-		EDMATcdReset(txTCD);
-
-		txTCD->SADDR = ptrTxBuffer;  // our source buffer address to start reading from
-		txTCD->SOFF = 1;            // source address offset set to 1 to increment by one byte per transfer
-		txTCD->SLAST = (BUFFER_SIZE*-1); // subtract destination from beginning
-		txTCD->DADDR = (uint32_t)&(LPSPI3->TDR) + 3; // where the TX data will be placed SPI3 Tx Register
-		txTCD->DOFF = 0;            // each destination address is a hardware registers, so we will not increment it
-		txTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
-		txTCD->NBYTES = 1;           // number of bytes in each minor loop transfer.
-		txTCD->CITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		txTCD->BITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
+		/* Configure Tx EDMA transfer channel */
+		ConfigTxTCD(handle, dmaBASE, ptrTxBuffer, handle->currentFrame.length);
 #ifndef REMOVE_CONT
+		txTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[handle->txChannel];
 		txTCD->DLAST_SGA = (uint32_t)&softwareTCD_pcsContinuous;
-#else
-		txTCD->DLAST_SGA = 0;
 #endif
-		txTCD->CSR = 0;
-
-		/* Configure TCD to set the Tx ERQ so as to start a Tx transfer, channel 2 */
-		triggerTxTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[TRIGGER_DMA_TX_CHANNEL];
-		EDMATcdReset(triggerTxTCD);
-
-		triggerTxTCD->SADDR = triggerTxDMA;  // our source buffer address to start reading from
-		triggerTxTCD->SOFF = 0;              // source address offset set to 1 to increment by one byte per transfer
-		triggerTxTCD->SLAST = 0;             // subtract destination from beginning
-		triggerTxTCD->DADDR = (uint32_t )&(dmaBASE->SERQ); // DMA0->CERQ register
-		triggerTxTCD->DOFF = 0;            // each destination address is a hardware registers, so we will not increment it
-		triggerTxTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
-		triggerTxTCD->NBYTES = 1;           // number of bytes in each minor loop transfer.
-		triggerTxTCD->CITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		triggerTxTCD->BITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		triggerTxTCD->DLAST_SGA = 0;
-		triggerTxTCD->CSR = (TRIGGER_DMA_RX_CHANNEL<<8)| 1<<5;
-
-		/* Configure TCD to set the Tx ERQ so as to start a Tx transfer, channel 2 */
-		triggerRxTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[TRIGGER_DMA_RX_CHANNEL];
-		EDMATcdReset(triggerRxTCD);
-
-		triggerRxTCD->SADDR = triggerRxDMA;  // our source buffer address to start reading from
-		triggerRxTCD->SOFF = 0;              // source address offset set to 1 to increment by one byte per transfer
-		triggerRxTCD->SLAST = 0;             // subtract destination from beginning
-		triggerRxTCD->DADDR = (uint32_t )&(dmaBASE->SERQ); // DMA0->CERQ register
-		triggerRxTCD->DOFF = 0;            // each destination address is a hardware registers, so we will not increment it
-		triggerRxTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
-		triggerRxTCD->NBYTES = 1;           // number of bytes in each minor loop transfer.
-		triggerRxTCD->CITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		triggerRxTCD->BITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-		triggerRxTCD->DLAST_SGA = 0;
-		triggerRxTCD->CSR = 0;
+
+		/* trigger channels come from the images built by InitDMAandEDMA() */
+		EDMATcdLoad(dmaBASE, handle->triggerTxChannel, &handle->triggerTxImage);
+		EDMATcdLoad(dmaBASE, handle->triggerRxChannel, &handle->triggerRxImage);
 
 		//	NVIC_EnableIRQ(DMA0_DMA16_IRQn);
 		//	NVIC_EnableIRQ(DMA1_DMA17_IRQn);
@@ -285,60 +1605,62 @@ void RestSPI3Peripheral(uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
 		txTCD->CSR =  (txTCD->CSR | (uint16_t)DMA_CSR_ESG_MASK) & ~(uint16_t)DMA_CSR_DREQ_MASK;
 #endif
 
-		dmaBASE->SERQ = DMA_SERQ_SERQ(1); // eDMA starts transfer TX channel
-		dmaBASE->SERQ = DMA_SERQ_SERQ(0); // eDMA starts transfer RX channel
+		if(handle->gpioTriggerFlag)
+		{
+			dmaBASE->SERQ = DMA_SERQ_SERQ(handle->triggerTxChannel); // every GPIO edge starts a frame from now on
+		}
+		else
+		{
+			dmaBASE->SERQ = DMA_SERQ_SERQ(handle->txChannel); // eDMA starts transfer TX channel
+			dmaBASE->SERQ = DMA_SERQ_SERQ(handle->rxChannel); // eDMA starts transfer RX channel
+		}
 
 
 		spiBASE->DER |= (LPSPI_DER_TDDE_MASK /*!< Transmit data DMA enable */ | LPSPI_DER_RDDE_MASK /*!< Receive data DMA enable */ );
 	}
+	else if(handle->gpioTriggerFlag)
+	{
+		// frames are started by the GPIO edge, the TCDs reload themselves
+	}
 	else
 	{
-		/* Configure rx EDMA transfer channel 0*/
-		if(passRxSetupFlag)
+		/* Configure rx EDMA transfer channel, a stream keeps running where it is */
+		if(handle->passRxSetupFlag && !handle->rxStreamBuffer)
 		{
-			rxTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[0];
-			EDMATcdReset(rxTCD);
-			rxTCD->SADDR = (uint32_t)&(LPSPI3->RDR)+3; // our source address is the SPI3 Rx register
-			rxTCD->SOFF = 0;            // source address offset set to zero as it does not change
-			rxTCD->DADDR = ptrRxBuffer; // where the RX data will be placed
-			rxTCD->DOFF = 1;            // each destination address write will increment by 1 byte
-			rxTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
-			rxTCD->NBYTES = 1;           // number of bytes in each minor loop transfer.
-			rxTCD->CITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-			rxTCD->BITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-			rxTCD->DLAST_SGA = (BUFFER_SIZE*-1); // subtract destination from beginning
-
-			// in our case will will trigger a IRQ when the major cycle count completes
-			rxTCD->CSR |= DMA_CSR_INTMAJOR_MASK;
+			if(ptrRxBuffer != handle->currentFrame.rxBuffer)
+			{
+				handle->currentFrame.rxBuffer = ptrRxBuffer;
+				ConfigRxTCD(handle, dmaBASE, ptrRxBuffer, handle->currentFrame.length);
+			}
+			else
+			{
+				EDMATcdLoad(dmaBASE, handle->rxChannel, handle->rxRingSlots ? &handle->rxRingTCD[0] : &handle->rxSegmentTCD[0]);
+			}
 		}
-		if(passTxSetupFlag)
+		if(handle->passTxSetupFlag)
 		{
-			/* Configure Tx EDMA transfer, channel 1 */
-			txTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[1];
-			EDMATcdReset(txTCD);
-
-			txTCD->SADDR = ptrTxBuffer;  // our source buffer address to start reading from
-			txTCD->SOFF = 1;            // source address offset set to 1 to increment by one byte per transfer
-			txTCD->SLAST = (BUFFER_SIZE*-1); // subtract destination from beginning
-			txTCD->DADDR = (uint32_t)&(LPSPI3->TDR) + 3; // where the TX data will be placed SPI3 Tx Register
-			txTCD->DOFF = 0;            // each destination address is a hardware registers, so we will not increment it
-			txTCD->ATTR = 0;            // transfer size of 1 byte (000b => 8-bit) refer to page 134 of RM spec.
-			txTCD->NBYTES = 1;           // number of bytes in each minor loop transfer.
-			txTCD->CITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-			txTCD->BITER = BUFFER_SIZE;  // number of bytes(loops) in the complete one ADC read operation
-			txTCD->DLAST_SGA = 0;
+			/* Configure Tx EDMA transfer channel */
+			if(ptrTxBuffer != handle->currentFrame.txBuffer)
+			{
+				handle->currentFrame.txBuffer = ptrTxBuffer;
+				ConfigTxTCD(handle, dmaBASE, ptrTxBuffer, handle->currentFrame.length);
+			}
+			else
+			{
+				EDMATcdLoad(dmaBASE, handle->txChannel, &handle->txSegmentTCD[0]);
+			}
 		}
 
-		if(combineDMATriggerFlag)
+		if(handle->combineDMATriggerFlag)
 		{
-			if( triggerTxERQ)
-			dmaBASE->SERQ = DMA_SERQ_SERQ(1); // eDMA starts transfer TX channel
-			if( triggerRxERQ)
-			dmaBASE->SERQ = DMA_SERQ_SERQ(0); // eDMA starts transfer RX channel
+			if( handle->triggerTxERQ)
+			dmaBASE->SERQ = DMA_SERQ_SERQ(handle->txChannel); // eDMA starts transfer TX channel
+			if( handle->triggerRxERQ)
+			dmaBASE->SERQ = DMA_SERQ_SERQ(handle->rxChannel); // eDMA starts transfer RX channel
 		}
 		else
 		{
-			dmaBASE->SERQ = (DMA_SERQ_SERQ(2)  ); // eDMA starts setting the Tx/Rx EIR registers
+			dmaBASE->SSRT = DMA_SSRT_SSRT(handle->triggerTxChannel); // software kick of the same chain the GPIO edge uses
 		}
 
 //		dmaBASE->SERQ = (DMA_SERQ_SERQ(1) | DMA_SERQ_SERQ(0) ); // eDMA starts transfer TX channel
@@ -351,12 +1673,181 @@ void RestSPI3Peripheral(uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer)
 }
 
 
-void DMA_irq(void)
+/*
+ * Rx re-arm the way RestSPI3Peripheral() used to do it on every call, kept only
+ * as the reference for BenchmarkTcdRearm()
+ */
+static void RearmRxTcdFieldByField(spi3dma_handle_t *handle, DMA_Type *dmaBASE, uint8_t *ptrRxBuffer, uint32_t frameLength)
+{
+	edma_tcd_t *rxTCD = (edma_tcd_t *)(uint32_t)&dmaBASE->TCD[handle->rxChannel];
+
+	EDMATcdReset(rxTCD);
+	rxTCD->SADDR = (uint32_t)&(handle->spiBASE->RDR)+3;
+	rxTCD->SOFF = 0;
+	rxTCD->DADDR = (uint32_t)ptrRxBuffer;
+	rxTCD->DOFF = 1;
+	rxTCD->ATTR = 0;
+	rxTCD->NBYTES = 1;
+	rxTCD->CITER = frameLength;
+	rxTCD->BITER = frameLength;
+	rxTCD->DLAST_SGA = -(int32_t)frameLength;
+	rxTCD->CSR |= DMA_CSR_INTMAJOR_MASK;
+}
+
+#define TCD_BENCH_LOOPS (64)
+
+/*
+ * DWT cycle count of re-arming the Rx channel field by field versus loading the
+ * prebuilt image, best of TCD_BENCH_LOOPS runs each.  The Rx/Tx/trigger requests
+ * are held off while it runs and the Rx image is put back when done, so call it
+ * between frames.
+ */
+void BenchmarkTcdRearm(spi3dma_handle_t *handle, uint32_t *fieldCycles, uint32_t *imageCycles)
+{
+	DMA_Type *dmaBASE = DMA0;
+	uint32_t erq = dmaBASE->ERQ;
+	uint32_t loop;
+	uint32_t start;
+	uint32_t cycles;
+
+	DEMCR_REG |= DEMCR_TRCENA_MASK;
+	DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA_MASK;
+
+	dmaBASE->CERQ = DMA_CERQ_CERQ(handle->triggerTxChannel);
+	dmaBASE->CERQ = DMA_CERQ_CERQ(handle->rxChannel);
+	dmaBASE->CERQ = DMA_CERQ_CERQ(handle->txChannel);
+
+	*fieldCycles = 0xFFFFFFFF;
+	*imageCycles = 0xFFFFFFFF;
+	for(loop = 0; loop < TCD_BENCH_LOOPS; loop++)
+	{
+		start = DWT_CYCCNT_REG;
+		RearmRxTcdFieldByField(handle, dmaBASE, handle->currentFrame.rxBuffer, handle->currentFrame.length);
+		cycles = DWT_CYCCNT_REG - start;
+		if(cycles < *fieldCycles)
+			*fieldCycles = cycles;
+
+		start = DWT_CYCCNT_REG;
+		EDMATcdLoad(dmaBASE, handle->rxChannel, handle->rxRingSlots ? &handle->rxRingTCD[0] : &handle->rxSegmentTCD[0]);
+		cycles = DWT_CYCCNT_REG - start;
+		if(cycles < *imageCycles)
+			*imageCycles = cycles;
+	}
+
+	dmaBASE->ERQ = erq;
+}
+
+/*
+ * Rx buffers in cacheable memory (OCRAM, SDRAM outside NCACHE_REGION): invalidate
+ * each completed frame or batch in DMA_irq(), and the partial batch in
+ * FlushSPI3RxBatch(), before it is published.  Not needed
+ * for DTCM or NCACHE_REGION buffers, the stream mode leaves it to the consumer.
+ */
+void SetSPI3RxCacheMaintenance(spi3dma_handle_t *handle, uint8_t enable)
+{
+	handle->rxInvalidateFlag = enable;
+}
+
+SPI3_ITCM_CODE void DMA_irq(spi3dma_handle_t *handle)
 {
 	DMA_Type *dmaBASE = DMA0;
-	static uint32_t irqDmaCnt = 0;
-	dmaBASE->INT |= 1<<0; // clear IRQ0
+	dmaBASE->CINT = DMA_CINT_CINT(handle->rxChannel); // clear this handle's Rx IRQ only
+
+	handle->rxIrqCycles = DWT_CYCCNT_REG; // completion time for the latency bench, before any bookkeeping
+	handle->irqDmaCnt++;
+	if(handle->rxInvalidateFlag)
+	{
+		// a batch never straddles the ring wrap, so the completed slots are one range
+		if(handle->rxRingSlots)
+			InvalidateRxLines(handle->rxRingBuffer + ((handle->rxFrameCount % handle->rxRingSlots) * handle->currentFrame.length),
+					handle->rxIrqBatch * handle->currentFrame.length);
+		else
+			InvalidateRxLines(handle->currentFrame.rxBuffer, handle->currentFrame.length);
+	}
+	handle->rxFrameCount = handle->rxFrameCount + handle->rxIrqBatch; // publish the batch after the data is in RAM
+
+	// the next batch is already being captured, the one after it would overwrite a slot the consumer still holds
+	if(handle->rxRingSlots
+			&& ((handle->rxFrameCount + handle->rxIrqBatch - handle->rxReleaseCount) > (handle->rxRingSlots - handle->rxIrqBatch)))
+	{
+		dmaBASE->CERQ = DMA_CERQ_CERQ(handle->triggerTxChannel);
+		if(!handle->rxPausedFlag)
+			handle->rxPauseCount = handle->rxPauseCount + 1; // the batch in flight completing does not pause again
+		handle->rxPausedFlag = 1;
+	}
+}
+
+/*
+ * First to last instruction of the two DMA vectors in DWT cycles, index 0 is
+ * DMA0_DMA16 and 1 DMA8_DMA24.  Exception entry/exit and the vector fetch come
+ * on top, about 12 cycles each when the vector table is not in flash.
+ */
+static volatile uint32_t dmaIsrCycles[2] SPI3_DTCM_BSS;
+static volatile uint32_t dmaIsrMaxCycles[2] SPI3_DTCM_BSS;
+
+SPI3_ITCM_CODE static void IsrCyclesUpdate(uint32_t vector, uint32_t entry)
+{
+	uint32_t cycles = DWT_CYCCNT_REG - entry;
+
+	dmaIsrCycles[vector] = cycles;
+	if(cycles > dmaIsrMaxCycles[vector])
+		dmaIsrMaxCycles[vector] = cycles;
+}
+
+/*
+ * Duration of the last and of the longest run of the DMA vector serving this
+ * handle's Rx channel, the cycle counter has to be enabled (DEMCR TRCENA, DWT CTRL).
+ */
+uint32_t GetSPI3IsrCycles(spi3dma_handle_t *handle)
+{
+	return dmaIsrCycles[(handle->rxChannel >> 3) & 1];
+}
+
+uint32_t GetSPI3IsrMaxCycles(spi3dma_handle_t *handle)
+{
+	return dmaIsrMaxCycles[(handle->rxChannel >> 3) & 1];
+}
+
+/*
+ * Dispatch the Rx completion of every handle whose Rx channel raised the shared
+ * vector, channel and channel + 16 share one.
+ */
+SPI3_ITCM_CODE static void DMA_irqChannelPair(uint32_t channel)
+{
+	uint32_t idx;
+	uint32_t intFlags = DMA0->INT;
+
+	for(idx = 0; idx < SPI3_INSTANCE_COUNT; idx++)
+	{
+		spi3dma_handle_t *handle = &spi3Handle[idx];
+
+		if(handle->instance && ((handle->rxChannel & 0xF) == channel) && (intFlags & (1U << handle->rxChannel)))
+			DMA_irq(handle);
+	}
+}
+
+/*
+ * Rx channels 0 (LPSPI3) and 16 (LPSPI2) major loop complete, overrides the weak
+ * handler in startup_mimxrt1062.c
+ */
+SPI3_ITCM_CODE void DMA0_DMA16_IRQHandler(void)
+{
+	uint32_t entry = DWT_CYCCNT_REG;
+
+	DMA_irqChannelPair(0);
+	IsrCyclesUpdate(0, entry);
+	SPI3_DSB(); // ARM errata 838869
+}
+
+/*
+ * Rx channels 8 (LPSPI1) and 24 (LPSPI4) major loop complete
+ */
+SPI3_ITCM_CODE void DMA8_DMA24_IRQHandler(void)
+{
+	uint32_t entry = DWT_CYCCNT_REG;
 
-	irqDmaCnt++;
+	DMA_irqChannelPair(8);
+	IsrCyclesUpdate(1, entry);
+	SPI3_DSB(); // ARM errata 838869
 }
 
@@ -968,14 +968,36 @@ typedef enum _xbar_output_signal
 
 /* DMA - Peripheral instance base addresses */
 /** Peripheral DMA0 base address */
+#ifndef DMA0_BASE
 #define DMA0_BASE                                (0x400E8000u)
+#endif
 /** Peripheral DMA0 base pointer */
 #define DMA0                                     ((DMA_Type *)DMA0_BASE)
 
+/** Peripheral LPSPI1 base address */
+#ifndef LPSPI1_BASE
+#define LPSPI1_BASE                              (0x40394000u)
+#endif
+/** Peripheral LPSPI1 base pointer */
+#define LPSPI1                                   ((LPSPI_Type *)LPSPI1_BASE)
+/** Peripheral LPSPI2 base address */
+#ifndef LPSPI2_BASE
+#define LPSPI2_BASE                              (0x40398000u)
+#endif
+/** Peripheral LPSPI2 base pointer */
+#define LPSPI2                                   ((LPSPI_Type *)LPSPI2_BASE)
 /** Peripheral LPSPI3 base address */
+#ifndef LPSPI3_BASE
 #define LPSPI3_BASE                              (0x4039C000u)
+#endif
 /** Peripheral LPSPI3 base pointer */
 #define LPSPI3                                   ((LPSPI_Type *)LPSPI3_BASE)
+/** Peripheral LPSPI4 base address */
+#ifndef LPSPI4_BASE
+#define LPSPI4_BASE                              (0x403A0000u)
+#endif
+/** Peripheral LPSPI4 base pointer */
+#define LPSPI4                                   ((LPSPI_Type *)LPSPI4_BASE)
 
 /*!
  * @addtogroup LPSPI_Peripheral_Access_Layer LPSPI Peripheral Access Layer
@@ -1975,7 +1997,9 @@ typedef struct {
 
 /* DMAMUX - Peripheral instance base addresses */
 /** Peripheral DMAMUX base address */
+#ifndef DMAMUX_BASE
 #define DMAMUX_BASE                              (0x400EC000u)
+#endif
 /** Peripheral DMAMUX base pointer */
 #define DMAMUX                                   ((DMAMUX_Type *)DMAMUX_BASE)
 
@@ -5392,7 +5416,9 @@ typedef struct {
 
 /* DMA - Peripheral instance base addresses */
 /** Peripheral DMA0 base address */
+#ifndef DMA0_BASE
 #define DMA0_BASE                                (0x400E8000u)
+#endif
 /** Peripheral DMA0 base pointer */
 #define DMA0                                     ((DMA_Type *)DMA0_BASE)
 /** Array initializer of DMA peripheral base addresses */
@@ -7596,7 +7622,9 @@ typedef struct {
 
 /* CCM - Peripheral instance base addresses */
 /** Peripheral CCM base address */
+#ifndef CCM_BASE
 #define CCM_BASE                                 (0x400FC000u)
+#endif
 /** Peripheral CCM base pointer */
 #define CCM                                      ((CCM_Type *)CCM_BASE)
 /** Array initializer of CCM peripheral base addresses */
@@ -7623,6 +7651,69 @@ typedef struct {
 #define LPSPI_TCR_PCS_MASK                       (0x3000000U)
 #define LPSPI_TCR_BYSW_MASK                      (0x400000U)
 
+/* place TCD images and hot data in DTCM, MCUXpresso managed linker script sections */
+#define SPI3_DTCM_DATA __attribute__((section(".data.$SRAM_DTC")))
+#define SPI3_DTCM_BSS  __attribute__((section(".bss.$SRAM_DTC")))
+
+/* DWT cycle counter, core_cm7.h is not included next to this header */
+#ifndef DWT_CYCCNT_REG
+#define DEMCR_REG                                (*(volatile uint32_t *)0xE000EDFCu)
+#define DWT_CTRL_REG                             (*(volatile uint32_t *)0xE0001000u)
+#define DWT_CYCCNT_REG                           (*(volatile uint32_t *)0xE0001004u)
+#endif
+#define DEMCR_TRCENA_MASK                        (0x1000000U)
+#define DWT_CTRL_CYCCNTENA_MASK                  (0x1U)
+
+/* D-cache invalidate by address to the point of coherency, one 32 byte line per write */
+#ifndef SCB_DCIMVAC_REG
+#define SCB_DCIMVAC_REG                          (*(volatile uint32_t *)0xE000EF5Cu)
+#endif
+#define SCB_DCACHE_LINE_SIZE                     (32U)
+
+/* NVIC enable of the eDMA vectors, channel n and n+16 share IRQ n (DMA0_DMA16_IRQn is 0) */
+#ifndef NVIC_ISER0_REG
+#define NVIC_ISER0_REG                           (*(volatile uint32_t *)0xE000E100u)
+#define NVIC_ICER0_REG                           (*(volatile uint32_t *)0xE000E180u)
+#endif
+#define SPI3_DMA_IRQ_MASK(channel)               (1U << ((channel) & 15U))
+
+/* vector table offset, the table has to be aligned to its size rounded up to a power of 2 */
+#ifndef SCB_VTOR_REG
+#define SCB_VTOR_REG                             (*(volatile uint32_t *)0xE000ED08u)
+#endif
+#define SPI3_VECTOR_COUNT                        (174U) // NUMBER_OF_INT_VECTORS, 16 system + 158 IRQ
+#define SPI3_VECTOR_ALIGN                        (1024U)
+
+/*
+ * Hot path code in ITCM with SPI3_HOT_PATH_ITCM (spi3DMAApi.h), the MCUXpresso
+ * managed linker script copies .ramfunc.$SRAM_ITC from flash in ResetISR().
+ * noinline keeps the functions from being pulled back into flash callers.
+ */
+#if SPI3_HOT_PATH_ITCM
+#define SPI3_ITCM_CODE __attribute__((section(".ramfunc.$SRAM_ITC"), noinline))
+#define SPI3_ITCM_BSS  __attribute__((section(".bss.$SRAM_ITC")))
+#else
+#define SPI3_ITCM_CODE
+#define SPI3_ITCM_BSS
+#endif
+
+/*
+ * Off target builds (register model on a PC) predefine the *_BASE addresses to
+ * RAM images of the register blocks, the DWT_*_REG and the barriers below.
+ * The TCD address fields stay 32 bit, so everything the eDMA addresses has to
+ * sit below 4 GiB: a 32 bit build, or 64 bit non-PIE with the register blocks
+ * mapped at their real addresses (tools/spi3dma_sim).
+ */
+#ifndef SPI3_DMB
+#define SPI3_DMB() __asm volatile ("dmb 0xF" ::: "memory")
+#endif
+#ifndef SPI3_DSB
+#define SPI3_DSB() __asm volatile ("dsb 0xF" ::: "memory")
+#endif
+#ifndef SPI3_ISB
+#define SPI3_ISB() __asm volatile ("isb 0xF" ::: "memory")
+#endif
+
 
 /* ----------------------------------------------------------------------------
    -- IOMUXC Peripheral Access Layer
@@ -7903,7 +7994,9 @@ typedef struct {
 
 /* IOMUXC - Peripheral instance base addresses */
 /** Peripheral IOMUXC base address */
+#ifndef IOMUXC_BASE
 #define IOMUXC_BASE                              (0x401F8000u)
+#endif
 /** Peripheral IOMUXC base pointer */
 #define IOMUXC                                   ((IOMUXC_Type *)IOMUXC_BASE)
 /** Array initializer of IOMUXC peripheral base addresses */
@@ -10363,7 +10456,9 @@ typedef struct {
 
 /* IOMUXC_GPR - Peripheral instance base addresses */
 /** Peripheral IOMUXC_GPR base address */
+#ifndef IOMUXC_GPR_BASE
 #define IOMUXC_GPR_BASE                          (0x400AC000u)
+#endif
 /** Peripheral IOMUXC_GPR base pointer */
 #define IOMUXC_GPR                               ((IOMUXC_GPR_Type *)IOMUXC_GPR_BASE)
 /** Array initializer of IOMUXC_GPR peripheral base addresses */
@@ -10377,5 +10472,702 @@ typedef struct {
 
 
 
+/* ----------------------------------------------------------------------------
+   -- XBARA Peripheral Access Layer
+   ---------------------------------------------------------------------------- */
+
+/*!
+ * @addtogroup XBARA_Peripheral_Access_Layer XBARA Peripheral Access Layer
+ * @{
+ */
+
+/** XBARA - Register Layout Typedef */
+typedef struct {
+  __IO uint16_t SEL0;                              /**< Crossbar A Select Register 0, offset: 0x0 */
+  __IO uint16_t SEL1;                              /**< Crossbar A Select Register 1, offset: 0x2 */
+  __IO uint16_t SEL2;                              /**< Crossbar A Select Register 2, offset: 0x4 */
+  __IO uint16_t SEL3;                              /**< Crossbar A Select Register 3, offset: 0x6 */
+  __IO uint16_t SEL4;                              /**< Crossbar A Select Register 4, offset: 0x8 */
+  __IO uint16_t SEL5;                              /**< Crossbar A Select Register 5, offset: 0xA */
+  __IO uint16_t SEL6;                              /**< Crossbar A Select Register 6, offset: 0xC */
+  __IO uint16_t SEL7;                              /**< Crossbar A Select Register 7, offset: 0xE */
+  __IO uint16_t SEL8;                              /**< Crossbar A Select Register 8, offset: 0x10 */
+  __IO uint16_t SEL9;                              /**< Crossbar A Select Register 9, offset: 0x12 */
+  __IO uint16_t SEL10;                             /**< Crossbar A Select Register 10, offset: 0x14 */
+  __IO uint16_t SEL11;                             /**< Crossbar A Select Register 11, offset: 0x16 */
+  __IO uint16_t SEL12;                             /**< Crossbar A Select Register 12, offset: 0x18 */
+  __IO uint16_t SEL13;                             /**< Crossbar A Select Register 13, offset: 0x1A */
+  __IO uint16_t SEL14;                             /**< Crossbar A Select Register 14, offset: 0x1C */
+  __IO uint16_t SEL15;                             /**< Crossbar A Select Register 15, offset: 0x1E */
+  __IO uint16_t SEL16;                             /**< Crossbar A Select Register 16, offset: 0x20 */
+  __IO uint16_t SEL17;                             /**< Crossbar A Select Register 17, offset: 0x22 */
+  __IO uint16_t SEL18;                             /**< Crossbar A Select Register 18, offset: 0x24 */
+  __IO uint16_t SEL19;                             /**< Crossbar A Select Register 19, offset: 0x26 */
+  __IO uint16_t SEL20;                             /**< Crossbar A Select Register 20, offset: 0x28 */
+  __IO uint16_t SEL21;                             /**< Crossbar A Select Register 21, offset: 0x2A */
+  __IO uint16_t SEL22;                             /**< Crossbar A Select Register 22, offset: 0x2C */
+  __IO uint16_t SEL23;                             /**< Crossbar A Select Register 23, offset: 0x2E */
+  __IO uint16_t SEL24;                             /**< Crossbar A Select Register 24, offset: 0x30 */
+  __IO uint16_t SEL25;                             /**< Crossbar A Select Register 25, offset: 0x32 */
+  __IO uint16_t SEL26;                             /**< Crossbar A Select Register 26, offset: 0x34 */
+  __IO uint16_t SEL27;                             /**< Crossbar A Select Register 27, offset: 0x36 */
+  __IO uint16_t SEL28;                             /**< Crossbar A Select Register 28, offset: 0x38 */
+  __IO uint16_t SEL29;                             /**< Crossbar A Select Register 29, offset: 0x3A */
+  __IO uint16_t SEL30;                             /**< Crossbar A Select Register 30, offset: 0x3C */
+  __IO uint16_t SEL31;                             /**< Crossbar A Select Register 31, offset: 0x3E */
+  __IO uint16_t SEL32;                             /**< Crossbar A Select Register 32, offset: 0x40 */
+  __IO uint16_t SEL33;                             /**< Crossbar A Select Register 33, offset: 0x42 */
+  __IO uint16_t SEL34;                             /**< Crossbar A Select Register 34, offset: 0x44 */
+  __IO uint16_t SEL35;                             /**< Crossbar A Select Register 35, offset: 0x46 */
+  __IO uint16_t SEL36;                             /**< Crossbar A Select Register 36, offset: 0x48 */
+  __IO uint16_t SEL37;                             /**< Crossbar A Select Register 37, offset: 0x4A */
+  __IO uint16_t SEL38;                             /**< Crossbar A Select Register 38, offset: 0x4C */
+  __IO uint16_t SEL39;                             /**< Crossbar A Select Register 39, offset: 0x4E */
+  __IO uint16_t SEL40;                             /**< Crossbar A Select Register 40, offset: 0x50 */
+  __IO uint16_t SEL41;                             /**< Crossbar A Select Register 41, offset: 0x52 */
+  __IO uint16_t SEL42;                             /**< Crossbar A Select Register 42, offset: 0x54 */
+  __IO uint16_t SEL43;                             /**< Crossbar A Select Register 43, offset: 0x56 */
+  __IO uint16_t SEL44;                             /**< Crossbar A Select Register 44, offset: 0x58 */
+  __IO uint16_t SEL45;                             /**< Crossbar A Select Register 45, offset: 0x5A */
+  __IO uint16_t SEL46;                             /**< Crossbar A Select Register 46, offset: 0x5C */
+  __IO uint16_t SEL47;                             /**< Crossbar A Select Register 47, offset: 0x5E */
+  __IO uint16_t SEL48;                             /**< Crossbar A Select Register 48, offset: 0x60 */
+  __IO uint16_t SEL49;                             /**< Crossbar A Select Register 49, offset: 0x62 */
+  __IO uint16_t SEL50;                             /**< Crossbar A Select Register 50, offset: 0x64 */
+  __IO uint16_t SEL51;                             /**< Crossbar A Select Register 51, offset: 0x66 */
+  __IO uint16_t SEL52;                             /**< Crossbar A Select Register 52, offset: 0x68 */
+  __IO uint16_t SEL53;                             /**< Crossbar A Select Register 53, offset: 0x6A */
+  __IO uint16_t SEL54;                             /**< Crossbar A Select Register 54, offset: 0x6C */
+  __IO uint16_t SEL55;                             /**< Crossbar A Select Register 55, offset: 0x6E */
+  __IO uint16_t SEL56;                             /**< Crossbar A Select Register 56, offset: 0x70 */
+  __IO uint16_t SEL57;                             /**< Crossbar A Select Register 57, offset: 0x72 */
+  __IO uint16_t SEL58;                             /**< Crossbar A Select Register 58, offset: 0x74 */
+  __IO uint16_t SEL59;                             /**< Crossbar A Select Register 59, offset: 0x76 */
+  __IO uint16_t SEL60;                             /**< Crossbar A Select Register 60, offset: 0x78 */
+  __IO uint16_t SEL61;                             /**< Crossbar A Select Register 61, offset: 0x7A */
+  __IO uint16_t SEL62;                             /**< Crossbar A Select Register 62, offset: 0x7C */
+  __IO uint16_t SEL63;                             /**< Crossbar A Select Register 63, offset: 0x7E */
+  __IO uint16_t SEL64;                             /**< Crossbar A Select Register 64, offset: 0x80 */
+  __IO uint16_t SEL65;                             /**< Crossbar A Select Register 65, offset: 0x82 */
+  __IO uint16_t CTRL0;                             /**< Crossbar A Control Register 0, offset: 0x84 */
+  __IO uint16_t CTRL1;                             /**< Crossbar A Control Register 1, offset: 0x86 */
+} XBARA_Type;
+
+
+/* ----------------------------------------------------------------------------
+   -- XBARA Register Masks
+   ---------------------------------------------------------------------------- */
+
+/*!
+ * @addtogroup XBARA_Register_Masks XBARA Register Masks
+ * @{
+ */
+
+/*! @name SEL0 - Crossbar A Select Register 0 */
+/*! @{ */
+
+#define XBARA_SEL0_SEL0_MASK                     (0x7FU)
+#define XBARA_SEL0_SEL0_SHIFT                    (0U)
+#define XBARA_SEL0_SEL0(x)                       (((uint16_t)(((uint16_t)(x)) << XBARA_SEL0_SEL0_SHIFT)) & XBARA_SEL0_SEL0_MASK)
+
+#define XBARA_SEL0_SEL1_MASK                     (0x7F00U)
+#define XBARA_SEL0_SEL1_SHIFT                    (8U)
+#define XBARA_SEL0_SEL1(x)                       (((uint16_t)(((uint16_t)(x)) << XBARA_SEL0_SEL1_SHIFT)) & XBARA_SEL0_SEL1_MASK)
+/*! @} */
+
+/*! @name CTRL0 - Crossbar A Control Register 0 */
+/*! @{ */
+
+#define XBARA_CTRL0_DEN0_MASK                    (0x1U)
+#define XBARA_CTRL0_DEN0_SHIFT                   (0U)
+/*! DEN0 - DMA Enable for XBAR_OUT0
+ *  0b0..DMA disabled
+ *  0b1..DMA enabled
+ */
+#define XBARA_CTRL0_DEN0(x)                      (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_DEN0_SHIFT)) & XBARA_CTRL0_DEN0_MASK)
+
+#define XBARA_CTRL0_IEN0_MASK                    (0x2U)
+#define XBARA_CTRL0_IEN0_SHIFT                   (1U)
+/*! IEN0 - Interrupt Enable for XBAR_OUT0
+ *  0b0..Interrupt disabled
+ *  0b1..Interrupt enabled
+ */
+#define XBARA_CTRL0_IEN0(x)                      (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_IEN0_SHIFT)) & XBARA_CTRL0_IEN0_MASK)
+
+#define XBARA_CTRL0_EDGE0_MASK                   (0xCU)
+#define XBARA_CTRL0_EDGE0_SHIFT                  (2U)
+/*! EDGE0 - Active edge for edge detection on XBAR_OUT0
+ *  0b00..STS0 never asserts
+ *  0b01..STS0 asserts on rising edges of XBAR_OUT0
+ *  0b10..STS0 asserts on falling edges of XBAR_OUT0
+ *  0b11..STS0 asserts on rising and falling edges of XBAR_OUT0
+ */
+#define XBARA_CTRL0_EDGE0(x)                     (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_EDGE0_SHIFT)) & XBARA_CTRL0_EDGE0_MASK)
+
+#define XBARA_CTRL0_STS0_MASK                    (0x10U)
+#define XBARA_CTRL0_STS0_SHIFT                   (4U)
+/*! STS0 - Edge detection status for XBAR_OUT0
+ *  0b0..Active edge not yet detected on XBAR_OUT0
+ *  0b1..Active edge detected on XBAR_OUT0
+ */
+#define XBARA_CTRL0_STS0(x)                      (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_STS0_SHIFT)) & XBARA_CTRL0_STS0_MASK)
+
+#define XBARA_CTRL0_DEN1_MASK                    (0x100U)
+#define XBARA_CTRL0_DEN1_SHIFT                   (8U)
+/*! DEN1 - DMA Enable for XBAR_OUT1
+ *  0b0..DMA disabled
+ *  0b1..DMA enabled
+ */
+#define XBARA_CTRL0_DEN1(x)                      (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_DEN1_SHIFT)) & XBARA_CTRL0_DEN1_MASK)
+
+#define XBARA_CTRL0_IEN1_MASK                    (0x200U)
+#define XBARA_CTRL0_IEN1_SHIFT                   (9U)
+/*! IEN1 - Interrupt Enable for XBAR_OUT1
+ *  0b0..Interrupt disabled
+ *  0b1..Interrupt enabled
+ */
+#define XBARA_CTRL0_IEN1(x)                      (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_IEN1_SHIFT)) & XBARA_CTRL0_IEN1_MASK)
+
+#define XBARA_CTRL0_EDGE1_MASK                   (0xC00U)
+#define XBARA_CTRL0_EDGE1_SHIFT                  (10U)
+/*! EDGE1 - Active edge for edge detection on XBAR_OUT1
+ *  0b00..STS1 never asserts
+ *  0b01..STS1 asserts on rising edges of XBAR_OUT1
+ *  0b10..STS1 asserts on falling edges of XBAR_OUT1
+ *  0b11..STS1 asserts on rising and falling edges of XBAR_OUT1
+ */
+#define XBARA_CTRL0_EDGE1(x)                     (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_EDGE1_SHIFT)) & XBARA_CTRL0_EDGE1_MASK)
+
+#define XBARA_CTRL0_STS1_MASK                    (0x1000U)
+#define XBARA_CTRL0_STS1_SHIFT                   (12U)
+/*! STS1 - Edge detection status for XBAR_OUT1
+ *  0b0..Active edge not yet detected on XBAR_OUT1
+ *  0b1..Active edge detected on XBAR_OUT1
+ */
+#define XBARA_CTRL0_STS1(x)                      (((uint16_t)(((uint16_t)(x)) << XBARA_CTRL0_STS1_SHIFT)) & XBARA_CTRL0_STS1_MASK)
+/*! @} */
+
+
+/*!
+ * @}
+ */ /* end of group XBARA_Register_Masks */
+
+
+/* XBARA - Peripheral instance base addresses */
+/** Peripheral XBARA1 base address */
+#ifndef XBARA1_BASE
+#define XBARA1_BASE                              (0x403BC000u)
+#endif
+/** Peripheral XBARA1 base pointer */
+#define XBARA1                                   ((XBARA_Type *)XBARA1_BASE)
+/** Array initializer of XBARA peripheral base addresses */
+#define XBARA_BASE_ADDRS                         { 0u, XBARA1_BASE }
+/** Array initializer of XBARA peripheral base pointers */
+#define XBARA_BASE_PTRS                          { (XBARA_Type *)0u, XBARA1 }
+
+/*!
+ * @}
+ */ /* end of group XBARA_Peripheral_Access_Layer */
+
+
+
+/* ----------------------------------------------------------------------------
+   -- GPT Peripheral Access Layer
+   ---------------------------------------------------------------------------- */
+
+/*!
+ * @addtogroup GPT_Peripheral_Access_Layer GPT Peripheral Access Layer
+ * @{
+ */
+
+/** GPT - Register Layout Typedef */
+typedef struct {
+  __IO uint32_t CR;                                /**< GPT Control Register, offset: 0x0 */
+  __IO uint32_t PR;                                /**< GPT Prescaler Register, offset: 0x4 */
+  __IO uint32_t SR;                                /**< GPT Status Register, offset: 0x8 */
+  __IO uint32_t IR;                                /**< GPT Interrupt Register, offset: 0xC */
+  __IO uint32_t OCR[3];                            /**< GPT Output Compare Register 1..GPT Output Compare Register 3, array offset: 0x10, array step: 0x4 */
+  __I  uint32_t ICR[2];                            /**< GPT Input Capture Register 1..GPT Input Capture Register 2, array offset: 0x1C, array step: 0x4 */
+  __I  uint32_t CNT;                               /**< GPT Counter Register, offset: 0x24 */
+} GPT_Type;
+
+/* ----------------------------------------------------------------------------
+   -- GPT Register Masks
+   ---------------------------------------------------------------------------- */
+
+/*!
+ * @addtogroup GPT_Register_Masks GPT Register Masks
+ * @{
+ */
+
+/*! @name CR - GPT Control Register */
+/*! @{ */
+
+#define GPT_CR_EN_MASK                           (0x1U)
+#define GPT_CR_EN_SHIFT                          (0U)
+/*! EN
+ *  0b0..GPT is disabled.
+ *  0b1..GPT is enabled.
+ */
+#define GPT_CR_EN(x)                             (((uint32_t)(((uint32_t)(x)) << GPT_CR_EN_SHIFT)) & GPT_CR_EN_MASK)
+
+#define GPT_CR_ENMOD_MASK                        (0x2U)
+#define GPT_CR_ENMOD_SHIFT                       (1U)
+/*! ENMOD
+ *  0b0..GPT counter will retain its value when it is disabled.
+ *  0b1..GPT counter value is reset to 0 when it is disabled.
+ */
+#define GPT_CR_ENMOD(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_CR_ENMOD_SHIFT)) & GPT_CR_ENMOD_MASK)
+
+#define GPT_CR_DBGEN_MASK                        (0x4U)
+#define GPT_CR_DBGEN_SHIFT                       (2U)
+/*! DBGEN
+ *  0b0..GPT is disabled in debug mode.
+ *  0b1..GPT is enabled in debug mode.
+ */
+#define GPT_CR_DBGEN(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_CR_DBGEN_SHIFT)) & GPT_CR_DBGEN_MASK)
+
+#define GPT_CR_WAITEN_MASK                       (0x8U)
+#define GPT_CR_WAITEN_SHIFT                      (3U)
+/*! WAITEN
+ *  0b0..GPT is disabled in wait mode.
+ *  0b1..GPT is enabled in wait mode.
+ */
+#define GPT_CR_WAITEN(x)                         (((uint32_t)(((uint32_t)(x)) << GPT_CR_WAITEN_SHIFT)) & GPT_CR_WAITEN_MASK)
+
+#define GPT_CR_DOZEEN_MASK                       (0x10U)
+#define GPT_CR_DOZEEN_SHIFT                      (4U)
+/*! DOZEEN
+ *  0b0..GPT is disabled in doze mode.
+ *  0b1..GPT is enabled in doze mode.
+ */
+#define GPT_CR_DOZEEN(x)                         (((uint32_t)(((uint32_t)(x)) << GPT_CR_DOZEEN_SHIFT)) & GPT_CR_DOZEEN_MASK)
+
+#define GPT_CR_STOPEN_MASK                       (0x20U)
+#define GPT_CR_STOPEN_SHIFT                      (5U)
+/*! STOPEN
+ *  0b0..GPT is disabled in Stop mode.
+ *  0b1..GPT is enabled in Stop mode.
+ */
+#define GPT_CR_STOPEN(x)                         (((uint32_t)(((uint32_t)(x)) << GPT_CR_STOPEN_SHIFT)) & GPT_CR_STOPEN_MASK)
+
+#define GPT_CR_CLKSRC_MASK                       (0x1C0U)
+#define GPT_CR_CLKSRC_SHIFT                      (6U)
+/*! CLKSRC
+ *  0b000..No clock
+ *  0b001..Peripheral Clock (ipg_clk)
+ *  0b010..High Frequency Reference Clock (ipg_clk_highfreq)
+ *  0b011..External Clock
+ *  0b100..Low Frequency Reference Clock (ipg_clk_32k)
+ *  0b101..Crystal oscillator as Reference Clock (ipg_clk_24M)
+ */
+#define GPT_CR_CLKSRC(x)                         (((uint32_t)(((uint32_t)(x)) << GPT_CR_CLKSRC_SHIFT)) & GPT_CR_CLKSRC_MASK)
+
+#define GPT_CR_FRR_MASK                          (0x200U)
+#define GPT_CR_FRR_SHIFT                         (9U)
+/*! FRR
+ *  0b0..Restart mode
+ *  0b1..Free-Run mode
+ */
+#define GPT_CR_FRR(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_FRR_SHIFT)) & GPT_CR_FRR_MASK)
+
+#define GPT_CR_EN_24M_MASK                       (0x400U)
+#define GPT_CR_EN_24M_SHIFT                      (10U)
+/*! EN_24M
+ *  0b0..24M clock disabled
+ *  0b1..24M clock enabled
+ */
+#define GPT_CR_EN_24M(x)                         (((uint32_t)(((uint32_t)(x)) << GPT_CR_EN_24M_SHIFT)) & GPT_CR_EN_24M_MASK)
+
+#define GPT_CR_SWR_MASK                          (0x8000U)
+#define GPT_CR_SWR_SHIFT                         (15U)
+/*! SWR
+ *  0b0..GPT is not in reset state
+ *  0b1..GPT is in reset state
+ */
+#define GPT_CR_SWR(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_SWR_SHIFT)) & GPT_CR_SWR_MASK)
+
+#define GPT_CR_IM1_MASK                          (0x30000U)
+#define GPT_CR_IM1_SHIFT                         (16U)
+#define GPT_CR_IM1(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_IM1_SHIFT)) & GPT_CR_IM1_MASK)
+
+#define GPT_CR_IM2_MASK                          (0xC0000U)
+#define GPT_CR_IM2_SHIFT                         (18U)
+/*! IM2
+ *  0b00..capture disabled
+ *  0b01..capture on rising edge only
+ *  0b10..capture on falling edge only
+ *  0b11..capture on both edges
+ */
+#define GPT_CR_IM2(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_IM2_SHIFT)) & GPT_CR_IM2_MASK)
+
+#define GPT_CR_OM1_MASK                          (0x700000U)
+#define GPT_CR_OM1_SHIFT                         (20U)
+#define GPT_CR_OM1(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_OM1_SHIFT)) & GPT_CR_OM1_MASK)
+
+#define GPT_CR_OM2_MASK                          (0x3800000U)
+#define GPT_CR_OM2_SHIFT                         (23U)
+#define GPT_CR_OM2(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_OM2_SHIFT)) & GPT_CR_OM2_MASK)
+
+#define GPT_CR_OM3_MASK                          (0x1C000000U)
+#define GPT_CR_OM3_SHIFT                         (26U)
+/*! OM3
+ *  0b000..Output disconnected. No response on pin.
+ *  0b001..Toggle output pin
+ *  0b010..Clear output pin
+ *  0b011..Set output pin
+ *  0b1xx..Generate an active low pulse (that is one input clock wide) on the output pin.
+ */
+#define GPT_CR_OM3(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_OM3_SHIFT)) & GPT_CR_OM3_MASK)
+
+#define GPT_CR_FO1_MASK                          (0x20000000U)
+#define GPT_CR_FO1_SHIFT                         (29U)
+#define GPT_CR_FO1(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_FO1_SHIFT)) & GPT_CR_FO1_MASK)
+
+#define GPT_CR_FO2_MASK                          (0x40000000U)
+#define GPT_CR_FO2_SHIFT                         (30U)
+#define GPT_CR_FO2(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_FO2_SHIFT)) & GPT_CR_FO2_MASK)
+
+#define GPT_CR_FO3_MASK                          (0x80000000U)
+#define GPT_CR_FO3_SHIFT                         (31U)
+/*! FO3
+ *  0b0..Writing a 0 has no effect.
+ *  0b1..Causes the programmed pin action on the timer Output Compare n pin; the OFn flag is not set.
+ */
+#define GPT_CR_FO3(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_CR_FO3_SHIFT)) & GPT_CR_FO3_MASK)
+/*! @} */
+
+/*! @name PR - GPT Prescaler Register */
+/*! @{ */
+
+#define GPT_PR_PRESCALER_MASK                    (0xFFFU)
+#define GPT_PR_PRESCALER_SHIFT                   (0U)
+/*! PRESCALER
+ *  0b000000000000..Divide by 1
+ *  0b000000000001..Divide by 2
+ *  0b111111111111..Divide by 4096
+ */
+#define GPT_PR_PRESCALER(x)                      (((uint32_t)(((uint32_t)(x)) << GPT_PR_PRESCALER_SHIFT)) & GPT_PR_PRESCALER_MASK)
+
+#define GPT_PR_PRESCALER24M_MASK                 (0xF000U)
+#define GPT_PR_PRESCALER24M_SHIFT                (12U)
+/*! PRESCALER24M
+ *  0b0000..Divide by 1
+ *  0b0001..Divide by 2
+ *  0b1111..Divide by 16
+ */
+#define GPT_PR_PRESCALER24M(x)                   (((uint32_t)(((uint32_t)(x)) << GPT_PR_PRESCALER24M_SHIFT)) & GPT_PR_PRESCALER24M_MASK)
+/*! @} */
+
+/*! @name SR - GPT Status Register */
+/*! @{ */
+
+#define GPT_SR_OF1_MASK                          (0x1U)
+#define GPT_SR_OF1_SHIFT                         (0U)
+#define GPT_SR_OF1(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_SR_OF1_SHIFT)) & GPT_SR_OF1_MASK)
+
+#define GPT_SR_OF2_MASK                          (0x2U)
+#define GPT_SR_OF2_SHIFT                         (1U)
+#define GPT_SR_OF2(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_SR_OF2_SHIFT)) & GPT_SR_OF2_MASK)
+
+#define GPT_SR_OF3_MASK                          (0x4U)
+#define GPT_SR_OF3_SHIFT                         (2U)
+/*! OF3
+ *  0b0..Compare event has not occurred.
+ *  0b1..Compare event has occurred.
+ */
+#define GPT_SR_OF3(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_SR_OF3_SHIFT)) & GPT_SR_OF3_MASK)
+
+#define GPT_SR_IF1_MASK                          (0x8U)
+#define GPT_SR_IF1_SHIFT                         (3U)
+#define GPT_SR_IF1(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_SR_IF1_SHIFT)) & GPT_SR_IF1_MASK)
+
+#define GPT_SR_IF2_MASK                          (0x10U)
+#define GPT_SR_IF2_SHIFT                         (4U)
+/*! IF2
+ *  0b0..Capture event has not occurred.
+ *  0b1..Capture event has occurred.
+ */
+#define GPT_SR_IF2(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_SR_IF2_SHIFT)) & GPT_SR_IF2_MASK)
+
+#define GPT_SR_ROV_MASK                          (0x20U)
+#define GPT_SR_ROV_SHIFT                         (5U)
+/*! ROV
+ *  0b0..Rollover has not occurred.
+ *  0b1..Rollover has occurred.
+ */
+#define GPT_SR_ROV(x)                            (((uint32_t)(((uint32_t)(x)) << GPT_SR_ROV_SHIFT)) & GPT_SR_ROV_MASK)
+/*! @} */
+
+/*! @name IR - GPT Interrupt Register */
+/*! @{ */
+
+#define GPT_IR_OF1IE_MASK                        (0x1U)
+#define GPT_IR_OF1IE_SHIFT                       (0U)
+#define GPT_IR_OF1IE(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_IR_OF1IE_SHIFT)) & GPT_IR_OF1IE_MASK)
+
+#define GPT_IR_OF2IE_MASK                        (0x2U)
+#define GPT_IR_OF2IE_SHIFT                       (1U)
+#define GPT_IR_OF2IE(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_IR_OF2IE_SHIFT)) & GPT_IR_OF2IE_MASK)
+
+#define GPT_IR_OF3IE_MASK                        (0x4U)
+#define GPT_IR_OF3IE_SHIFT                       (2U)
+/*! OF3IE
+ *  0b0..Output Compare Channel n interrupt is disabled.
+ *  0b1..Output Compare Channel n interrupt is enabled.
+ */
+#define GPT_IR_OF3IE(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_IR_OF3IE_SHIFT)) & GPT_IR_OF3IE_MASK)
+
+#define GPT_IR_IF1IE_MASK                        (0x8U)
+#define GPT_IR_IF1IE_SHIFT                       (3U)
+#define GPT_IR_IF1IE(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_IR_IF1IE_SHIFT)) & GPT_IR_IF1IE_MASK)
+
+#define GPT_IR_IF2IE_MASK                        (0x10U)
+#define GPT_IR_IF2IE_SHIFT                       (4U)
+/*! IF2IE
+ *  0b0..IF2IE Input Capture n Interrupt Enable is disabled.
+ *  0b1..IF2IE Input Capture n Interrupt Enable is enabled.
+ */
+#define GPT_IR_IF2IE(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_IR_IF2IE_SHIFT)) & GPT_IR_IF2IE_MASK)
+
+#define GPT_IR_ROVIE_MASK                        (0x20U)
+#define GPT_IR_ROVIE_SHIFT                       (5U)
+/*! ROVIE
+ *  0b0..Rollover interrupt is disabled.
+ *  0b1..Rollover interrupt enabled.
+ */
+#define GPT_IR_ROVIE(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_IR_ROVIE_SHIFT)) & GPT_IR_ROVIE_MASK)
+/*! @} */
+
+/*! @name OCR - GPT Output Compare Register 1..GPT Output Compare Register 3 */
+/*! @{ */
+
+#define GPT_OCR_COMP_MASK                        (0xFFFFFFFFU)
+#define GPT_OCR_COMP_SHIFT                       (0U)
+#define GPT_OCR_COMP(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_OCR_COMP_SHIFT)) & GPT_OCR_COMP_MASK)
+/*! @} */
+
+/* The count of GPT_OCR */
+#define GPT_OCR_COUNT                            (3U)
+
+/*! @name ICR - GPT Input Capture Register 1..GPT Input Capture Register 2 */
+/*! @{ */
+
+#define GPT_ICR_CAPT_MASK                        (0xFFFFFFFFU)
+#define GPT_ICR_CAPT_SHIFT                       (0U)
+#define GPT_ICR_CAPT(x)                          (((uint32_t)(((uint32_t)(x)) << GPT_ICR_CAPT_SHIFT)) & GPT_ICR_CAPT_MASK)
+/*! @} */
+
+/* The count of GPT_ICR */
+#define GPT_ICR_COUNT                            (2U)
+
+/*! @name CNT - GPT Counter Register */
+/*! @{ */
+
+#define GPT_CNT_COUNT_MASK                       (0xFFFFFFFFU)
+#define GPT_CNT_COUNT_SHIFT                      (0U)
+#define GPT_CNT_COUNT(x)                         (((uint32_t)(((uint32_t)(x)) << GPT_CNT_COUNT_SHIFT)) & GPT_CNT_COUNT_MASK)
+/*! @} */
+
+
+/*!
+ * @}
+ */ /* end of group GPT_Register_Masks */
+
+
+/* GPT - Peripheral instance base addresses */
+/** Peripheral GPT1 base address */
+#ifndef GPT1_BASE
+#define GPT1_BASE                                (0x401EC000u)
+#endif
+/** Peripheral GPT1 base pointer */
+#define GPT1                                     ((GPT_Type *)GPT1_BASE)
+/** Peripheral GPT2 base address */
+#ifndef GPT2_BASE
+#define GPT2_BASE                                (0x401F0000u)
+#endif
+/** Peripheral GPT2 base pointer */
+#define GPT2                                     ((GPT_Type *)GPT2_BASE)
+/** Array initializer of GPT peripheral base addresses */
+#define GPT_BASE_ADDRS                           { 0u, GPT1_BASE, GPT2_BASE }
+/** Array initializer of GPT peripheral base pointers */
+#define GPT_BASE_PTRS                            { (GPT_Type *)0u, GPT1, GPT2 }
+/** Interrupt vectors for the GPT peripheral type */
+#define GPT_IRQS                                 { NotAvail_IRQn, GPT1_IRQn, GPT2_IRQn }
+
+/*!
+ * @}
+ */ /* end of group GPT_Peripheral_Access_Layer */
+
+
+/* ----------------------------------------------------------------------------
+   -- PIT Peripheral Access Layer
+   ---------------------------------------------------------------------------- */
+
+/*!
+ * @addtogroup PIT_Peripheral_Access_Layer PIT Peripheral Access Layer
+ * @{
+ */
+
+/** PIT - Register Layout Typedef */
+typedef struct {
+  __IO uint32_t MCR;                               /**< PIT Module Control Register, offset: 0x0 */
+       uint8_t RESERVED_0[220];
+  __I  uint32_t LTMR64H;                           /**< PIT Upper Lifetime Timer Register, offset: 0xE0 */
+  __I  uint32_t LTMR64L;                           /**< PIT Lower Lifetime Timer Register, offset: 0xE4 */
+       uint8_t RESERVED_1[24];
+  struct {                                         /* offset: 0x100, array step: 0x10 */
+    __IO uint32_t LDVAL;                             /**< Timer Load Value Register, array offset: 0x100, array step: 0x10 */
+    __I  uint32_t CVAL;                              /**< Current Timer Value Register, array offset: 0x104, array step: 0x10 */
+    __IO uint32_t TCTRL;                             /**< Timer Control Register, array offset: 0x108, array step: 0x10 */
+    __IO uint32_t TFLG;                              /**< Timer Flag Register, array offset: 0x10C, array step: 0x10 */
+  } CHANNEL[4];
+} PIT_Type;
+
+/* ----------------------------------------------------------------------------
+   -- PIT Register Masks
+   ---------------------------------------------------------------------------- */
+
+/*!
+ * @addtogroup PIT_Register_Masks PIT Register Masks
+ * @{
+ */
+
+/*! @name MCR - PIT Module Control Register */
+/*! @{ */
+
+#define PIT_MCR_FRZ_MASK                         (0x1U)
+#define PIT_MCR_FRZ_SHIFT                        (0U)
+/*! FRZ - Freeze
+ *  0b0..Timers continue to run in Debug mode.
+ *  0b1..Timers are stopped in Debug mode.
+ */
+#define PIT_MCR_FRZ(x)                           (((uint32_t)(((uint32_t)(x)) << PIT_MCR_FRZ_SHIFT)) & PIT_MCR_FRZ_MASK)
+
+#define PIT_MCR_MDIS_MASK                        (0x2U)
+#define PIT_MCR_MDIS_SHIFT                       (1U)
+/*! MDIS - Module Disable - (PIT section)
+ *  0b0..Clock for standard PIT timers is enabled.
+ *  0b1..Clock for standard PIT timers is disabled.
+ */
+#define PIT_MCR_MDIS(x)                          (((uint32_t)(((uint32_t)(x)) << PIT_MCR_MDIS_SHIFT)) & PIT_MCR_MDIS_MASK)
+/*! @} */
+
+/*! @name LTMR64H - PIT Upper Lifetime Timer Register */
+/*! @{ */
+
+#define PIT_LTMR64H_LTH_MASK                     (0xFFFFFFFFU)
+#define PIT_LTMR64H_LTH_SHIFT                    (0U)
+/*! LTH - Life Timer value
+ */
+#define PIT_LTMR64H_LTH(x)                       (((uint32_t)(((uint32_t)(x)) << PIT_LTMR64H_LTH_SHIFT)) & PIT_LTMR64H_LTH_MASK)
+/*! @} */
+
+/*! @name LTMR64L - PIT Lower Lifetime Timer Register */
+/*! @{ */
+
+#define PIT_LTMR64L_LTL_MASK                     (0xFFFFFFFFU)
+#define PIT_LTMR64L_LTL_SHIFT                    (0U)
+/*! LTL - Life Timer value
+ */
+#define PIT_LTMR64L_LTL(x)                       (((uint32_t)(((uint32_t)(x)) << PIT_LTMR64L_LTL_SHIFT)) & PIT_LTMR64L_LTL_MASK)
+/*! @} */
+
+/*! @name LDVAL - Timer Load Value Register */
+/*! @{ */
+
+#define PIT_LDVAL_TSV_MASK                       (0xFFFFFFFFU)
+#define PIT_LDVAL_TSV_SHIFT                      (0U)
+/*! TSV - Timer Start Value
+ */
+#define PIT_LDVAL_TSV(x)                         (((uint32_t)(((uint32_t)(x)) << PIT_LDVAL_TSV_SHIFT)) & PIT_LDVAL_TSV_MASK)
+/*! @} */
+
+/* The count of PIT_LDVAL */
+#define PIT_LDVAL_COUNT                          (4U)
+
+/*! @name CVAL - Current Timer Value Register */
+/*! @{ */
+
+#define PIT_CVAL_TVL_MASK                        (0xFFFFFFFFU)
+#define PIT_CVAL_TVL_SHIFT                       (0U)
+/*! TVL - Current Timer Value
+ */
+#define PIT_CVAL_TVL(x)                          (((uint32_t)(((uint32_t)(x)) << PIT_CVAL_TVL_SHIFT)) & PIT_CVAL_TVL_MASK)
+/*! @} */
+
+/* The count of PIT_CVAL */
+#define PIT_CVAL_COUNT                           (4U)
+
+/*! @name TCTRL - Timer Control Register */
+/*! @{ */
+
+#define PIT_TCTRL_TEN_MASK                       (0x1U)
+#define PIT_TCTRL_TEN_SHIFT                      (0U)
+/*! TEN - Timer Enable
+ *  0b0..Timer n is disabled.
+ *  0b1..Timer n is enabled.
+ */
+#define PIT_TCTRL_TEN(x)                         (((uint32_t)(((uint32_t)(x)) << PIT_TCTRL_TEN_SHIFT)) & PIT_TCTRL_TEN_MASK)
+
+#define PIT_TCTRL_TIE_MASK                       (0x2U)
+#define PIT_TCTRL_TIE_SHIFT                      (1U)
+/*! TIE - Timer Interrupt Enable
+ *  0b0..Interrupt requests from Timer n are disabled.
+ *  0b1..Interrupt will be requested whenever TIF is set.
+ */
+#define PIT_TCTRL_TIE(x)                         (((uint32_t)(((uint32_t)(x)) << PIT_TCTRL_TIE_SHIFT)) & PIT_TCTRL_TIE_MASK)
+
+#define PIT_TCTRL_CHN_MASK                       (0x4U)
+#define PIT_TCTRL_CHN_SHIFT                      (2U)
+/*! CHN - Chain Mode
+ *  0b0..Timer is not chained.
+ *  0b1..Timer is chained to previous timer. For example, for Channel 2, if this field is set, Timer 2 is chained to Timer 1.
+ */
+#define PIT_TCTRL_CHN(x)                         (((uint32_t)(((uint32_t)(x)) << PIT_TCTRL_CHN_SHIFT)) & PIT_TCTRL_CHN_MASK)
+/*! @} */
+
+/* The count of PIT_TCTRL */
+#define PIT_TCTRL_COUNT                          (4U)
+
+/*! @name TFLG - Timer Flag Register */
+/*! @{ */
+
+#define PIT_TFLG_TIF_MASK                        (0x1U)
+#define PIT_TFLG_TIF_SHIFT                       (0U)
+/*! TIF - Timer Interrupt Flag
+ *  0b0..Timeout has not yet occurred.
+ *  0b1..Timeout has occurred.
+ */
+#define PIT_TFLG_TIF(x)                          (((uint32_t)(((uint32_t)(x)) << PIT_TFLG_TIF_SHIFT)) & PIT_TFLG_TIF_MASK)
+/*! @} */
+
+/* The count of PIT_TFLG */
+#define PIT_TFLG_COUNT                           (4U)
+
+
+/*!
+ * @}
+ */ /* end of group PIT_Register_Masks */
+
+
+/* PIT - Peripheral instance base addresses */
+/** Peripheral PIT base address */
+#ifndef PIT_BASE
+#define PIT_BASE                                 (0x40084000u)
+#endif
+/** Peripheral PIT base pointer */
+#define PIT                                      ((PIT_Type *)PIT_BASE)
+/** Array initializer of PIT peripheral base addresses */
+#define PIT_BASE_ADDRS                           { PIT_BASE }
+/** Array initializer of PIT peripheral base pointers */
+#define PIT_BASE_PTRS                            { PIT }
+/** Interrupt vectors for the PIT peripheral type */
+#define PIT_IRQS                                 { { PIT_IRQn, PIT_IRQn, PIT_IRQn, PIT_IRQn } }
+
+/*!
+ * @}
+ */ /* end of group PIT_Peripheral_Access_Layer */
+
 #endif /* APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3DMA_H_ */
 
@@ -0,0 +1,109 @@
+/*
+ * spi3DMAApi.h
+ *
+ *  Created on: Feb 6, 2023
+ *      Author: TBiberdorf
+ *
+ *  Public interface of spi3DMA.c.  spi3DMA.h carries its own copy of the
+ *  register definitions and therefore can not be included next to
+ *  fsl_device_registers.h, so the application includes this file instead.
+ */
+
+#ifndef APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3DMAAPI_H_
+#define APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3DMAAPI_H_
+
+#include <stdint.h>
+
+#define SPI3_MAX_CITER          (0x7FFF) // 15 bit CITER/BITER with channel linking disabled
+#define SPI3_MAX_FRAME_SEGMENTS (8)      // scatter-gather TCDs used for frames longer than SPI3_MAX_CITER
+#define SPI3_MAX_FRAME_LENGTH   (SPI3_MAX_CITER * SPI3_MAX_FRAME_SEGMENTS)
+#define SPI3_RX_RING_MAX_SLOTS  (16)     // deepest Rx ring SetSPI3RxRing() accepts
+#define SPI3_TIMESTAMP_HZ       (75000000) // GPT1 on PERCLK_CLK_ROOT, see clock_config.c
+#define SPI3_TRIGGER_LOG_SIZE   (256)    // triggers kept by the overrun log, power of 2
+#define SPI3_LPSPI_CLK_HZ       (105600000) // LPSPI_CLK_ROOT, see clock_config.c
+#define SPI3_INSTANCE_COUNT     (4)      // LPSPI1..LPSPI4
+#define SPI3_RX_STREAM_MIN_LOG2 (5)      // smallest Rx stream buffer SetSPI3RxStream() accepts, 32 bytes
+#define SPI3_RX_STREAM_MAX_LOG2 (24)     // largest, 16 MiB for the SEMC SDRAM
+
+/*
+ * Build option, 1 runs the frame re-arm, the Rx completion path and the DMA vectors
+ * from ITCM instead of the FlexSPI XIP flash.  Set it in the compiler defines.
+ */
+#ifndef SPI3_HOT_PATH_ITCM
+#define SPI3_HOT_PATH_ITCM      (0)
+#endif
+
+/*!
+ * @brief Triggered DMA stream of one LPSPI instance
+ *
+ * Holds the LPSPI base, the six eDMA channels, the TCD images and the Rx ring state
+ * of the instance.  Get it from GetSPI3Handle(), every other call takes it as first
+ * argument so the LPSPI instances run their streams independently.  The Rx interrupt
+ * of LPSPI3 (channel 0) and LPSPI2 (channel 16) is DMA0_DMA16_IRQn, the one of
+ * LPSPI1 (channel 8) and LPSPI4 (channel 24) is DMA8_DMA24_IRQn.
+ */
+typedef struct _spi3dma_handle spi3dma_handle_t;
+
+/*!
+ * @brief One triggered LPSPI3 frame
+ *
+ * length bytes are clocked out of txBuffer and captured into rxBuffer for every trigger.
+ */
+typedef struct _spi3_frame
+{
+	uint32_t length;   /*!< bytes per frame, 1..SPI3_MAX_FRAME_LENGTH */
+	uint8_t *txBuffer; /*!< data sent on MOSI */
+	uint8_t *rxBuffer; /*!< data captured from MISO */
+} spi3_frame_t;
+
+/*!
+ * @brief Captured frame handed out by GetSPI3RxFrame()
+ *
+ * data points into the Rx ring, the slot is not reused before ReleaseSPI3RxFrame().
+ */
+typedef struct _spi3_rx_frame
+{
+	uint32_t sequence; /*!< frame number since the ring was set up */
+	uint32_t length;   /*!< bytes in data */
+	uint8_t *data;     /*!< ring slot holding the frame */
+	uint32_t timestamp; /*!< GPT1 count at frame end, see EnableSPI3FrameTimestamp() */
+} spi3_rx_frame_t;
+
+spi3dma_handle_t *GetSPI3Handle(uint32_t lpspiInstance);
+void InitClocks();
+void InitSPI3Peripheral(spi3dma_handle_t *handle);
+void TxTest(spi3dma_handle_t *handle);
+void InitDMAandEDMA(spi3dma_handle_t *handle);
+void InitGPIOTrigger(spi3dma_handle_t *handle, uint8_t xbarInput);
+void StopGPIOTrigger(spi3dma_handle_t *handle);
+int32_t InitPITTrigger(spi3dma_handle_t *handle, uint32_t periodUs);
+void StopPITTrigger(spi3dma_handle_t *handle);
+void RestSPI3Peripheral(spi3dma_handle_t *handle, uint8_t *ptrTxBuffer,uint8_t *ptrRxBuffer);
+int32_t SetSPI3Frame(spi3dma_handle_t *handle, const spi3_frame_t *frame);
+int32_t SetSPI3WordMode(spi3dma_handle_t *handle, uint8_t enable);
+int32_t SetSPI3RxRing(spi3dma_handle_t *handle, uint8_t *ringBuffer, uint32_t slotCount);
+int32_t SetSPI3RxStream(spi3dma_handle_t *handle, uint8_t *streamBuffer, uint32_t sizeLog2);
+uint32_t GetSPI3RxStreamWriteIndex(spi3dma_handle_t *handle);
+uint32_t GetSPI3RxProducerIndex(spi3dma_handle_t *handle);
+int32_t SetSPI3RxBatch(spi3dma_handle_t *handle, uint32_t batchFrames);
+uint32_t FlushSPI3RxBatch(spi3dma_handle_t *handle);
+int32_t GetSPI3RxFrame(spi3dma_handle_t *handle, spi3_rx_frame_t *frame);
+int32_t ReleaseSPI3RxFrame(spi3dma_handle_t *handle, const spi3_rx_frame_t *frame);
+uint32_t GetSPI3RxPauseCount(spi3dma_handle_t *handle);
+void EnableSPI3FrameTimestamp(spi3dma_handle_t *handle);
+uint32_t GetSPI3RxTimestamp(spi3dma_handle_t *handle, uint32_t sequence);
+uint32_t GetSPI3RxIrqCycles(spi3dma_handle_t *handle);
+uint32_t GetSPI3IsrCycles(spi3dma_handle_t *handle);
+uint32_t GetSPI3IsrMaxCycles(spi3dma_handle_t *handle);
+void EnableSPI3OverrunLog(spi3dma_handle_t *handle);
+uint32_t GetSPI3TriggerLogIndex(spi3dma_handle_t *handle);
+uint32_t CountSPI3Overruns(spi3dma_handle_t *handle, uint32_t first, uint32_t last);
+void SetSPI3SckDivider(spi3dma_handle_t *handle, uint8_t sckDivider);
+void SetSPI3PriorityProfile(spi3dma_handle_t *handle, uint8_t enable);
+int32_t SetSPI3BulkChannel(uint32_t channel, uint8_t enable);
+uint8_t *GetSPI3RxSlot(spi3dma_handle_t *handle, uint32_t index);
+void SetSPI3RxCacheMaintenance(spi3dma_handle_t *handle, uint8_t enable);
+void BenchmarkTcdRearm(spi3dma_handle_t *handle, uint32_t *fieldCycles, uint32_t *imageCycles);
+void DMA_irq(spi3dma_handle_t *handle);
+
+#endif /* APPLICATIONS_NGRMSENSORSOURCE_SOURCE_SPI3DMAAPI_H_ */
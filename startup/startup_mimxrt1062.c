@@ -647,6 +647,20 @@ extern unsigned int __data_section_table_end;
 extern unsigned int __bss_section_table;
 extern unsigned int __bss_section_table_end;
 
+//*****************************************************************************
+// FlexRAM layout applied by ResetISR() in place of the fuse default (ITCM
+// 128 KiB, DTCM 128 KiB, OCRAM 256 KiB). 16 banks of 32 KiB, two bits per bank
+// in IOMUXC_GPR17 (01 OCRAM, 10 DTCM, 11 ITCM):
+//   banks 0-1   ITCM  64 KiB, hot path and vector table
+//   banks 2-9   DTCM 256 KiB, capture buffers
+//   banks 10-15 OCRAM 192 KiB, after the 512 KiB OCRAM2 at 0x20200000
+// The SRAM_ITC, SRAM_DTC and SRAM_OC memory regions of the project and the
+// MPU regions in BOARD_ConfigMPU() are sized to match, change them together.
+//*****************************************************************************
+#define FLEXRAM_BANK_CFG  (0x555AAAAFU)
+#define FLEXRAM_ITCM_SZ   (0x7U) // CM7_CFGITCMSZ, 64 KiB
+#define FLEXRAM_DTCM_SZ   (0x9U) // CM7_CFGDTCMSZ, 256 KiB
+
 //*****************************************************************************
 // Reset entry point for your code.
 // Sets up a simple runtime environment and initializes the C/C++
@@ -658,6 +672,16 @@ void ResetISR(void) {
     // Disable interrupts
     __asm volatile ("cpsid i");
 
+    // Repartition FlexRAM before the stack or any section lives in it, the
+    // banks that change type lose their content. Constants only, no stack.
+    *((volatile unsigned int *)0x400AC044) = FLEXRAM_BANK_CFG;          // IOMUXC_GPR17
+    *((volatile unsigned int *)0x400AC040) |= (1 << 2);                 // IOMUXC_GPR16 FLEXRAM_BANK_CFG_SEL
+    *((volatile unsigned int *)0x400AC038) =                            // IOMUXC_GPR14 TCM sizes
+        (*((volatile unsigned int *)0x400AC038) & ~0x00FF0000) |
+        (FLEXRAM_DTCM_SZ << 20) | (FLEXRAM_ITCM_SZ << 16);
+    __asm volatile ("dsb");
+    __asm volatile ("isb");
+
     __asm volatile ("MSR MSP, %0" : : "r" (&_vStackTop) : );
 
 #if defined (__USE_CMSIS)
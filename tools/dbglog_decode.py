@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Turn the debug console stream of a DBG_LOG() build back into text.
+
+Plain text passes through unchanged, every binary record (see source/dbgLog.h)
+is replaced by its format string from the ELF filled with the logged
+arguments, prefixed with the DWT timestamp.
+
+    dbglog_decode.py Debug/SPI3_DMA_Example.axf capture.bin
+    dbglog_decode.py Debug/SPI3_DMA_Example.axf /dev/ttyACM0 --baud 115200
+
+Reading a serial port needs pyserial, a file or '-' (stdin) does not.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+RECORD_MARKER = 0xF0
+MAX_ARGS = 4
+HEADER_SIZE = 9
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l)?([diuxXocp%])')
+
+
+class ElfImage:
+    """Sections of a 32 bit little endian ELF with an address, read by address.
+
+    Besides the loaded ones that is the .dbglog INFO section of linkscripts/user.ldt.
+    """
+
+    def __init__(self, path):
+        with open(path, 'rb') as elf:
+            self.data = elf.read()
+        if self.data[:4] != b'\x7fELF' or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError('%s is not a 32 bit little endian ELF' % path)
+        shoff, = struct.unpack_from('<I', self.data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.data, 0x2E)
+        self.sections = []
+        for idx in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = struct.unpack_from(
+                '<IIIIII', self.data, shoff + idx * shentsize)
+            if ((flags & SHF_ALLOC) or addr) and sh_type != SHT_NOBITS and size:
+                self.sections.append((addr, offset, size))
+
+    def string_at(self, address):
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.index(b'\0', start, offset + size)
+                return self.data[start:end].decode('ascii', 'replace')
+        return None
+
+
+def format_record(fmt, args):
+    """printf the 32 bit arguments the way the target would have."""
+    values = iter(args)
+
+    def convert(match):
+        flags, _, kind = match.groups()
+        if kind == '%':
+            return '%'
+        value = next(values, 0)
+        if kind in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+            kind = 'd'
+        elif kind == 'u':
+            kind = 'd'
+        elif kind == 'p':
+            return '0x%08x' % value
+        elif kind == 'c':
+            return chr(value & 0xFF)
+        return ('%' + flags + kind) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode_records(pending, elf, clock_hz, out):
+    """Write text and records from pending, return how many bytes were used.
+
+    A record that is not complete yet is left for the next call.
+    """
+    pos = 0
+    while pos < len(pending):
+        byte = pending[pos]
+        if (byte & 0xF0) != RECORD_MARKER or (byte & 0x0F) > MAX_ARGS:
+            out.write(chr(byte) if byte < 0x80 else '\\x%02x' % byte)
+            pos += 1
+            continue
+        count = byte & 0x0F
+        length = HEADER_SIZE + 4 * count
+        if len(pending) - pos < length:
+            break
+        token, timestamp = struct.unpack_from('<II', pending, pos + 1)
+        args = struct.unpack_from('<%dI' % count, pending, pos + HEADER_SIZE)
+        fmt = elf.string_at(token)
+        if fmt is None:
+            out.write('[unknown token 0x%08x %s]\n' % (token, ' '.join('%08x' % a for a in args)))
+        else:
+            out.write('[%12.6f] %s' % (timestamp / clock_hz, format_record(fmt, args)))
+        pos += length
+    return pos
+
+
+def decode(stream, elf, clock_hz, out, follow=False):
+    """Decode until the end of a file, or forever when following a port."""
+    pending = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if follow:
+                continue  # read timed out with nothing new
+            break
+        pending += chunk
+        del pending[:decode_records(pending, elf, clock_hz, out)]
+        out.flush()
+
+
+def open_input(name, baud):
+    """Return the stream and whether an empty read means the end of it."""
+    if name == '-':
+        return sys.stdin.buffer, False
+    if name.startswith('/dev/') or name.upper().startswith('COM'):
+        import serial
+        # a short timeout hands out what came in so far instead of waiting for 256 bytes
+        return serial.Serial(name, baud, timeout=0.1), True
+    return open(name, 'rb'), False
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('elf', help='the .axf the target runs')
+    parser.add_argument('input', help="capture file, serial port or '-' for stdin")
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--clock', type=float, default=600e6, help='core clock the DWT timestamps count, Hz')
+    options = parser.parse_args()
+
+    stream, follow = open_input(options.input, options.baud)
+    decode(stream, ElfImage(options.elf), options.clock, sys.stdout, follow)
+
+
+if __name__ == '__main__':
+    main()
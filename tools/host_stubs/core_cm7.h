@@ -0,0 +1,67 @@
+/*
+ * Host stand-in for the core debug blocks of core_cm7.h the debug console
+ * uses with kSerialPort_Swo.  The registers are plain memory in itm_stub.c,
+ * stimulus port stores are turned into the ITM packets the TPIU would send.
+ */
+
+#ifndef __CORE_CM7_H_GENERIC
+#define __CORE_CM7_H_GENERIC
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+    volatile union
+    {
+        volatile uint8_t u8;
+        volatile uint16_t u16;
+        volatile uint32_t u32;
+    } PORT[32U];
+    volatile uint32_t TER;
+    volatile uint32_t TPR;
+    volatile uint32_t TCR;
+    volatile uint32_t LAR;
+} ITM_Type;
+
+typedef struct
+{
+    volatile uint32_t ACPR;
+    volatile uint32_t SPPR;
+    volatile uint32_t FFCR;
+} TPI_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern ITM_Type StubItm;
+extern TPI_Type StubTpi;
+extern CoreDebug_Type StubCoreDebug;
+
+#define ITM       (&StubItm)
+#define TPI       (&StubTpi)
+#define CoreDebug (&StubCoreDebug)
+
+#define ITM_TCR_ITMENA_Msk          (1UL)
+#define ITM_TCR_SYNCENA_Msk         (1UL << 2U)
+#define ITM_TCR_TraceBusID_Pos      16U
+#define ITM_TCR_BUSY_Msk            (1UL << 23U)
+#define TPI_ACPR_PRESCALER_Msk      (0x1FFFUL)
+#define TPI_FFCR_TrigIn_Msk         (1UL << 8U)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24U)
+
+/* Stimulus port stores of fsl_debug_console.c, appended to the capture as ITM packets. */
+void StubItmStore(uint32_t port, uint32_t value, uint32_t size);
+#define DEBUG_CONSOLE_ITM_STORE32(port, value) StubItmStore((port), (uint32_t)(value), 4U)
+#define DEBUG_CONSOLE_ITM_STORE8(port, value)  StubItmStore((port), (uint32_t)(value), 1U)
+
+/* Puts the registers back to reset state (ITM off) and empties the capture. */
+void StubItmReset(void);
+/* Appends raw bytes, other packet kinds the SWO pin carries. */
+void StubItmInject(const uint8_t *data, size_t length);
+/* The SWO byte stream so far. */
+size_t StubItmCapture(const uint8_t **data);
+
+#endif /* __CORE_CM7_H_GENERIC */
@@ -0,0 +1,49 @@
+/*
+ * Host stand-in for the UART adapter, printf_bench.c implements the calls and
+ * captures what the debug console sends.
+ */
+
+#ifndef __HAL_UART_ADAPTER_H__
+#define __HAL_UART_ADAPTER_H__
+
+#include "fsl_common.h"
+
+#define HAL_UART_HANDLE_SIZE (8U)
+
+typedef void *hal_uart_handle_t;
+
+typedef enum _hal_uart_status
+{
+    kStatus_HAL_UartSuccess = 0,
+    kStatus_HAL_UartError   = 1,
+} hal_uart_status_t;
+
+typedef enum _hal_uart_parity_mode
+{
+    kHAL_UartParityDisabled = 0,
+} hal_uart_parity_mode_t;
+
+typedef enum _hal_uart_stop_bit_count
+{
+    kHAL_UartOneStopBit = 0,
+} hal_uart_stop_bit_count_t;
+
+typedef struct _hal_uart_config
+{
+    uint32_t srcClock_Hz;
+    uint32_t baudRate_Bps;
+    hal_uart_parity_mode_t parityMode;
+    hal_uart_stop_bit_count_t stopBitCount;
+    uint8_t enableRx;
+    uint8_t enableTx;
+    uint8_t enableRxRTS;
+    uint8_t enableTxCTS;
+    uint8_t instance;
+} hal_uart_config_t;
+
+hal_uart_status_t HAL_UartInit(hal_uart_handle_t handle, const hal_uart_config_t *config);
+hal_uart_status_t HAL_UartDeinit(hal_uart_handle_t handle);
+hal_uart_status_t HAL_UartSendBlocking(hal_uart_handle_t handle, const uint8_t *data, size_t length);
+hal_uart_status_t HAL_UartReceiveBlocking(hal_uart_handle_t handle, uint8_t *data, size_t length);
+
+#endif /* __HAL_UART_ADAPTER_H__ */
@@ -0,0 +1,38 @@
+/*
+ * Host stand-in for the parts of fsl_common.h the debug console uses, lets
+ * the tools build utilities/fsl_debug_console.c with the host compiler.
+ */
+
+#ifndef _FSL_COMMON_H_
+#define _FSL_COMMON_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "core_cm7.h"
+
+typedef int32_t status_t;
+
+enum
+{
+    kStatus_Success = 0,
+    kStatus_Fail    = 1,
+};
+
+/* The console keeps the LPUART of a kSerialPort_Uart console, the host never touches it. */
+typedef struct
+{
+    volatile uint32_t STAT;
+    volatile uint32_t CTRL;
+    volatile uint32_t DATA;
+} LPUART_Type;
+
+#define LPUART_BASE_PTRS      {(LPUART_Type *)0}
+#define LPUART_STAT_OR_MASK   (1U << 19U)
+#define LPUART_STAT_RDRF_MASK (1U << 21U)
+
+#define __DMB() __sync_synchronize()
+#define SDK_ISR_EXIT_BARRIER
+
+#endif /* _FSL_COMMON_H_ */
@@ -0,0 +1,62 @@
+/*
+ * Stub ITM, TPI and CoreDebug register blocks for host builds, see core_cm7.h.
+ */
+
+#include <string.h>
+#include "core_cm7.h"
+
+#define STUB_ITM_CAPTURE_SIZE (4096U)
+
+ITM_Type StubItm;
+TPI_Type StubTpi;
+CoreDebug_Type StubCoreDebug;
+
+static uint8_t stubCapture[STUB_ITM_CAPTURE_SIZE];
+static size_t stubCaptureLength;
+
+void StubItmReset(void)
+{
+    uint32_t port;
+
+    memset((void *)&StubItm, 0, sizeof(StubItm));
+    memset((void *)&StubTpi, 0, sizeof(StubTpi));
+    memset((void *)&StubCoreDebug, 0, sizeof(StubCoreDebug));
+    /* Reads of a stimulus port return FIFOREADY. */
+    for (port = 0; port < 32U; port++)
+    {
+        StubItm.PORT[port].u32 = 1U;
+    }
+    stubCaptureLength = 0;
+}
+
+void StubItmInject(const uint8_t *data, size_t length)
+{
+    if ((stubCaptureLength + length) <= STUB_ITM_CAPTURE_SIZE)
+    {
+        memcpy(&stubCapture[stubCaptureLength], data, length);
+        stubCaptureLength += length;
+    }
+}
+
+/*
+ * Instrumentation packet: header port << 3 | size code (1, 2 or 4 bytes),
+ * then the payload little endian.
+ */
+void StubItmStore(uint32_t port, uint32_t value, uint32_t size)
+{
+    uint8_t packet[5];
+    uint32_t i;
+
+    packet[0] = (uint8_t)((port << 3) | ((size == 4U) ? 3U : size));
+    for (i = 0; i < size; i++)
+    {
+        packet[1 + i] = (uint8_t)(value >> (8U * i));
+    }
+    StubItmInject(packet, 1U + size);
+}
+
+size_t StubItmCapture(const uint8_t **data)
+{
+    *data = stubCapture;
+    return stubCaptureLength;
+}
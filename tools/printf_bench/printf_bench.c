@@ -0,0 +1,335 @@
+/*
+ * printf_bench.c
+ *
+ *  Host benchmark of the debug console printf engine.  Runs the formats the
+ *  demo prints through DbgConsole_Printf() (utilities/fsl_debug_console.c,
+ *  built unchanged against the tools/host_stubs headers) and through RefConsole_Printf(),
+ *  the engine it replaced (printf_reference.c), checks that both produce the
+ *  same text and prints the time per call.  With PRINTF_FLOAT_ENABLE it also
+ *  reads %f output back with strtod to check its accuracy.
+ *
+ *    make run
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fsl_debug_console.h"
+#include "fsl_adapter_uart.h"
+#include "printf_bench.h"
+
+#define BENCH_ITERATIONS (200000U)
+#define BENCH_OUTPUT_SIZE (512U)
+
+typedef enum
+{
+	BENCH_STATUS,
+	BENCH_INTEGER,
+	BENCH_HEX,
+	BENCH_STRING,
+	BENCH_FLOAT,
+} bench_case_t;
+
+static const char *const benchNames[] = {
+	"status line",
+	"%d %u",
+	"%x %08X",
+	"%s %c",
+	"%f %.3f",
+};
+
+static char newOutput[BENCH_OUTPUT_SIZE];
+static uint32_t newLength;
+static char refOutput[BENCH_OUTPUT_SIZE];
+static uint32_t refLength;
+
+/*
+ * The UART the debug console writes to, keeps the last call's text.
+ */
+hal_uart_status_t HAL_UartInit(hal_uart_handle_t handle, const hal_uart_config_t *config)
+{
+	(void)handle;
+	(void)config;
+	return kStatus_HAL_UartSuccess;
+}
+
+hal_uart_status_t HAL_UartDeinit(hal_uart_handle_t handle)
+{
+	(void)handle;
+	return kStatus_HAL_UartSuccess;
+}
+
+hal_uart_status_t HAL_UartSendBlocking(hal_uart_handle_t handle, const uint8_t *data, size_t length)
+{
+	(void)handle;
+	if ((newLength + length) < BENCH_OUTPUT_SIZE)
+	{
+		memcpy(&newOutput[newLength], data, length);
+		newLength += length;
+	}
+	return kStatus_HAL_UartSuccess;
+}
+
+hal_uart_status_t HAL_UartReceiveBlocking(hal_uart_handle_t handle, uint8_t *data, size_t length)
+{
+	(void)handle;
+	(void)data;
+	(void)length;
+	return kStatus_HAL_UartError;
+}
+
+static int RefPutchar(int ch)
+{
+	if ((refLength + 1) < BENCH_OUTPUT_SIZE)
+	{
+		refOutput[refLength++] = (char)ch;
+	}
+	return ch;
+}
+
+/*
+ * One call of either engine, the arguments change with i so nothing is
+ * folded at compile time.
+ */
+static void BenchCall(bench_case_t which, int reference, uint32_t i)
+{
+	int (*print)(const char *fmt_s, ...) = DbgConsole_Printf;
+	volatile double value = 1.0 + (double)(i & 0xFFU) / 7.0;
+
+	if (reference)
+	{
+		refLength = 0;
+	}
+	else
+	{
+		newLength = 0;
+	}
+
+	switch (which)
+	{
+	case BENCH_STATUS:
+		if (reference)
+			RefConsole_Printf(RefPutchar, "frame %d @%u: %02x .. %02x, dropped %d\r\n", (int)(i & 0x3FFU), 0x1234567U + i,
+							  i & 0xFFU, (i >> 3) & 0xFFU, (int)(i & 7U));
+		else
+			print("frame %d @%u: %02x .. %02x, dropped %d\r\n", (int)(i & 0x3FFU), 0x1234567U + i, i & 0xFFU,
+				  (i >> 3) & 0xFFU, (int)(i & 7U));
+		break;
+	case BENCH_INTEGER:
+		if (reference)
+			RefConsole_Printf(RefPutchar, "%d %u %d\r\n", (int)i - 100000, 4000000000U - i, (int)(i & 0xFU));
+		else
+			print("%d %u %d\r\n", (int)i - 100000, 4000000000U - i, (int)(i & 0xFU));
+		break;
+	case BENCH_HEX:
+		if (reference)
+			RefConsole_Printf(RefPutchar, "%x %08X 0x%x\r\n", 0xDEAD0000U + i, i * 2654435761U, i & 0xFFU);
+		else
+			print("%x %08X 0x%x\r\n", 0xDEAD0000U + i, i * 2654435761U, i & 0xFFU);
+		break;
+	case BENCH_STRING:
+		if (reference)
+			RefConsole_Printf(RefPutchar, "%s ns: %c %s\r\n", "edge to SCK", 'A' + (int)(i % 26U), "ok");
+		else
+			print("%s ns: %c %s\r\n", "edge to SCK", 'A' + (int)(i % 26U), "ok");
+		break;
+	case BENCH_FLOAT:
+		if (reference)
+			RefConsole_Printf(RefPutchar, "%f %.3f\r\n", value, value * 1000.0);
+		else
+			print("%f %.3f\r\n", value, value * 1000.0);
+		break;
+	}
+}
+
+static double BenchTime(bench_case_t which, int reference)
+{
+	struct timespec start;
+	struct timespec end;
+	uint32_t i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		BenchCall(which, reference, i);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return ((double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec)) / BENCH_ITERATIONS;
+}
+
+/*
+ * Both engines have to agree on every argument set the timing uses.
+ */
+static int BenchCompare(bench_case_t which)
+{
+	uint32_t i;
+
+	for (i = 0; i < BENCH_ITERATIONS; i += 97U)
+	{
+		BenchCall(which, 0, i);
+		BenchCall(which, 1, i);
+		if ((newLength != refLength) || (memcmp(newOutput, refOutput, newLength) != 0))
+		{
+			printf("%-12s MISMATCH at %u\n  new: %.*s  ref: %.*s", benchNames[which], i, (int)newLength, newOutput,
+				   (int)refLength, refOutput);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+#if PRINTF_FLOAT_ENABLE
+typedef struct
+{
+	double value;
+	const char *format;
+	const char *expected;
+} bench_float_case_t;
+
+/* Edges of the integer scaling. */
+static const bench_float_case_t benchFloatEdges[] = {
+	{0.0, "%f", "0.000000"},
+	{2.5, "%.0f", "3"},
+	{0.9999996, "%f", "1.000000"},
+	{0.05, "%.3f", "0.050"},
+	{1.5, "%.12f", "1.500000000000"},
+	{1.0 / 3.0, "%.12f", "0.333333333000"},
+	{1.5, "%16.12f", "  1.500000000000"},
+	{4294967296.25, "%.2f", "4294967296.25"},
+	{1e19, "%.0f", "10000000000000000000"},
+	{18446744073709551616.0, "%.0f", "18446744073709551616"},
+	{1e20, "%f", "100000000000000000000.000000"},
+	{INFINITY, "%f", "inf"},
+	{NAN, "%f", "nan"},
+};
+
+static const char *BenchFormatFloat(const char *format, double value)
+{
+	newLength = 0;
+	DbgConsole_Printf(format, value);
+	newOutput[newLength] = '\0';
+	return newOutput;
+}
+
+/* Past 2^64, printed exactly by the slow digit loop: must match libc. */
+static const double benchFloatLarge[] = {
+	18446744073709551616.0 * 3.0, 1e20, 123456789e30, 1e100, 1e300, DBL_MAX,
+};
+
+/*
+ * %.0f to %.9f over values from 1e-6 to 1e10: read back with strtod the text
+ * has to be within half a unit of its last digit (plus the spacing of doubles
+ * at that size) of the value.  Halfway cases round up where the host libc
+ * rounds to even, those and values within a rounding error of halfway are
+ * counted as differing from libc, not as errors.
+ */
+static int BenchFloatAccuracy(void)
+{
+	char format[8];
+	char libc[400];
+	const char *text;
+	char *end;
+	double value;
+	double back;
+	double tolerance;
+	uint32_t seed       = 12345U;
+	uint32_t differ     = 0;
+	uint32_t precision;
+	uint32_t i;
+
+	for (i = 0; i < (sizeof(benchFloatEdges) / sizeof(benchFloatEdges[0])); i++)
+	{
+		text = BenchFormatFloat(benchFloatEdges[i].format, benchFloatEdges[i].value);
+		if (strcmp(text, benchFloatEdges[i].expected) != 0)
+		{
+			printf("%s of %g gives \"%s\", expected \"%s\"\n", benchFloatEdges[i].format, benchFloatEdges[i].value,
+				   text, benchFloatEdges[i].expected);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < (sizeof(benchFloatLarge) / sizeof(benchFloatLarge[0])); i++)
+	{
+		text = BenchFormatFloat("%.3f", benchFloatLarge[i]);
+		snprintf(libc, sizeof(libc), "%.3f", benchFloatLarge[i]);
+		if (strcmp(text, libc) != 0)
+		{
+			printf("%%.3f of %g gives \"%s\", libc \"%s\"\n", benchFloatLarge[i], text, libc);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		seed      = (seed * 1664525U) + 1013904223U;
+		value     = ((double)(seed >> 8) / 16777216.0) * pow(10.0, (double)((int)(seed % 17U) - 6));
+		precision = i % 10U;
+#if PRINTF_ADVANCED_ENABLE
+		if ((seed & 0x80U) != 0U)
+		{
+			value = -value;
+		}
+#endif
+		snprintf(format, sizeof(format), "%%.%uf", precision);
+		text      = BenchFormatFloat(format, value);
+		back      = strtod(text, &end);
+		tolerance = (0.5 * pow(10.0, -(double)precision)) + (fabs(value) * 2.0 * DBL_EPSILON);
+		if ((*end != '\0') || (fabs(back - value) > tolerance))
+		{
+			printf("%s of %.17g gives \"%s\", off by %g\n", format, value, text, fabs(back - value));
+			return -1;
+		}
+		snprintf(libc, sizeof(libc), format, value);
+		if (strcmp(text, libc) != 0)
+		{
+			differ++;
+		}
+	}
+
+	printf("%%f round trip: %u edge cases, %u large values as libc and %u values within half a unit, %u differ from "
+		   "libc\n",
+		   (uint32_t)(sizeof(benchFloatEdges) / sizeof(benchFloatEdges[0])),
+		   (uint32_t)(sizeof(benchFloatLarge) / sizeof(benchFloatLarge[0])), BENCH_ITERATIONS, differ);
+	return 0;
+}
+#endif /* PRINTF_FLOAT_ENABLE */
+
+int main(void)
+{
+	uint32_t which;
+	uint32_t last  = PRINTF_FLOAT_ENABLE ? BENCH_FLOAT : BENCH_STRING;
+	int failed     = 0;
+
+	DbgConsole_Init(0, 115200, kSerialPort_Uart, 0);
+
+	printf("PRINTF_ADVANCED_ENABLE=%d PRINTF_FLOAT_ENABLE=%d, %u calls per case\n", PRINTF_ADVANCED_ENABLE,
+		   PRINTF_FLOAT_ENABLE, BENCH_ITERATIONS);
+	printf("%-12s %10s %10s %8s\n", "case", "ref ns", "new ns", "speedup");
+	for (which = 0; which <= last; which++)
+	{
+		double refNs;
+		double newNs;
+
+		if (BenchCompare((bench_case_t)which) != 0)
+		{
+			failed = 1;
+			continue;
+		}
+		refNs = BenchTime((bench_case_t)which, 1);
+		newNs = BenchTime((bench_case_t)which, 0);
+		printf("%-12s %10.1f %10.1f %7.2fx\n", benchNames[which], refNs, newNs, refNs / newNs);
+	}
+
+#if PRINTF_FLOAT_ENABLE
+	if (BenchFloatAccuracy() != 0)
+	{
+		failed = 1;
+	}
+#endif
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
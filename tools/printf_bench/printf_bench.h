@@ -0,0 +1,12 @@
+/*
+ * printf_bench.h
+ *
+ *  Host benchmark of the debug console printf engine against the previous one.
+ */
+
+#ifndef PRINTF_BENCH_H_
+#define PRINTF_BENCH_H_
+
+int RefConsole_Printf(int (*func_ptr)(int a), const char *fmt_s, ...);
+
+#endif /* PRINTF_BENCH_H_ */
@@ -0,0 +1,155 @@
+/*
+ * sim.h
+ *
+ *  Host model of the i.MX RT1062 blocks source/spi3DMA.c drives, so the driver
+ *  runs unchanged on a Linux PC: eDMA (DMA0), DMAMUX, LPSPI1..4, XBAR1 with the
+ *  GPIO_AD_B0_15 pad, GPT1, PIT, the CCM clock gates, IOMUXC and the DWT cycle
+ *  counter.  The register blocks are RAM images mapped at their real addresses,
+ *  the TCD address fields are 32 bit so the build is non-PIE and everything the
+ *  eDMA addresses sits below 4 GiB.
+ *
+ *  Registers with side effects (the eDMA command registers, LPSPI FIFOs, XBAR
+ *  status, timers) are on trapped pages: a CPU access faults, the models are run
+ *  up to that moment, the access is single stepped and its effect applied.  The
+ *  TCDs, DMAMUX, CCM and IOMUXC are plain memory the models read directly.
+ *
+ *  Time is kept in picoseconds.  Between trapped accesses the CPU costs nothing,
+ *  every trapped access costs SIM_CPU_ACCESS_CYCLES core cycles.  Interrupts are
+ *  taken in SimRun(), SIM_IRQ_ENTRY_CYCLES after the eDMA raised them, and
+ *  after a trapped access when the NVIC has their vector enabled.
+ */
+
+#ifndef TOOLS_SPI3DMA_SIM_SIM_H_
+#define TOOLS_SPI3DMA_SIM_SIM_H_
+
+#include <stdint.h>
+
+typedef uint64_t sim_time_t; /* picoseconds since SimInit() */
+
+#define SIM_PS_PER_NS (1000ULL)
+#define SIM_PS_PER_US (1000000ULL)
+#define SIM_NEVER     (~(sim_time_t)0)
+
+#define SIM_CORE_HZ           (600000000ULL) /* Cortex-M7, DWT CYCCNT */
+#define SIM_BUS_HZ            (150000000ULL) /* eDMA engine and IPG bus */
+#define SIM_CPU_ACCESS_CYCLES (20U)          /* core cycles of one peripheral register access */
+#define SIM_IRQ_ENTRY_CYCLES  (12U)          /* exception entry with the vector table in RAM */
+
+/* picoseconds of cycles of a clock */
+#define SIM_PS(cycles, hz) ((sim_time_t)(cycles) * 1000000000000ULL / (hz))
+/* whole cycles of a clock in a time */
+#define SIM_CYCLES(time, hz) ((uint64_t)(((unsigned __int128)(time) * (hz)) / 1000000000000ULL))
+
+#define SIM_CHANNELS  (32)
+#define SIM_INSTANCES (4) /* LPSPI1..4 */
+
+typedef struct _sim_channel_stats
+{
+	uint32_t hwRequests; /* minor loops started by the DMAMUX request */
+	uint32_t minorLoops; /* including the ones started by START or a link */
+	uint32_t majorLoops;
+	uint32_t readBeats;  /* source reads, one per transfer of SSIZE */
+	uint32_t writeBeats; /* destination writes, one per transfer of DSIZE */
+	uint32_t tcdLoads;   /* scatter-gather TCD fetches, 32 bytes each */
+	sim_time_t busy;     /* engine time spent on the channel */
+} sim_channel_stats_t;
+
+typedef struct _sim_spi_stats
+{
+	uint32_t words;       /* data words shifted */
+	uint32_t bits;
+	uint32_t frames;      /* PCS assertions */
+	uint32_t rxOverflows; /* words dropped with NOSTALL and a full Rx FIFO */
+	uint32_t stalls;      /* words held back by a full Rx FIFO */
+	sim_time_t firstSck;  /* first SCK edge since SimClearStats(), 0 none yet */
+	sim_time_t lastSck;   /* last SCK edge */
+	sim_time_t pcsNegate; /* last PCS negation */
+} sim_spi_stats_t;
+
+typedef struct _sim_stats
+{
+	sim_channel_stats_t channel[SIM_CHANNELS];
+	sim_spi_stats_t spi[SIM_INSTANCES];
+	uint32_t dmaErrors;         /* channels stopped by a TCD configuration error */
+	uint32_t irqs;              /* DMA vectors taken */
+	uint32_t dcacheInvalidates; /* SCB DCIMVAC writes */
+	uint32_t cpuAccesses;       /* trapped CPU register accesses */
+	uint32_t xbarEdges;         /* XBAR1 edges that set STS */
+} sim_stats_t;
+
+extern sim_stats_t simStats;
+
+/* sim_core.c */
+int SimInit(void);
+sim_time_t SimNow(void);
+void SimClearStats(void);
+void SimRun(sim_time_t duration);
+void SimSetPad(uint8_t level);
+void SimSetMiso(uint32_t (*miso)(uint32_t instance, uint32_t mosi, uint32_t bits));
+uint32_t SimGptCount(sim_time_t time);
+void SimSetAccessHook(uint8_t (*hook)(uint32_t address, uint8_t write));
+
+/*
+ * Interrupts raised as SIGUSR1 (spsc_stress) go through the NVIC enables: the
+ * handler pends a disabled IRQ and returns, enabling it raises SIGUSR1 again.
+ */
+uint8_t SimIrqEnabled(uint32_t irq);
+void SimIrqPend(uint32_t irq);
+
+/*
+ * Model side, not for the scenarios.  Each block keeps its state in the register
+ * image and a few private fields, tells the core when its next internal event
+ * is due and runs what is due when stepped.
+ */
+typedef struct _sim_model
+{
+	void (*reset)(void);
+	sim_time_t (*next)(void); /* time of the next event, SIM_NEVER for none */
+	void (*step)(void);       /* run everything due at SimNow() */
+} sim_model_t;
+
+extern sim_time_t simNow;
+
+uint8_t *SimImage(uint32_t address);
+uint32_t SimBusRead(uint32_t address, uint32_t size);
+void SimBusWrite(uint32_t address, uint32_t size, uint32_t value);
+uint32_t SimBusClocks(uint32_t address);
+uint8_t SimBusValid(uint32_t address);
+sim_time_t SimAlign(sim_time_t time, sim_time_t period);
+void SimAdvance(sim_time_t until);
+
+#define SIM_REG32(address) (*(volatile uint32_t *)SimImage(address))
+#define SIM_REG16(address) (*(volatile uint16_t *)SimImage(address))
+#define SIM_REG8(address)  (*(volatile uint8_t *)SimImage(address))
+
+/* sim_edma.c, eDMA and DMAMUX */
+extern const sim_model_t edmaModel;
+void EdmaRead(uint32_t address);
+void EdmaWrite(uint32_t address);
+uint32_t EdmaIrqPending(void);
+uint32_t EdmaIrqTake(uint32_t channels);
+
+/* sim_lpspi.c */
+extern const sim_model_t lpspiModel;
+void LpspiRead(uint32_t address);
+void LpspiWrite(uint32_t address);
+uint8_t LpspiDmaRequest(uint32_t source);
+void LpspiSetMiso(uint32_t (*miso)(uint32_t instance, uint32_t mosi, uint32_t bits));
+
+/* sim_periph.c, XBAR1, GPT1, PIT, DWT, SCB and NVIC */
+extern const sim_model_t periphModel;
+void XbarWrite(uint32_t address);
+void XbarSetPad(uint8_t level);
+uint8_t XbarDmaRequest(uint32_t source);
+void XbarDmaAck(uint32_t source);
+void GptRead(uint32_t address);
+void GptWrite(uint32_t address);
+uint32_t GptCount(sim_time_t time);
+void PitRead(uint32_t address);
+void PitWrite(uint32_t address);
+uint8_t PitTrigger(uint32_t channel);
+void PitTriggerAck(uint32_t channel);
+void DwtRead(uint32_t address);
+void ScbWrite(uint32_t address);
+
+#endif /* TOOLS_SPI3DMA_SIM_SIM_H_ */
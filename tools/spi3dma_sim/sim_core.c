@@ -0,0 +1,423 @@
+/*
+ * sim_core.c
+ *
+ *  Register images, CPU access traps, simulated time and interrupt delivery of
+ *  the spi3DMA host model, see sim.h.
+ *
+ *  Every block is a memfd mapped twice: at its real address for the driver and
+ *  at a kernel chosen address for the models.  The leading trapSize bytes of a
+ *  block are PROT_NONE at the real address.  A CPU access there raises SIGSEGV,
+ *  the handler runs the models up to the access, refreshes the image for a read
+ *  and opens the page with the trap flag set.  The access executes, SIGTRAP
+ *  closes the page again and hands a write to the block.
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "spi3DMAApi.h"
+#include "spi3DMA.h"
+#include "sim.h"
+
+#define SIM_PAGE        (0x1000U)
+#define SIM_PAGES(size) (((size) + SIM_PAGE - 1) & ~(SIM_PAGE - 1))
+
+#define X86_EFLAGS_TF   (0x100)  /* single step */
+#define X86_PF_WRITE    (0x2)    /* page fault error code, write access */
+
+#define SIM_PERIPH_CLOCKS (4U)   /* eDMA bus clocks of a peripheral register access */
+#define SIM_RAM_CLOCKS    (2U)   /* of an on-chip RAM access */
+#define SIM_STEP_LIMIT    (100000U) /* model steps at one instant before the model is declared stuck */
+
+#define DWT_BASE (0xE0001000u)
+#define SCB_BASE (0xE000E000u)
+
+typedef struct _sim_region
+{
+	uint32_t base;
+	uint32_t size;                  /* mapped bytes, whole pages */
+	uint32_t trapSize;              /* leading bytes the CPU can not touch without a trap */
+	void (*read)(uint32_t address);  /* before a read, refreshes the image */
+	void (*write)(uint32_t address); /* after a write, the value is in the image */
+	uint8_t *image;                 /* alias the models work on */
+} sim_region_t;
+
+static sim_region_t regions[] =
+{
+	{ DMA0_BASE,       SIM_PAGES(sizeof(DMA_Type)),        SIM_PAGE, EdmaRead, EdmaWrite }, // TCDs from 0x1000 are plain
+	{ DMAMUX_BASE,     SIM_PAGES(sizeof(DMAMUX_Type)),     0, 0, 0 },
+	{ LPSPI1_BASE,     SIM_PAGE,                           SIM_PAGE, LpspiRead, LpspiWrite },
+	{ LPSPI2_BASE,     SIM_PAGE,                           SIM_PAGE, LpspiRead, LpspiWrite },
+	{ LPSPI3_BASE,     SIM_PAGE,                           SIM_PAGE, LpspiRead, LpspiWrite },
+	{ LPSPI4_BASE,     SIM_PAGE,                           SIM_PAGE, LpspiRead, LpspiWrite },
+	{ CCM_BASE,        SIM_PAGES(sizeof(CCM_Type)),        0, 0, 0 },
+	{ IOMUXC_BASE,     SIM_PAGES(sizeof(IOMUXC_Type)),     0, 0, 0 },
+	{ IOMUXC_GPR_BASE, SIM_PAGES(sizeof(IOMUXC_GPR_Type)), 0, 0, 0 },
+	{ XBARA1_BASE,     SIM_PAGE,                           SIM_PAGE, 0, XbarWrite },
+	{ GPT1_BASE,       SIM_PAGE,                           SIM_PAGE, GptRead, GptWrite },
+	{ PIT_BASE,        SIM_PAGE,                           SIM_PAGE, PitRead, PitWrite },
+	{ DWT_BASE,        SIM_PAGE,                           SIM_PAGE, DwtRead, 0 },
+	{ SCB_BASE,        SIM_PAGE,                           SIM_PAGE, 0, ScbWrite },
+};
+
+#define SIM_REGION_COUNT (sizeof(regions) / sizeof(regions[0]))
+
+static const sim_model_t *const models[] = { &periphModel, &lpspiModel, &edmaModel };
+
+#define SIM_MODEL_COUNT (sizeof(models) / sizeof(models[0]))
+
+sim_stats_t simStats;
+sim_time_t simNow;
+
+static sim_region_t *faultRegion; // access being single stepped
+static uint32_t faultAddress;
+static uint8_t faultWrite;
+static int faultIrqMasked;         // SIGUSR1 was blocked where the access faulted
+static uint8_t (*accessHook)(uint32_t address, uint8_t write);
+
+void DMA0_DMA16_IRQHandler(void);
+void DMA8_DMA24_IRQHandler(void);
+
+static sim_region_t *FindRegion(uint32_t address)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_REGION_COUNT; idx++)
+	{
+		if ((address >= regions[idx].base) && ((address - regions[idx].base) < regions[idx].size))
+			return &regions[idx];
+	}
+	return 0;
+}
+
+/*
+ * Model view of an address: the alias of a register block or host memory as is.
+ */
+uint8_t *SimImage(uint32_t address)
+{
+	sim_region_t *region = FindRegion(address);
+
+	if (region)
+		return region->image + (address - region->base);
+	return (uint8_t *)(uintptr_t)address;
+}
+
+static void Protect(sim_region_t *region, int protection)
+{
+	if (mprotect((void *)(uintptr_t)region->base, region->trapSize, protection))
+	{
+		perror("mprotect");
+		abort();
+	}
+}
+
+/*
+ * eDMA access: blocks with side effects see it the way a CPU access would.
+ * Addresses below 64 KiB are taken as a bus error, they never hold data here.
+ */
+uint32_t SimBusRead(uint32_t address, uint32_t size)
+{
+	sim_region_t *region = FindRegion(address);
+	uint32_t value = 0;
+
+	if (region && ((address - region->base) < region->trapSize) && region->read)
+		region->read(address);
+	memcpy(&value, SimImage(address), size);
+	return value;
+}
+
+void SimBusWrite(uint32_t address, uint32_t size, uint32_t value)
+{
+	sim_region_t *region = FindRegion(address);
+
+	memcpy(SimImage(address), &value, size);
+	if (region && ((address - region->base) < region->trapSize) && region->write)
+		region->write(address);
+}
+
+/*
+ * eDMA bus clocks of one access, register blocks through the IPS bridge,
+ * everything else counts as on-chip RAM.
+ */
+uint32_t SimBusClocks(uint32_t address)
+{
+	return FindRegion(address) ? SIM_PERIPH_CLOCKS : SIM_RAM_CLOCKS;
+}
+
+uint8_t SimBusValid(uint32_t address)
+{
+	return address >= 0x10000U;
+}
+
+sim_time_t SimAlign(sim_time_t time, sim_time_t period)
+{
+	return ((time + period - 1) / period) * period;
+}
+
+static sim_time_t NextEvent(void)
+{
+	sim_time_t next = SIM_NEVER;
+	sim_time_t time;
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_MODEL_COUNT; idx++)
+	{
+		time = models[idx]->next();
+		if (time < next)
+			next = time;
+	}
+	return next;
+}
+
+/*
+ * Run the models up to until, or up to the first eDMA interrupt when stopOnIrq.
+ */
+static void Advance(sim_time_t until, uint8_t stopOnIrq)
+{
+	sim_time_t next;
+	uint32_t steps = 0;
+	uint32_t idx;
+
+	while (!(stopOnIrq && EdmaIrqPending()))
+	{
+		next = NextEvent();
+		if (next > until)
+			break;
+		if (next > simNow)
+		{
+			simNow = next;
+			steps = 0;
+		}
+		else if (++steps > SIM_STEP_LIMIT)
+		{
+			fprintf(stderr, "sim: no progress at %llu ps\n", (unsigned long long)simNow);
+			abort();
+		}
+		for (idx = 0; idx < SIM_MODEL_COUNT; idx++)
+		{
+			models[idx]->step();
+		}
+	}
+	if (!(stopOnIrq && EdmaIrqPending()) && (until > simNow))
+		simNow = until;
+}
+
+void SimAdvance(sim_time_t until)
+{
+	Advance(until, 0);
+}
+
+static void TakeIrq(uint32_t pending)
+{
+	SimAdvance(simNow + SIM_PS(SIM_IRQ_ENTRY_CYCLES, SIM_CORE_HZ));
+	simStats.irqs++;
+	if (EdmaIrqTake(pending & ((1U << 0) | (1U << 16))))
+		DMA0_DMA16_IRQHandler();
+	else if (EdmaIrqTake(pending & ((1U << 8) | (1U << 24))))
+		DMA8_DMA24_IRQHandler();
+	else
+		EdmaIrqTake(pending); // no vector of the driver, the NVIC has it disabled
+}
+
+/*
+ * Let the hardware run for duration with the CPU idle, taking the DMA vectors
+ * the driver installs whenever their channels raise INT.
+ */
+void SimRun(sim_time_t duration)
+{
+	sim_time_t end = simNow + duration;
+	uint32_t pending;
+
+	for (;;)
+	{
+		Advance(end, 1);
+		pending = EdmaIrqPending();
+		if (!pending)
+			break;
+
+		TakeIrq(pending);
+		if (simNow >= end)
+			break;
+	}
+}
+
+/* eDMA channels whose vector (IRQ n for channels n and n+16) the NVIC has enabled */
+static uint32_t EnabledIrqChannels(void)
+{
+	uint32_t channels = 0;
+	uint32_t irq;
+
+	for (irq = 0; irq < (SIM_CHANNELS / 2); irq++)
+	{
+		if (SimIrqEnabled(irq))
+			channels |= (1U << irq) | (1U << (irq + (SIM_CHANNELS / 2)));
+	}
+	return channels;
+}
+
+/*
+ * Between CPU accesses outside SimRun(): an enabled vector is raised as SIGUSR1
+ * after the access that saw it pending, and taken here.
+ */
+static void IrqSignal(int signal)
+{
+	uint32_t pending = EdmaIrqPending() & EnabledIrqChannels();
+
+	(void)signal;
+	if (pending)
+		TakeIrq(pending);
+}
+
+sim_time_t SimNow(void)
+{
+	return simNow;
+}
+
+void SimClearStats(void)
+{
+	memset(&simStats, 0, sizeof(simStats));
+}
+
+void SimSetPad(uint8_t level)
+{
+	XbarSetPad(level);
+}
+
+void SimSetMiso(uint32_t (*miso)(uint32_t instance, uint32_t mosi, uint32_t bits))
+{
+	LpspiSetMiso(miso);
+}
+
+uint32_t SimGptCount(sim_time_t time)
+{
+	return GptCount(time);
+}
+
+/*
+ * Called before every trapped CPU access.  Returning 1 raises SIGUSR1 in front
+ * of the access: the interrupt runs first and the access faults again, so the
+ * hook has to return 0 the next time.
+ */
+void SimSetAccessHook(uint8_t (*hook)(uint32_t address, uint8_t write))
+{
+	accessHook = hook;
+}
+
+static void SegvHandler(int signal, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = context;
+	uintptr_t address = (uintptr_t)info->si_addr;
+	sim_region_t *region = (address >> 32) ? 0 : FindRegion((uint32_t)address);
+
+	if (!region || faultRegion || ((address - region->base) >= region->trapSize))
+	{
+		// a real crash, let it happen with the default action
+		(void)signal;
+		sigaction(SIGSEGV, &(struct sigaction){ .sa_handler = SIG_DFL }, 0);
+		return;
+	}
+
+	if (accessHook && accessHook((uint32_t)address, (uc->uc_mcontext.gregs[REG_ERR] & X86_PF_WRITE) != 0))
+	{
+		raise(SIGUSR1); // pending until this handler returns to the access
+		return;
+	}
+
+	faultRegion = region;
+	faultAddress = (uint32_t)address;
+	faultWrite = (uc->uc_mcontext.gregs[REG_ERR] & X86_PF_WRITE) != 0;
+	simStats.cpuAccesses++;
+	SimAdvance(simNow + SIM_PS(SIM_CPU_ACCESS_CYCLES, SIM_CORE_HZ));
+	if (!faultWrite && region->read)
+		region->read(faultAddress);
+
+	Protect(region, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= X86_EFLAGS_TF;
+	faultIrqMasked = sigismember(&uc->uc_sigmask, SIGUSR1);
+	sigaddset(&uc->uc_sigmask, SIGUSR1); // a simulated interrupt must not run inside the access
+}
+
+static void TrapHandler(int signal, siginfo_t *info, void *context)
+{
+	ucontext_t *uc = context;
+	sim_region_t *region = faultRegion;
+
+	(void)signal;
+	(void)info;
+	uc->uc_mcontext.gregs[REG_EFL] &= ~X86_EFLAGS_TF;
+	if (!region)
+		return;
+
+	if (faultWrite && region->write)
+		region->write(faultAddress);
+	Protect(region, PROT_NONE);
+	faultRegion = 0;
+	if (!faultIrqMasked)
+	{
+		sigdelset(&uc->uc_sigmask, SIGUSR1); // an access from the interrupt handler keeps it masked
+		if (EdmaIrqPending() & EnabledIrqChannels())
+			raise(SIGUSR1); // taken once the access completed
+	}
+}
+
+/*
+ * Map the register blocks, reset the models and install the trap handlers.
+ * Returns 0, or -1 when an address range is taken (PIE build, 32 bit host).
+ */
+int SimInit(void)
+{
+	struct sigaction action;
+	sim_region_t *region;
+	void *mapped;
+	uint32_t idx;
+	int fd;
+
+	for (idx = 0; idx < SIM_REGION_COUNT; idx++)
+	{
+		region = &regions[idx];
+		fd = memfd_create("spi3dma_sim", 0);
+		if ((fd < 0) || ftruncate(fd, region->size))
+			return -1;
+		mapped = mmap((void *)(uintptr_t)region->base, region->size, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+		if (mapped != (void *)(uintptr_t)region->base)
+		{
+			fprintf(stderr, "sim: can not map 0x%08X\n", region->base);
+			return -1;
+		}
+		region->image = mmap(0, region->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (region->image == MAP_FAILED)
+			return -1;
+	}
+
+	simNow = 0;
+	SimClearStats();
+	for (idx = 0; idx < SIM_MODEL_COUNT; idx++)
+	{
+		models[idx]->reset();
+	}
+
+	memset(&action, 0, sizeof(action));
+	action.sa_flags = SA_SIGINFO | SA_NODEFER;
+	sigaddset(&action.sa_mask, SIGUSR1);
+	action.sa_sigaction = SegvHandler;
+	sigaction(SIGSEGV, &action, 0);
+	action.sa_sigaction = TrapHandler;
+	sigaction(SIGTRAP, &action, 0);
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = IrqSignal; // spsc_stress raises its own
+	sigaction(SIGUSR1, &action, 0);
+
+	for (idx = 0; idx < SIM_REGION_COUNT; idx++)
+	{
+		if (regions[idx].trapSize)
+			Protect(&regions[idx], PROT_NONE);
+	}
+	return 0;
+}
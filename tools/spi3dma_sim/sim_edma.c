@@ -0,0 +1,480 @@
+/*
+ * sim_edma.c
+ *
+ *  eDMA and DMAMUX model of the spi3DMA host simulator, see sim.h.
+ *
+ *  The engine services one minor loop at a time on the 150 MHz bus clock.  A
+ *  channel is ready with START set or with ERQ set and its DMAMUX request
+ *  asserted, the ready channel of the winning group with the highest CHPRI goes
+ *  next.  A minor loop costs setup, one bus access per source read and per
+ *  destination write at the cost of the address, and the write back; the data
+ *  moves when it ends.  Major loop end applies SLAST/DLAST or fetches the next
+ *  TCD (ESG), then DREQ, INTMAJOR and the major link.  Configuration errors set
+ *  ES/ERR and the channel is skipped until CERR.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "spi3DMAApi.h"
+#include "spi3DMA.h"
+#include "sim.h"
+
+#define EDMA_SETUP_CLOCKS     (4U) /* arbitration and TCD read */
+#define EDMA_WRITEBACK_CLOCKS (2U) /* CITER/SADDR/DADDR write back */
+#define EDMA_TCD_LOAD_CLOCKS  (8U) /* 32 byte scatter-gather fetch */
+#define EDMA_MAX_NBYTES       (64U)
+
+#define CITER_ELINK_MASK      (0x8000U)
+#define CITER_LINKCH_MASK     (0x3E00U)
+#define CITER_LINKCH_SHIFT    (9U)
+#define CITER_ELINK_COUNT     (0x1FFU)
+#define CITER_COUNT           (0x7FFFU)
+
+#define DMA_COMMAND_NOP       (0x80U)
+#define DMA_COMMAND_ALL       (0x40U)
+#define DMA_COMMAND_CHANNEL   (0x1FU)
+
+#define CCGR5_DMA_MASK        (0xC0U)
+
+static struct
+{
+	int32_t channel;   /* being serviced, -1 idle */
+	uint8_t hwRequest; /* the minor loop answers a DMAMUX request */
+	sim_time_t end;
+	uint32_t intFlags; /* INT */
+	uint32_t errFlags; /* ERR */
+	uint32_t irqLatch; /* INT bits raised since the vector was last taken */
+} engine;
+
+static DMA_Type *Dma(void)
+{
+	return (DMA_Type *)SimImage(DMA0_BASE);
+}
+
+static DMAMUX_Type *Mux(void)
+{
+	return (DMAMUX_Type *)SimImage(DMAMUX_BASE);
+}
+
+static sim_time_t BusPeriod(void)
+{
+	return SIM_PS(1, SIM_BUS_HZ);
+}
+
+static uint8_t ClockOn(void)
+{
+	return (((CCM_Type *)SimImage(CCM_BASE))->CCGR5 & CCGR5_DMA_MASK) == CCGR5_DMA_MASK;
+}
+
+static uint8_t SourceRequest(uint32_t source)
+{
+	if ((source == (kDmaRequestMuxXBAR1Request0 & DMAMUX_CHCFG_SOURCE_MASK))
+			|| (source == (kDmaRequestMuxXBAR1Request1 & DMAMUX_CHCFG_SOURCE_MASK))
+			|| (source == (kDmaRequestMuxXBAR1Request2 & DMAMUX_CHCFG_SOURCE_MASK))
+			|| (source == (kDmaRequestMuxXBAR1Request3 & DMAMUX_CHCFG_SOURCE_MASK)))
+		return XbarDmaRequest(source);
+	return LpspiDmaRequest(source);
+}
+
+/*
+ * DMAMUX output of a channel.  Channels 0..3 with TRIG pass the request only
+ * once per period of their PIT channel.
+ */
+static uint8_t ChannelRequest(uint32_t channel)
+{
+	uint32_t chcfg = Mux()->CHCFG[channel];
+	uint8_t request;
+
+	if (!(chcfg & DMAMUX_CHCFG_ENBL_MASK))
+		return 0;
+	if (chcfg & DMAMUX_CHCFG_A_ON_MASK)
+		request = 1;
+	else
+		request = SourceRequest(chcfg & DMAMUX_CHCFG_SOURCE_MASK);
+	if ((chcfg & DMAMUX_CHCFG_TRIG_MASK) && (channel < 4))
+		request = request && PitTrigger(channel);
+	return request;
+}
+
+static void ChannelAck(uint32_t channel)
+{
+	uint32_t chcfg = Mux()->CHCFG[channel];
+
+	if ((chcfg & DMAMUX_CHCFG_TRIG_MASK) && (channel < 4))
+		PitTriggerAck(channel);
+	else if (!(chcfg & DMAMUX_CHCFG_A_ON_MASK))
+		XbarDmaAck(chcfg & DMAMUX_CHCFG_SOURCE_MASK);
+}
+
+static uint32_t ReadyMask(void)
+{
+	DMA_Type *dma = Dma();
+	uint32_t ready = 0;
+	uint32_t channel;
+
+	for (channel = 0; channel < SIM_CHANNELS; channel++)
+	{
+		if (engine.errFlags & (1U << channel))
+			continue;
+		if ((dma->TCD[channel].CSR & DMA_CSR_START_MASK)
+				|| ((dma->ERQ & (1U << channel)) && ChannelRequest(channel)))
+			ready |= 1U << channel;
+	}
+	return ready;
+}
+
+static uint32_t ChannelPriority(uint32_t channel)
+{
+	DMA_Type *dma = Dma();
+	volatile uint8_t *dchpri = &dma->DCHPRI3;
+	uint32_t group = channel / 16;
+	uint32_t groupPriority = group ? ((dma->CR & DMA_CR_GRP1PRI_MASK) >> DMA_CR_GRP1PRI_SHIFT)
+			: ((dma->CR & DMA_CR_GRP0PRI_MASK) >> DMA_CR_GRP0PRI_SHIFT);
+
+	// fixed priority, ties go to the higher channel number
+	return (groupPriority << 16) | ((dchpri[channel ^ 3] & DMA_DCHPRI0_CHPRI_MASK) << 8) | channel;
+}
+
+static uint32_t TransferSize(uint32_t code)
+{
+	return (code <= 2) ? (1U << code) : 0; // 8 and 32 byte beats are not used by the driver
+}
+
+static uint32_t MajorCount(uint16_t citer)
+{
+	return (citer & CITER_ELINK_MASK) ? (citer & CITER_ELINK_COUNT) : (citer & CITER_COUNT);
+}
+
+/*
+ * ES bits of what the engine would refuse to run, 0 when the TCD is fine.
+ */
+static uint32_t CheckTcd(uint32_t channel)
+{
+	DMA_Type *dma = Dma();
+	uint32_t attr = dma->TCD[channel].ATTR;
+	uint32_t ssize = TransferSize((attr & DMA_ATTR_SSIZE_MASK) >> DMA_ATTR_SSIZE_SHIFT);
+	uint32_t dsize = TransferSize(attr & DMA_ATTR_DSIZE_MASK);
+	uint32_t nbytes = dma->TCD[channel].NBYTES_MLNO;
+	uint32_t error = 0;
+
+	if (!ssize || (dma->TCD[channel].SADDR & (ssize - 1)))
+		error |= DMA_ES_SAE_MASK;
+	if (!ssize || ((uint16_t)dma->TCD[channel].SOFF & (ssize - 1)))
+		error |= DMA_ES_SOE_MASK;
+	if (!dsize || (dma->TCD[channel].DADDR & (dsize - 1)))
+		error |= DMA_ES_DAE_MASK;
+	if (!dsize || ((uint16_t)dma->TCD[channel].DOFF & (dsize - 1)))
+		error |= DMA_ES_DOE_MASK;
+	if (!nbytes || (nbytes > EDMA_MAX_NBYTES) || (ssize && (nbytes % ssize)) || (dsize && (nbytes % dsize))
+			|| !MajorCount(dma->TCD[channel].CITER_ELINKNO)
+			|| ((dma->TCD[channel].CITER_ELINKNO ^ dma->TCD[channel].BITER_ELINKNO) & CITER_ELINK_MASK))
+		error |= DMA_ES_NCE_MASK;
+	if ((dma->TCD[channel].CSR & DMA_CSR_ESG_MASK) && (dma->TCD[channel].DLAST_SGA & 0x1F))
+		error |= DMA_ES_SGE_MASK;
+	if (!SimBusValid(dma->TCD[channel].SADDR))
+		error |= DMA_ES_SBE_MASK;
+	if (!SimBusValid(dma->TCD[channel].DADDR))
+		error |= DMA_ES_DBE_MASK;
+	return error;
+}
+
+static void ChannelError(uint32_t channel, uint32_t error)
+{
+	DMA_Type *dma = Dma();
+
+	*(volatile uint32_t *)&dma->ES = DMA_ES_VLD_MASK | (channel << DMA_ES_ERRCHN_SHIFT) | error;
+	engine.errFlags |= 1U << channel;
+	dma->ERR = engine.errFlags;
+	dma->TCD[channel].CSR &= ~DMA_CSR_START_MASK;
+	simStats.dmaErrors++;
+}
+
+static uint32_t Modulo(uint32_t address, int32_t offset, uint32_t mod)
+{
+	uint32_t mask = mod ? ((1U << mod) - 1) : 0xFFFFFFFFU;
+
+	return (address & ~mask) | ((address + offset) & mask);
+}
+
+static void Start(uint32_t channel)
+{
+	DMA_Type *dma = Dma();
+	uint32_t attr = dma->TCD[channel].ATTR;
+	uint32_t ssize = TransferSize((attr & DMA_ATTR_SSIZE_MASK) >> DMA_ATTR_SSIZE_SHIFT);
+	uint32_t dsize = TransferSize(attr & DMA_ATTR_DSIZE_MASK);
+	uint32_t nbytes = dma->TCD[channel].NBYTES_MLNO;
+	uint32_t error = CheckTcd(channel);
+	uint32_t clocks;
+
+	if (error)
+	{
+		ChannelError(channel, error);
+		return;
+	}
+
+	engine.hwRequest = !(dma->TCD[channel].CSR & DMA_CSR_START_MASK);
+	dma->TCD[channel].CSR = (dma->TCD[channel].CSR & ~(DMA_CSR_START_MASK | DMA_CSR_DONE_MASK)) | DMA_CSR_ACTIVE_MASK;
+
+	clocks = EDMA_SETUP_CLOCKS + EDMA_WRITEBACK_CLOCKS
+			+ ((nbytes / ssize) * SimBusClocks(dma->TCD[channel].SADDR))
+			+ ((nbytes / dsize) * SimBusClocks(dma->TCD[channel].DADDR));
+	if ((MajorCount(dma->TCD[channel].CITER_ELINKNO) == 1) && (dma->TCD[channel].CSR & DMA_CSR_ESG_MASK))
+		clocks += EDMA_TCD_LOAD_CLOCKS;
+
+	engine.channel = channel;
+	engine.end = simNow + (clocks * BusPeriod());
+	simStats.channel[channel].busy += clocks * BusPeriod();
+}
+
+/*
+ * Scatter-gather: the next TCD replaces the channel's, CSR/BITER word last.
+ */
+static void LoadTcd(uint32_t channel, uint32_t address)
+{
+	volatile uint32_t *tcd = (volatile uint32_t *)&Dma()->TCD[channel];
+	const uint32_t *image = (const uint32_t *)SimImage(address);
+	uint32_t idx;
+
+	for (idx = 0; idx < 8; idx++)
+	{
+		tcd[idx] = image[idx];
+	}
+	simStats.channel[channel].tcdLoads++;
+}
+
+static void Complete(void)
+{
+	DMA_Type *dma = Dma();
+	uint32_t channel = engine.channel;
+	uint32_t attr = dma->TCD[channel].ATTR;
+	uint32_t ssize = TransferSize((attr & DMA_ATTR_SSIZE_MASK) >> DMA_ATTR_SSIZE_SHIFT);
+	uint32_t dsize = TransferSize(attr & DMA_ATTR_DSIZE_MASK);
+	uint32_t nbytes = dma->TCD[channel].NBYTES_MLNO;
+	uint32_t saddr = dma->TCD[channel].SADDR;
+	uint32_t daddr = dma->TCD[channel].DADDR;
+	uint16_t citer = dma->TCD[channel].CITER_ELINKNO;
+	uint16_t csr = dma->TCD[channel].CSR;
+	uint8_t data[EDMA_MAX_NBYTES];
+	uint32_t value;
+	uint32_t idx;
+
+	for (idx = 0; idx < nbytes; idx += ssize)
+	{
+		value = SimBusRead(saddr, ssize);
+		memcpy(&data[idx], &value, ssize);
+		saddr = Modulo(saddr, (int16_t)dma->TCD[channel].SOFF, (attr & DMA_ATTR_SMOD_MASK) >> DMA_ATTR_SMOD_SHIFT);
+	}
+	for (idx = 0; idx < nbytes; idx += dsize)
+	{
+		value = 0;
+		memcpy(&value, &data[idx], dsize);
+		SimBusWrite(daddr, dsize, value);
+		daddr = Modulo(daddr, (int16_t)dma->TCD[channel].DOFF, (attr & DMA_ATTR_DMOD_MASK) >> DMA_ATTR_DMOD_SHIFT);
+	}
+
+	simStats.channel[channel].minorLoops++;
+	simStats.channel[channel].readBeats += nbytes / ssize;
+	simStats.channel[channel].writeBeats += nbytes / dsize;
+	if (engine.hwRequest)
+	{
+		simStats.channel[channel].hwRequests++;
+		ChannelAck(channel);
+	}
+
+	if (MajorCount(citer) > 1)
+	{
+		dma->TCD[channel].SADDR = saddr;
+		dma->TCD[channel].DADDR = daddr;
+		dma->TCD[channel].CITER_ELINKNO = citer - 1;
+		if (citer & CITER_ELINK_MASK)
+			dma->TCD[((citer & CITER_LINKCH_MASK) >> CITER_LINKCH_SHIFT)].CSR |= DMA_CSR_START_MASK;
+		dma->TCD[channel].CSR &= ~DMA_CSR_ACTIVE_MASK;
+	}
+	else
+	{
+		simStats.channel[channel].majorLoops++;
+		if (csr & DMA_CSR_ESG_MASK)
+		{
+			LoadTcd(channel, dma->TCD[channel].DLAST_SGA);
+			dma->TCD[channel].CSR &= ~(DMA_CSR_ACTIVE_MASK | DMA_CSR_DONE_MASK);
+		}
+		else
+		{
+			dma->TCD[channel].SADDR = saddr + dma->TCD[channel].SLAST;
+			dma->TCD[channel].DADDR = daddr + dma->TCD[channel].DLAST_SGA;
+			dma->TCD[channel].CITER_ELINKNO = dma->TCD[channel].BITER_ELINKNO;
+			dma->TCD[channel].CSR = (dma->TCD[channel].CSR & ~DMA_CSR_ACTIVE_MASK) | DMA_CSR_DONE_MASK;
+		}
+		if (csr & DMA_CSR_DREQ_MASK)
+			dma->ERQ &= ~(1U << channel);
+		if (csr & DMA_CSR_INTMAJOR_MASK)
+		{
+			engine.intFlags |= 1U << channel;
+			engine.irqLatch |= 1U << channel;
+			dma->INT = engine.intFlags;
+		}
+		if (csr & DMA_CSR_MAJORELINK_MASK)
+			dma->TCD[(csr & DMA_CSR_MAJORLINKCH_MASK) >> DMA_CSR_MAJORLINKCH_SHIFT].CSR |= DMA_CSR_START_MASK;
+	}
+	engine.channel = -1;
+}
+
+static void EdmaReset(void)
+{
+	DMA_Type *dma = Dma();
+	volatile uint8_t *dchpri = &dma->DCHPRI3;
+	uint32_t channel;
+
+	memset(&engine, 0, sizeof(engine));
+	engine.channel = -1;
+	dma->CR = DMA_CR_GRP1PRI(1);
+	for (channel = 0; channel < SIM_CHANNELS; channel++)
+	{
+		dchpri[channel ^ 3] = DMA_DCHPRI0_CHPRI(channel) | DMA_DCHPRI0_GRPPRI(channel / 16);
+	}
+}
+
+static sim_time_t EdmaNext(void)
+{
+	if (engine.channel >= 0)
+		return engine.end;
+	if ((Dma()->CR & DMA_CR_HALT_MASK) || !ClockOn() || !ReadyMask())
+		return SIM_NEVER;
+	return SimAlign(simNow, BusPeriod());
+}
+
+static void EdmaStep(void)
+{
+	uint32_t ready;
+	uint32_t best;
+	uint32_t channel;
+
+	if ((engine.channel >= 0) && (simNow >= engine.end))
+		Complete();
+	if ((engine.channel >= 0) || (Dma()->CR & DMA_CR_HALT_MASK) || !ClockOn())
+		return;
+	if (SimAlign(simNow, BusPeriod()) != simNow)
+		return;
+
+	ready = ReadyMask();
+	if (!ready)
+		return;
+	for (channel = 0; !(ready & (1U << channel)); channel++)
+	{
+	}
+	best = channel;
+	for (channel = best + 1; channel < SIM_CHANNELS; channel++)
+	{
+		if ((ready & (1U << channel)) && (ChannelPriority(channel) > ChannelPriority(best)))
+			best = channel;
+	}
+	Start(best);
+}
+
+const sim_model_t edmaModel = { EdmaReset, EdmaNext, EdmaStep };
+
+/*
+ * Live status bits before a CPU read.
+ */
+void EdmaRead(uint32_t address)
+{
+	DMA_Type *dma = Dma();
+	uint32_t hrs = 0;
+	uint32_t channel;
+
+	(void)address;
+	dma->CR = (dma->CR & ~DMA_CR_ACTIVE_MASK) | ((engine.channel >= 0) ? DMA_CR_ACTIVE_MASK : 0);
+	dma->INT = engine.intFlags;
+	dma->ERR = engine.errFlags;
+	for (channel = 0; channel < SIM_CHANNELS; channel++)
+	{
+		if (ChannelRequest(channel))
+			hrs |= 1U << channel;
+	}
+	*(volatile uint32_t *)&dma->HRS = hrs;
+}
+
+static void Command(uint32_t offset, uint8_t value)
+{
+	DMA_Type *dma = Dma();
+	uint32_t mask;
+	uint32_t channel;
+
+	if (value & DMA_COMMAND_NOP)
+		return;
+	mask = (value & DMA_COMMAND_ALL) ? 0xFFFFFFFFU : (1U << (value & DMA_COMMAND_CHANNEL));
+
+	if (offset == offsetof(DMA_Type, CEEI))
+		dma->EEI &= ~mask;
+	else if (offset == offsetof(DMA_Type, SEEI))
+		dma->EEI |= mask;
+	else if (offset == offsetof(DMA_Type, CERQ))
+		dma->ERQ &= ~mask;
+	else if (offset == offsetof(DMA_Type, SERQ))
+		dma->ERQ |= mask;
+	else if (offset == offsetof(DMA_Type, CERR))
+		engine.errFlags &= ~mask;
+	else if (offset == offsetof(DMA_Type, CINT))
+		engine.intFlags &= ~mask;
+	else
+	{
+		for (channel = 0; channel < SIM_CHANNELS; channel++)
+		{
+			if (!(mask & (1U << channel)))
+				continue;
+			if (offset == offsetof(DMA_Type, CDNE))
+				dma->TCD[channel].CSR &= ~DMA_CSR_DONE_MASK;
+			else
+				dma->TCD[channel].CSR |= DMA_CSR_START_MASK; // SSRT
+		}
+	}
+	dma->INT = engine.intFlags;
+	dma->ERR = engine.errFlags;
+}
+
+/*
+ * CPU or eDMA write, the value is in the image.  The command registers read
+ * back 0, INT and ERR are write 1 to clear, the DCHPRI group field is fixed.
+ */
+void EdmaWrite(uint32_t address)
+{
+	DMA_Type *dma = Dma();
+	uint32_t offset = address - DMA0_BASE;
+	volatile uint8_t *reg = SimImage(address);
+
+	if ((offset >= offsetof(DMA_Type, CEEI)) && (offset <= offsetof(DMA_Type, CINT)))
+	{
+		Command(offset, *reg);
+		*reg = 0;
+	}
+	else if (offset == offsetof(DMA_Type, INT))
+	{
+		engine.intFlags &= ~dma->INT;
+		dma->INT = engine.intFlags;
+	}
+	else if (offset == offsetof(DMA_Type, ERR))
+	{
+		engine.errFlags &= ~dma->ERR;
+		dma->ERR = engine.errFlags;
+	}
+	else if ((offset >= offsetof(DMA_Type, DCHPRI3)) && (offset < (offsetof(DMA_Type, DCHPRI3) + SIM_CHANNELS)))
+	{
+		*reg = (*reg & ~DMA_DCHPRI0_GRPPRI_MASK) | DMA_DCHPRI0_GRPPRI((offset - offsetof(DMA_Type, DCHPRI3)) / 16);
+	}
+}
+
+uint32_t EdmaIrqPending(void)
+{
+	return engine.irqLatch;
+}
+
+/*
+ * Clear and return the latched interrupts of channels, taken by a vector.
+ */
+uint32_t EdmaIrqTake(uint32_t channels)
+{
+	uint32_t taken = engine.irqLatch & channels;
+
+	engine.irqLatch &= ~taken;
+	return taken;
+}
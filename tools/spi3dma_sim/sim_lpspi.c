@@ -0,0 +1,431 @@
+/*
+ * sim_lpspi.c
+ *
+ *  LPSPI1..4 master model of the spi3DMA host simulator, see sim.h.
+ *
+ *  Data words and TCR writes share the 16 entry Tx FIFO, a command takes effect
+ *  when it reaches the head.  Every data word is one frame of FRAMESZ + 1 bits:
+ *  PCS lead of PCSSCK + 1, SCKDIV + 2 per bit, lag of SCKPCS + 1 and DBT + 2
+ *  between frames, in functional clocks of LPSPI_CLK_ROOT / 2^PRESCALE.  CONT
+ *  keeps PCS asserted and starts the next word right after the last bit.  A
+ *  full 16 entry Rx FIFO stalls the shifter unless NOSTALL.  MISO is MOSI looped
+ *  back unless a sensor is installed with SimSetMiso().  DMA requests: Tx while
+ *  TXCOUNT <= TXWATER, Rx while RXCOUNT > RXWATER.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "spi3DMAApi.h"
+#include "spi3DMA.h"
+#include "sim.h"
+
+#define LPSPI_FIFO_DEPTH (16U)
+#define LPSPI_TCR_RESET  (0x1FU)
+#define LPSPI_STATUS_W1C (LPSPI_SR_WCF_MASK | LPSPI_SR_FCF_MASK | LPSPI_SR_TCF_MASK | LPSPI_SR_TEF_MASK \
+		| LPSPI_SR_REF_MASK | LPSPI_SR_DMF_MASK)
+
+typedef enum _lpspi_phase
+{
+	kPhaseIdle,  /* waiting for the Tx FIFO, PCS may still be asserted with CONT */
+	kPhaseLead,  /* PCS to first SCK */
+	kPhaseShift, /* bits on the wire */
+	kPhaseStall, /* word received, Rx FIFO full */
+	kPhaseLag,   /* last SCK to PCS negation */
+	kPhaseGap,   /* delay between transfers */
+} lpspi_phase_t;
+
+typedef struct _lpspi_state
+{
+	uint32_t base;
+	uint8_t rxSource;   /* DMAMUX request sources */
+	uint8_t txSource;
+	uint32_t clockGate; /* CCM_CCGR1 bits */
+	uint32_t txFifo[LPSPI_FIFO_DEPTH];
+	uint8_t txCommand[LPSPI_FIFO_DEPTH]; /* entry is a TCR write */
+	uint32_t txHead;
+	uint32_t txCount;
+	uint32_t rxFifo[LPSPI_FIFO_DEPTH];
+	uint32_t rxHead;
+	uint32_t rxCount;
+	uint32_t tcr;       /* command in effect */
+	lpspi_phase_t phase;
+	sim_time_t phaseEnd;
+	uint32_t shift;     /* word being shifted out */
+	uint32_t received;  /* word waiting for Rx FIFO space */
+	uint8_t pcs;        /* PCS asserted */
+	uint32_t flags;     /* write 1 to clear SR flags */
+} lpspi_state_t;
+
+static lpspi_state_t lpspi[SIM_INSTANCES] =
+{
+	{ LPSPI1_BASE, kDmaRequestMuxLPSPI1Rx & 0x7F, kDmaRequestMuxLPSPI1Tx & 0x7F, 0x00000003 },
+	{ LPSPI2_BASE, kDmaRequestMuxLPSPI2Rx & 0x7F, kDmaRequestMuxLPSPI2Tx & 0x7F, 0x0000000C },
+	{ LPSPI3_BASE, kDmaRequestMuxLPSPI3Rx & 0x7F, kDmaRequestMuxLPSPI3Tx & 0x7F, 0x00000030 },
+	{ LPSPI4_BASE, kDmaRequestMuxLPSPI4Rx & 0x7F, kDmaRequestMuxLPSPI4Tx & 0x7F, 0x000000C0 },
+};
+
+static uint32_t (*misoSource)(uint32_t instance, uint32_t mosi, uint32_t bits);
+
+static LPSPI_Type *Regs(const lpspi_state_t *state)
+{
+	return (LPSPI_Type *)SimImage(state->base);
+}
+
+static lpspi_state_t *FindState(uint32_t address)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_INSTANCES; idx++)
+	{
+		if ((address & ~0xFFFU) == lpspi[idx].base)
+			return &lpspi[idx];
+	}
+	return 0;
+}
+
+static uint8_t Running(const lpspi_state_t *state)
+{
+	return (Regs(state)->CR & LPSPI_CR_MEN_MASK)
+			&& ((((CCM_Type *)SimImage(CCM_BASE))->CCGR1 & state->clockGate) == state->clockGate);
+}
+
+/* one functional clock */
+static sim_time_t Period(const lpspi_state_t *state)
+{
+	return SIM_PS(1U << ((state->tcr & LPSPI_TCR_PRESCALE_MASK) >> LPSPI_TCR_PRESCALE_SHIFT), SPI3_LPSPI_CLK_HZ);
+}
+
+static uint32_t CcrField(const lpspi_state_t *state, uint32_t mask, uint32_t shift)
+{
+	return (Regs(state)->CCR & mask) >> shift;
+}
+
+static uint32_t FrameBits(const lpspi_state_t *state)
+{
+	uint32_t bits = (state->tcr & LPSPI_TCR_FRAMESZ_MASK) + 1;
+
+	return (bits > 32) ? 32 : bits; // longer frames are 32 bit words back to back
+}
+
+static uint32_t ByteSwap(uint32_t value)
+{
+	return __builtin_bswap32(value);
+}
+
+static void Refresh(lpspi_state_t *state)
+{
+	LPSPI_Type *regs = Regs(state);
+	uint32_t fcr = regs->FCR;
+	uint32_t sr = state->flags;
+
+	if (state->txCount <= (fcr & LPSPI_FCR_TXWATER_MASK))
+		sr |= LPSPI_SR_TDF_MASK;
+	if (state->rxCount > ((fcr & LPSPI_FCR_RXWATER_MASK) >> LPSPI_FCR_RXWATER_SHIFT))
+		sr |= LPSPI_SR_RDF_MASK;
+	if ((state->phase != kPhaseIdle) || state->pcs)
+		sr |= LPSPI_SR_MBF_MASK;
+	regs->SR = sr;
+	*(volatile uint32_t *)&regs->FSR = state->txCount | (state->rxCount << LPSPI_FSR_RXCOUNT_SHIFT);
+	*(volatile uint32_t *)&regs->RSR = state->rxCount ? 0 : LPSPI_RSR_RXEMPTY_MASK;
+}
+
+static void TxPush(lpspi_state_t *state, uint32_t value, uint8_t command)
+{
+	uint32_t idx;
+
+	if (state->txCount == LPSPI_FIFO_DEPTH)
+	{
+		state->flags |= LPSPI_SR_TEF_MASK; // the write is lost
+		return;
+	}
+	idx = (state->txHead + state->txCount) % LPSPI_FIFO_DEPTH;
+	state->txFifo[idx] = value;
+	state->txCommand[idx] = command;
+	state->txCount++;
+}
+
+static void StartPhase(lpspi_state_t *state, lpspi_phase_t phase, uint32_t clocks)
+{
+	state->phase = phase;
+	state->phaseEnd = simNow + (clocks * Period(state));
+}
+
+static void StartShift(lpspi_state_t *state)
+{
+	sim_spi_stats_t *stats = &simStats.spi[state - lpspi];
+
+	state->shift = state->txFifo[state->txHead];
+	state->txHead = (state->txHead + 1) % LPSPI_FIFO_DEPTH;
+	state->txCount--;
+	if (!stats->firstSck)
+		stats->firstSck = simNow;
+	StartPhase(state, kPhaseShift, FrameBits(state) * (CcrField(state, LPSPI_CCR_SCKDIV_MASK, LPSPI_CCR_SCKDIV_SHIFT) + 2));
+}
+
+static void EndFrame(lpspi_state_t *state)
+{
+	StartPhase(state, kPhaseLag, CcrField(state, LPSPI_CCR_SCKPCS_MASK, LPSPI_CCR_SCKPCS_SHIFT) + 1);
+}
+
+/*
+ * The word is in the Rx FIFO (or masked), go on with the next one.
+ */
+static void NextWord(lpspi_state_t *state)
+{
+	state->flags |= LPSPI_SR_WCF_MASK;
+	if (!(state->tcr & LPSPI_TCR_CONT_MASK))
+		EndFrame(state);
+	else if (state->txCount && !state->txCommand[state->txHead] && Running(state))
+		StartShift(state);
+	else
+		state->phase = kPhaseIdle; // PCS stays asserted for the next word
+}
+
+static void RxPush(lpspi_state_t *state, uint32_t value)
+{
+	state->rxFifo[(state->rxHead + state->rxCount) % LPSPI_FIFO_DEPTH] = value;
+	state->rxCount++;
+}
+
+static void ShiftDone(lpspi_state_t *state)
+{
+	sim_spi_stats_t *stats = &simStats.spi[state - lpspi];
+	uint32_t bits = FrameBits(state);
+	uint32_t mask = (bits == 32) ? 0xFFFFFFFFU : ((1U << bits) - 1);
+	uint8_t swap = (state->tcr & LPSPI_TCR_BYSW_MASK) != 0;
+	uint32_t mosi = (swap ? ByteSwap(state->shift) : state->shift) & mask;
+	uint32_t miso = misoSource ? (misoSource((uint32_t)(state - lpspi) + 1, mosi, bits) & mask) : mosi;
+
+	stats->words++;
+	stats->bits += bits;
+	stats->lastSck = simNow;
+	if (state->tcr & LPSPI_TCR_RXMSK_MASK)
+	{
+		NextWord(state);
+		return;
+	}
+
+	state->received = swap ? ByteSwap(miso) : miso;
+	if (state->rxCount < LPSPI_FIFO_DEPTH)
+	{
+		RxPush(state, state->received);
+		NextWord(state);
+	}
+	else if (Regs(state)->CFGR1 & LPSPI_CFGR1_NOSTALL_MASK)
+	{
+		state->flags |= LPSPI_SR_REF_MASK;
+		stats->rxOverflows++;
+		NextWord(state);
+	}
+	else
+	{
+		state->phase = kPhaseStall;
+		stats->stalls++;
+	}
+}
+
+static void RxPop(lpspi_state_t *state)
+{
+	LPSPI_Type *regs = Regs(state);
+
+	if (!state->rxCount)
+		return; // RDR keeps the last word
+	*(volatile uint32_t *)&regs->RDR = state->rxFifo[state->rxHead];
+	state->rxHead = (state->rxHead + 1) % LPSPI_FIFO_DEPTH;
+	state->rxCount--;
+	if (state->phase == kPhaseStall)
+	{
+		RxPush(state, state->received);
+		NextWord(state);
+	}
+}
+
+/*
+ * Idle with something at the Tx FIFO head that can go now: a command always,
+ * data once the module is enabled and clocked.
+ */
+static uint8_t CanStart(const lpspi_state_t *state)
+{
+	return (state->phase == kPhaseIdle) && state->txCount
+			&& (state->txCommand[state->txHead] || Running(state));
+}
+
+static void StepInstance(lpspi_state_t *state)
+{
+	sim_spi_stats_t *stats = &simStats.spi[state - lpspi];
+
+	for (;;)
+	{
+		if (CanStart(state))
+		{
+			if (state->txCommand[state->txHead])
+			{
+				state->tcr = state->txFifo[state->txHead];
+				state->txHead = (state->txHead + 1) % LPSPI_FIFO_DEPTH;
+				state->txCount--;
+				if (state->pcs && !(state->tcr & LPSPI_TCR_CONT_MASK))
+					EndFrame(state);
+			}
+			else if (state->pcs)
+				StartShift(state);
+			else
+			{
+				state->pcs = 1;
+				stats->frames++;
+				StartPhase(state, kPhaseLead, CcrField(state, LPSPI_CCR_PCSSCK_MASK, LPSPI_CCR_PCSSCK_SHIFT) + 1);
+			}
+			continue;
+		}
+		if ((state->phase == kPhaseIdle) || (state->phase == kPhaseStall) || (simNow < state->phaseEnd))
+			break;
+
+		switch (state->phase)
+		{
+		case kPhaseLead:
+			if (state->txCount && !state->txCommand[state->txHead])
+				StartShift(state);
+			else
+				EndFrame(state); // nothing to send after all
+			break;
+		case kPhaseShift:
+			ShiftDone(state);
+			break;
+		case kPhaseLag:
+			state->pcs = 0;
+			stats->pcsNegate = simNow;
+			state->flags |= LPSPI_SR_FCF_MASK;
+			StartPhase(state, kPhaseGap, CcrField(state, LPSPI_CCR_DBT_MASK, LPSPI_CCR_DBT_SHIFT) + 2);
+			break;
+		default:
+			state->phase = kPhaseIdle;
+			if (!state->txCount)
+				state->flags |= LPSPI_SR_TCF_MASK;
+			break;
+		}
+	}
+}
+
+static void Reset(lpspi_state_t *state)
+{
+	LPSPI_Type *regs = Regs(state);
+	uint32_t cr = regs->CR;
+
+	memset((void *)regs, 0, sizeof(*regs));
+	regs->CR = cr & ~LPSPI_CR_RST_MASK;
+	regs->TCR = LPSPI_TCR_RESET;
+	state->tcr = LPSPI_TCR_RESET;
+	state->txHead = state->txCount = 0;
+	state->rxHead = state->rxCount = 0;
+	state->phase = kPhaseIdle;
+	state->pcs = 0;
+	state->flags = 0;
+	Refresh(state);
+}
+
+static void LpspiReset(void)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_INSTANCES; idx++)
+	{
+		Regs(&lpspi[idx])->CR = 0;
+		Reset(&lpspi[idx]);
+	}
+	misoSource = 0;
+}
+
+static sim_time_t LpspiNext(void)
+{
+	sim_time_t next = SIM_NEVER;
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_INSTANCES; idx++)
+	{
+		lpspi_state_t *state = &lpspi[idx];
+
+		if (CanStart(state))
+			return simNow;
+		if ((state->phase != kPhaseIdle) && (state->phase != kPhaseStall) && (state->phaseEnd < next))
+			next = state->phaseEnd;
+	}
+	return next;
+}
+
+static void LpspiStep(void)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_INSTANCES; idx++)
+	{
+		StepInstance(&lpspi[idx]);
+	}
+}
+
+const sim_model_t lpspiModel = { LpspiReset, LpspiNext, LpspiStep };
+
+void LpspiRead(uint32_t address)
+{
+	lpspi_state_t *state = FindState(address);
+	uint32_t offset = address & 0xFFFU;
+
+	if ((offset & ~3U) == offsetof(LPSPI_Type, RDR))
+		RxPop(state);
+	Refresh(state);
+}
+
+void LpspiWrite(uint32_t address)
+{
+	lpspi_state_t *state = FindState(address);
+	LPSPI_Type *regs = Regs(state);
+	uint32_t offset = address & 0xFFFU;
+
+	switch (offset & ~3U)
+	{
+	case offsetof(LPSPI_Type, CR):
+		if (regs->CR & LPSPI_CR_RST_MASK)
+			Reset(state);
+		if (regs->CR & LPSPI_CR_RTF_MASK)
+			state->txCount = 0;
+		if (regs->CR & LPSPI_CR_RRF_MASK)
+			state->rxCount = 0;
+		regs->CR &= ~(LPSPI_CR_RTF_MASK | LPSPI_CR_RRF_MASK);
+		break;
+	case offsetof(LPSPI_Type, SR):
+		state->flags &= ~(regs->SR & LPSPI_STATUS_W1C);
+		break;
+	case offsetof(LPSPI_Type, TCR):
+		TxPush(state, regs->TCR, 1);
+		break;
+	case offsetof(LPSPI_Type, TDR):
+		TxPush(state, regs->TDR, 0);
+		regs->TDR = 0; // a byte write at TDR + 3 leaves the other lanes 0
+		break;
+	default:
+		break;
+	}
+	Refresh(state);
+	StepInstance(state); // a command or a word into an idle module starts at once
+}
+
+uint8_t LpspiDmaRequest(uint32_t source)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < SIM_INSTANCES; idx++)
+	{
+		lpspi_state_t *state = &lpspi[idx];
+		LPSPI_Type *regs = Regs(state);
+
+		if (source == state->txSource)
+			return (regs->DER & LPSPI_DER_TDDE_MASK) && (state->txCount <= (regs->FCR & LPSPI_FCR_TXWATER_MASK));
+		if (source == state->rxSource)
+			return (regs->DER & LPSPI_DER_RDDE_MASK)
+					&& (state->rxCount > ((regs->FCR & LPSPI_FCR_RXWATER_MASK) >> LPSPI_FCR_RXWATER_SHIFT));
+	}
+	return 0;
+}
+
+void LpspiSetMiso(uint32_t (*miso)(uint32_t instance, uint32_t mosi, uint32_t bits))
+{
+	misoSource = miso;
+}
@@ -0,0 +1,363 @@
+/*
+ * sim_periph.c
+ *
+ *  XBAR1, GPT1, PIT, DWT, SCB and NVIC of the spi3DMA host simulator, see sim.h.
+ *
+ *  XBAR1 sees the GPIO_AD_B0_15 pad on IN25 once IOMUXC routes it there (ALT1
+ *  and the IN25 daisy 0).  An edge reaches STS of an output selecting IN25 two
+ *  IPG clocks later, STS with DEN is the DMAMUX request and the eDMA acknowledge
+ *  clears it.  GPT1 and the PIT count PERCLK from the time they were enabled,
+ *  the DWT cycle counter is the simulated time in core cycles.  The NVIC keeps
+ *  the enables of IRQ 0..31, an interrupt raised as SIGUSR1 while its vector
+ *  is disabled is held pending and raised again when ISER enables it.
+ */
+
+#include <signal.h>
+#include <stddef.h>
+#include "spi3DMAApi.h"
+#include "spi3DMA.h"
+#include "sim.h"
+
+#define XBAR_OUTPUTS      (4U)
+#define XBAR_PAD_INPUT    (25U) /* XBAR1_IN25 */
+#define XBAR_SYNC_CLOCKS  (2U)  /* IPG clocks from the pad to STS */
+#define XBAR_CLOCK_GATE   (0x00C00000U) /* CCM_CCGR2 */
+#define PAD_MUX_XBAR      (1U)  /* GPIO_AD_B0_15 ALT1 */
+#define PIT_CHANNELS      (4U)
+#define DWT_CYCCNT_OFFSET (0x004U)
+#define SCB_BASE           (0xE000E000u)
+#define SCB_DCIMVAC_OFFSET (0xF5CU)
+#define NVIC_ISER0_OFFSET  (0x100U)
+#define NVIC_ICER0_OFFSET  (0x180U)
+
+static const uint8_t xbarSource[XBAR_OUTPUTS] =
+{
+	kDmaRequestMuxXBAR1Request0 & DMAMUX_CHCFG_SOURCE_MASK,
+	kDmaRequestMuxXBAR1Request1 & DMAMUX_CHCFG_SOURCE_MASK,
+	kDmaRequestMuxXBAR1Request2 & DMAMUX_CHCFG_SOURCE_MASK,
+	kDmaRequestMuxXBAR1Request3 & DMAMUX_CHCFG_SOURCE_MASK,
+};
+
+static struct
+{
+	uint8_t padLevel;     /* level XBAR1 has seen */
+	uint8_t pendingLevel; /* pad level on its way through the synchronizer */
+	sim_time_t pendingTime;
+	uint8_t status[XBAR_OUTPUTS]; /* STS, write 1 to clear */
+} xbar;
+
+static sim_time_t gptStart;                 /* CR.EN set */
+static uint8_t gptEnabled;
+static sim_time_t pitStart[PIT_CHANNELS];   /* TCTRL.TEN set */
+static sim_time_t pitPeriod[PIT_CHANNELS];
+static uint32_t pitFired[PIT_CHANNELS];     /* periods handed to the DMAMUX */
+static uint32_t nvicEnabled;                /* ISER0, both ISER0 and ICER0 read it */
+static uint32_t nvicPending;                /* raised while disabled */
+
+static uint32_t PitCount(uint32_t channel);
+
+static XBARA_Type *Xbar(void)
+{
+	return (XBARA_Type *)SimImage(XBARA1_BASE);
+}
+
+static volatile uint16_t *XbarCtrl(uint32_t output)
+{
+	return &Xbar()->CTRL0 + (output / 2);
+}
+
+static uint32_t XbarField(uint16_t value, uint32_t output)
+{
+	return value >> ((output & 1) * 8);
+}
+
+/* STS lives in the model, the image shows it */
+static void XbarMirror(uint32_t output)
+{
+	uint16_t mask = (uint16_t)(XBARA_CTRL0_STS0_MASK << ((output & 1) * 8));
+
+	*XbarCtrl(output) = (*XbarCtrl(output) & ~mask) | (xbar.status[output] ? mask : 0);
+}
+
+static uint8_t PadRouted(void)
+{
+	IOMUXC_Type *iomuxc = (IOMUXC_Type *)SimImage(IOMUXC_BASE);
+
+	return ((iomuxc->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_15] & 0x7U) == PAD_MUX_XBAR)
+			&& (iomuxc->SELECT_INPUT[kIOMUXC_XBAR1_IN25_SELECT_INPUT] == 0)
+			&& ((((CCM_Type *)SimImage(CCM_BASE))->CCGR2 & XBAR_CLOCK_GATE) == XBAR_CLOCK_GATE);
+}
+
+static void XbarEdge(uint8_t level)
+{
+	volatile uint16_t *sel;
+	uint32_t ctrl;
+	uint32_t edge;
+	uint32_t output;
+
+	if (level == xbar.padLevel)
+		return;
+	xbar.padLevel = level;
+	if (!PadRouted())
+		return;
+
+	for (output = 0; output < XBAR_OUTPUTS; output++)
+	{
+		sel = &Xbar()->SEL0 + (output / 2);
+		if ((XbarField(*sel, output) & XBARA_SEL0_SEL0_MASK) != XBAR_PAD_INPUT)
+			continue;
+		ctrl = XbarField(*XbarCtrl(output), output);
+		edge = (ctrl & XBARA_CTRL0_EDGE0_MASK) >> XBARA_CTRL0_EDGE0_SHIFT;
+		if (edge & (level ? 1U : 2U))
+		{
+			xbar.status[output] = 1;
+			XbarMirror(output);
+			simStats.xbarEdges++;
+		}
+	}
+}
+
+static void PeriphReset(void)
+{
+	uint32_t output;
+
+	xbar.padLevel = 1; // pulled up
+	xbar.pendingLevel = 1;
+	xbar.pendingTime = SIM_NEVER;
+	for (output = 0; output < XBAR_OUTPUTS; output++)
+	{
+		xbar.status[output] = 0;
+	}
+	gptStart = 0;
+	gptEnabled = 0;
+	nvicEnabled = 0;
+	nvicPending = 0;
+	SIM_REG32(SCB_BASE + NVIC_ISER0_OFFSET) = 0;
+	SIM_REG32(SCB_BASE + NVIC_ICER0_OFFSET) = 0;
+}
+
+static sim_time_t PeriphNext(void)
+{
+	PIT_Type *pit = (PIT_Type *)SimImage(PIT_BASE);
+	sim_time_t next = xbar.pendingTime;
+	sim_time_t time;
+	uint32_t channel;
+
+	// PIT period ends, the DMAMUX trigger becomes visible to the eDMA there
+	for (channel = 0; channel < PIT_CHANNELS; channel++)
+	{
+		if (!pitPeriod[channel] || !(pit->CHANNEL[channel].TCTRL & PIT_TCTRL_TEN_MASK))
+			continue;
+		time = pitStart[channel] + ((PitCount(channel) + 1ULL) * pitPeriod[channel]);
+		if (time < next)
+			next = time;
+	}
+	return next;
+}
+
+static void PeriphStep(void)
+{
+	if (simNow >= xbar.pendingTime)
+	{
+		xbar.pendingTime = SIM_NEVER;
+		XbarEdge(xbar.pendingLevel);
+	}
+}
+
+const sim_model_t periphModel = { PeriphReset, PeriphNext, PeriphStep };
+
+void XbarWrite(uint32_t address)
+{
+	uint32_t offset = (address - XBARA1_BASE) & ~1U;
+	uint32_t first;
+	uint32_t output;
+	uint16_t value;
+
+	if (offset < offsetof(XBARA_Type, CTRL0))
+		return;
+	first = offset - offsetof(XBARA_Type, CTRL0); // two outputs per 16 bit CTRL register
+	value = *XbarCtrl(first);
+	for (output = first; (output < (first + 2)) && (output < XBAR_OUTPUTS); output++)
+	{
+		if (XbarField(value, output) & XBARA_CTRL0_STS0_MASK)
+			xbar.status[output] = 0;
+		XbarMirror(output);
+	}
+}
+
+/*
+ * The pad changes now, XBAR1 sees it after the synchronizer.  A change while
+ * the previous one is still on its way pushes that one through first.
+ */
+void XbarSetPad(uint8_t level)
+{
+	if (xbar.pendingTime != SIM_NEVER)
+		XbarEdge(xbar.pendingLevel);
+	xbar.pendingLevel = level ? 1 : 0;
+	xbar.pendingTime = SimAlign(simNow, SIM_PS(1, SIM_BUS_HZ)) + SIM_PS(XBAR_SYNC_CLOCKS, SIM_BUS_HZ);
+}
+
+uint8_t XbarDmaRequest(uint32_t source)
+{
+	uint32_t output;
+
+	for (output = 0; output < XBAR_OUTPUTS; output++)
+	{
+		if (source == xbarSource[output])
+			return xbar.status[output] && (XbarField(*XbarCtrl(output), output) & XBARA_CTRL0_DEN0_MASK);
+	}
+	return 0;
+}
+
+void XbarDmaAck(uint32_t source)
+{
+	uint32_t output;
+
+	for (output = 0; output < XBAR_OUTPUTS; output++)
+	{
+		if (source == xbarSource[output])
+		{
+			xbar.status[output] = 0;
+			XbarMirror(output);
+		}
+	}
+}
+
+uint32_t GptCount(sim_time_t time)
+{
+	GPT_Type *gpt = (GPT_Type *)SimImage(GPT1_BASE);
+
+	if (!(gpt->CR & GPT_CR_EN_MASK) || (time < gptStart))
+		return 0;
+	return (uint32_t)(SIM_CYCLES(time - gptStart, SPI3_TIMESTAMP_HZ) / (gpt->PR + 1));
+}
+
+void GptRead(uint32_t address)
+{
+	GPT_Type *gpt = (GPT_Type *)SimImage(GPT1_BASE);
+
+	(void)address;
+	*(volatile uint32_t *)&gpt->CNT = GptCount(simNow);
+}
+
+void GptWrite(uint32_t address)
+{
+	GPT_Type *gpt = (GPT_Type *)SimImage(GPT1_BASE);
+
+	if ((address - GPT1_BASE) != offsetof(GPT_Type, CR))
+		return;
+	if ((gpt->CR & GPT_CR_EN_MASK) && !gptEnabled)
+		gptStart = simNow; // ENMOD, the count starts over at 0
+	gptEnabled = (gpt->CR & GPT_CR_EN_MASK) != 0;
+}
+
+static uint32_t PitCount(uint32_t channel)
+{
+	PIT_Type *pit = (PIT_Type *)SimImage(PIT_BASE);
+
+	if (!(pit->CHANNEL[channel].TCTRL & PIT_TCTRL_TEN_MASK) || (pit->MCR & PIT_MCR_MDIS_MASK))
+		return 0;
+	return (uint32_t)((simNow - pitStart[channel]) / pitPeriod[channel]); // periods elapsed
+}
+
+void PitRead(uint32_t address)
+{
+	PIT_Type *pit = (PIT_Type *)SimImage(PIT_BASE);
+	uint32_t offset = address - PIT_BASE;
+	uint32_t channel;
+	sim_time_t elapsed;
+
+	if (offset < offsetof(PIT_Type, CHANNEL))
+		return;
+	channel = (offset - offsetof(PIT_Type, CHANNEL)) / sizeof(pit->CHANNEL[0]);
+	if ((channel >= PIT_CHANNELS) || !pitPeriod[channel] || !(pit->CHANNEL[channel].TCTRL & PIT_TCTRL_TEN_MASK))
+		return;
+	elapsed = (simNow - pitStart[channel]) % pitPeriod[channel];
+	*(volatile uint32_t *)&pit->CHANNEL[channel].CVAL = pit->CHANNEL[channel].LDVAL
+			- (uint32_t)SIM_CYCLES(elapsed, SPI3_TIMESTAMP_HZ);
+	if (PitCount(channel))
+		pit->CHANNEL[channel].TFLG = PIT_TFLG_TIF_MASK;
+}
+
+void PitWrite(uint32_t address)
+{
+	PIT_Type *pit = (PIT_Type *)SimImage(PIT_BASE);
+	uint32_t offset = address - PIT_BASE;
+	uint32_t channel;
+
+	if (offset < offsetof(PIT_Type, CHANNEL))
+		return;
+	channel = (offset - offsetof(PIT_Type, CHANNEL)) / sizeof(pit->CHANNEL[0]);
+	if (channel >= PIT_CHANNELS)
+		return;
+	switch ((offset - offsetof(PIT_Type, CHANNEL)) % sizeof(pit->CHANNEL[0]))
+	{
+	case offsetof(PIT_Type, CHANNEL[0].TCTRL) - offsetof(PIT_Type, CHANNEL):
+		// a disabled timer starts over with LDVAL
+		pitStart[channel] = simNow;
+		pitPeriod[channel] = SIM_PS(pit->CHANNEL[channel].LDVAL + 1ULL, SPI3_TIMESTAMP_HZ);
+		pitFired[channel] = 0;
+		break;
+	case offsetof(PIT_Type, CHANNEL[0].TFLG) - offsetof(PIT_Type, CHANNEL):
+		pit->CHANNEL[channel].TFLG = 0;
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * DMAMUX periodic trigger: one request per PIT period the channel has not taken yet.
+ */
+uint8_t PitTrigger(uint32_t channel)
+{
+	return (channel < PIT_CHANNELS) && pitPeriod[channel] && (PitCount(channel) > pitFired[channel]);
+}
+
+void PitTriggerAck(uint32_t channel)
+{
+	if (channel < PIT_CHANNELS)
+		pitFired[channel] = PitCount(channel);
+}
+
+void DwtRead(uint32_t address)
+{
+	if ((address & 0xFFFU) == DWT_CYCCNT_OFFSET)
+		SIM_REG32(address) = (uint32_t)SIM_CYCLES(simNow, SIM_CORE_HZ);
+}
+
+void ScbWrite(uint32_t address)
+{
+	switch (address & 0xFFFU)
+	{
+	case SCB_DCIMVAC_OFFSET:
+		simStats.dcacheInvalidates++;
+		break;
+	case NVIC_ISER0_OFFSET:
+		nvicEnabled |= SIM_REG32(address);
+		break;
+	case NVIC_ICER0_OFFSET:
+		nvicEnabled &= ~SIM_REG32(address);
+		break;
+	default:
+		return;
+	}
+	SIM_REG32(SCB_BASE + NVIC_ISER0_OFFSET) = nvicEnabled;
+	SIM_REG32(SCB_BASE + NVIC_ICER0_OFFSET) = nvicEnabled;
+	if (nvicPending & nvicEnabled)
+	{
+		// taken after the enabling access, SIGUSR1 is masked until it completed
+		nvicPending &= ~nvicEnabled;
+		raise(SIGUSR1);
+	}
+}
+
+uint8_t SimIrqEnabled(uint32_t irq)
+{
+	return (nvicEnabled >> irq) & 1U;
+}
+
+void SimIrqPend(uint32_t irq)
+{
+	nvicPending |= 1U << irq;
+}
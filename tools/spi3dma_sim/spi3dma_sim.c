@@ -0,0 +1,593 @@
+/*
+ * spi3dma_sim.c
+ *
+ *  Runs source/spi3DMA.c on the host model of sim.h.  LPSPI3 is armed for the
+ *  GPIO_AD_B0_15 falling edge the way the start command does it, then every
+ *  frame length is triggered in byte and in word mode.  Per frame it prints the
+ *  edge to first SCK latency, edge to PCS negation, the throughput over that
+ *  time, the DMA requests and minor loops of the Rx, Tx and trigger channels
+ *  and the eDMA bus beats, and checks the looped back Rx data against Tx.
+ *  Before that the register images InitGPIOTrigger() and InitDMAandEDMA() left
+ *  are checked against the trigger path, starting from values that are wrong.
+ *  After it the frame setup calls are checked while a frame is in flight and on
+ *  buffers word mode can not take, the ring timestamps on a trigger dropped
+ *  while a frame is in flight, and the cache maintenance of a flushed partial
+ *  batch.  Last the latency bench of spi3Bench.c runs on the simulated timing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spi3DMAApi.h"
+#include "spi3DMA.h"
+#include "sim.h"
+
+#define SIM_SPI_INSTANCE (3U)
+#define SIM_SCK_DIVIDER  (4U)   /* 17.6 MHz SCK, the fastest spi3Bench sweep step */
+#define SIM_FRAME_MAX    (1024U)
+#define SIM_EDGE_GAP_US  (20U)  /* pad high before the next edge */
+#define SIM_RING_SLOTS   (4U)
+#define SIM_SAMPLES      (256U) /* latency bench, as the latency command */
+#define SIM_SAMPLE_US    (100U)
+
+#define CH_RX      (0U)         /* LPSPI3 channels, firstChannel 0 */
+#define CH_TX      (1U)
+#define CH_TRIG_TX (2U)
+#define CH_TRIG_RX (3U)
+
+#define TRIGGER_INPUT (25U)     /* XBAR1_IN25, GPIO_AD_B0_15 ALT1 */
+
+static int failures;
+
+#define CHECK(condition)                                                   \
+	do                                                                     \
+	{                                                                      \
+		if (!(condition))                                                  \
+		{                                                                  \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #condition); \
+			failures++;                                                    \
+		}                                                                  \
+	} while (0)
+
+static const uint32_t frameLengths[] = { 4, 25, 64, 256, 1024 };
+
+/* the eDMA only reaches the low 4 GiB, static data of a non-PIE build is there */
+static uint8_t txBuffer[SIM_FRAME_MAX] __attribute__((aligned(32)));
+static uint8_t rxBuffer[SIM_FRAME_MAX] __attribute__((aligned(32)));
+static uint8_t rxRing[SIM_RING_SLOTS * 64] __attribute__((aligned(256))); // a stream buffer too, DMOD 8
+
+static uint32_t sckSample[SIM_SAMPLES];     /* edge to first SCK, ns from the LPSPI model */
+static uint32_t latencySample[SIM_SAMPLES]; /* edge to last Rx byte, GPT1 ticks */
+static uint32_t frameSample[SIM_SAMPLES];   /* edge to DMA_irq(), DWT cycles */
+
+static uint32_t Nanoseconds(sim_time_t time)
+{
+	return (uint32_t)(time / SIM_PS_PER_NS);
+}
+
+static uint32_t BusBeats(void)
+{
+	uint32_t beats = 0;
+	uint32_t channel;
+
+	for (channel = 0; channel < SIM_CHANNELS; channel++)
+	{
+		beats += simStats.channel[channel].readBeats + simStats.channel[channel].writeBeats;
+	}
+	return beats;
+}
+
+static uint32_t MinorLoops(void)
+{
+	uint32_t loops = 0;
+	uint32_t channel;
+
+	for (channel = 0; channel < SIM_CHANNELS; channel++)
+	{
+		loops += simStats.channel[channel].minorLoops;
+	}
+	return loops;
+}
+
+/*
+ * What a missed register write would leave behind, none of it starts a frame.
+ */
+static void PoisonTriggerPath(void)
+{
+	IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_15] = 5; // GPIO1_IO15
+	IOMUXC->SELECT_INPUT[kIOMUXC_XBAR1_IN25_SELECT_INPUT] = 1;        // GPIO_AD_B1_15
+	XBARA1->SEL0 = XBARA_SEL0_SEL0(24) | XBARA_SEL0_SEL1(25);
+	XBARA1->CTRL0 = XBARA_CTRL0_IEN0_MASK | XBARA_CTRL0_EDGE0(1) | XBARA_CTRL0_DEN1_MASK;
+	DMAMUX->CHCFG[CH_TRIG_TX] = DMAMUX_CHCFG_A_ON_MASK | DMAMUX_CHCFG_SOURCE(kDmaRequestMuxXBAR1Request1);
+}
+
+/*
+ * GPIO_AD_B0_15 -> XBAR1_IN25 -> XBAR1_OUT0 -> DMAMUX REQ30 -> trigger Tx channel
+ * -> SERQ(Tx), link -> trigger Rx channel -> SERQ(Rx).
+ */
+static void CheckTriggerWiring(void)
+{
+	const edma_tcd_t *trigTx = (const edma_tcd_t *)&DMA0->TCD[CH_TRIG_TX];
+	const edma_tcd_t *trigRx = (const edma_tcd_t *)&DMA0->TCD[CH_TRIG_RX];
+
+	CHECK((IOMUXC->SW_MUX_CTL_PAD[kIOMUXC_SW_MUX_CTL_PAD_GPIO_AD_B0_15] & 0x7U) == 1); // ALT1 XBAR1_IN25
+	CHECK(IOMUXC->SELECT_INPUT[kIOMUXC_XBAR1_IN25_SELECT_INPUT] == 0);                // daisy GPIO_AD_B0_15
+	CHECK((XBARA1->SEL0 & XBARA_SEL0_SEL0_MASK) == XBARA_SEL0_SEL0(TRIGGER_INPUT));   // OUT0 from IN25
+	CHECK((XBARA1->SEL0 & XBARA_SEL0_SEL1_MASK) == XBARA_SEL0_SEL1(25));              // OUT1 untouched
+	CHECK((XBARA1->CTRL0 & (XBARA_CTRL0_DEN0_MASK | XBARA_CTRL0_IEN0_MASK | XBARA_CTRL0_EDGE0_MASK))
+			== (XBARA_CTRL0_DEN0_MASK | XBARA_CTRL0_EDGE0(2)));                       // DMA request on falling edge
+	CHECK(XBARA1->CTRL0 & XBARA_CTRL0_DEN1_MASK);
+	CHECK(!(XBARA1->CTRL0 & XBARA_CTRL0_STS0_MASK));
+
+	CHECK(DMAMUX->CHCFG[CH_RX] == (DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(kDmaRequestMuxLPSPI3Rx)));
+	CHECK(DMAMUX->CHCFG[CH_TX] == (DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(kDmaRequestMuxLPSPI3Tx)));
+	CHECK(DMAMUX->CHCFG[CH_TRIG_TX] == (DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(kDmaRequestMuxXBAR1Request0)));
+	CHECK((DMAMUX_CHCFG_SOURCE(kDmaRequestMuxXBAR1Request0) & DMAMUX_CHCFG_SOURCE_MASK) == 30);
+	CHECK(DMAMUX->CHCFG[CH_TRIG_RX] == DMAMUX_CHCFG_ENBL_MASK);
+
+	// trigger Tx: one byte, the Tx channel number, into SERQ; keeps its ERQ; links trigger Rx
+	CHECK(trigTx->DADDR == (uint32_t)(uintptr_t)&DMA0->SERQ);
+	CHECK((trigTx->NBYTES == 1) && (trigTx->ATTR == 0) && (trigTx->CITER == 1) && (trigTx->BITER == 1));
+	CHECK(*(const uint8_t *)(uintptr_t)trigTx->SADDR == CH_TX);
+	CHECK(!(trigTx->CSR & DMA_CSR_DREQ_MASK));
+	CHECK((trigTx->CSR & (DMA_CSR_MAJORELINK_MASK | DMA_CSR_MAJORLINKCH_MASK))
+			== (DMA_CSR_MAJORELINK_MASK | DMA_CSR_MAJORLINKCH(CH_TRIG_RX)));
+	CHECK(DMA0->ERQ & (1U << CH_TRIG_TX));
+
+	// trigger Rx: the Rx channel number into SERQ, started by the link only
+	CHECK(trigRx->DADDR == (uint32_t)(uintptr_t)&DMA0->SERQ);
+	CHECK((trigRx->NBYTES == 1) && (trigRx->CITER == 1));
+	CHECK(*(const uint8_t *)(uintptr_t)trigRx->SADDR == CH_RX);
+	CHECK(!(DMA0->ERQ & (1U << CH_TRIG_RX)));
+}
+
+/*
+ * One falling edge, run until the frame is done and the pad is back high.
+ */
+static void FillTxBuffer(uint32_t length)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < length; idx++)
+	{
+		txBuffer[idx] = (uint8_t)((idx * 7) + length);
+	}
+	memset(rxBuffer, 0, sizeof(rxBuffer));
+}
+
+static void SimFrame(uint32_t length, uint8_t wordMode)
+{
+	const sim_spi_stats_t *spi = &simStats.spi[SIM_SPI_INSTANCE - 1];
+	sim_time_t edge;
+	sim_time_t span;
+
+	FillTxBuffer(length);
+
+	SimClearStats();
+	edge = SimNow();
+	SimSetPad(0);
+	SimRun((sim_time_t)(length + 10) * 10 * SIM_PS_PER_US); // 10 us per byte is above any divider
+	SimSetPad(1);
+	SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+
+	CHECK(simStats.dmaErrors == 0);
+	CHECK(spi->bits == (length * 8));
+	CHECK(memcmp(rxBuffer, txBuffer, length) == 0);
+	if (!spi->firstSck || (spi->pcsNegate < spi->firstSck))
+	{
+		printf("%5u %-4s no frame\n", length, wordMode ? "word" : "byte");
+		failures++;
+		return;
+	}
+
+	span = spi->pcsNegate - edge;
+	printf("%5u %-4s %6u %8u %9llu %5u %5u %4u %4u %6u %6u %4u %4u\n", length, wordMode ? "word" : "byte",
+			Nanoseconds(spi->firstSck - edge), Nanoseconds(span),
+			(unsigned long long)(((uint64_t)length * 1000000000000ULL) / span),
+			simStats.channel[CH_RX].hwRequests, simStats.channel[CH_TX].hwRequests,
+			simStats.channel[CH_TRIG_TX].hwRequests,
+			simStats.channel[CH_TRIG_RX].minorLoops, MinorLoops(), BusBeats(),
+			simStats.channel[CH_RX].tcdLoads + simStats.channel[CH_TX].tcdLoads, simStats.irqs);
+}
+
+/*
+ * New frame length while a frame is on the wire: SetSPI3Frame() waits for it, the
+ * frame completes on the old TCDs and the next edge runs the new length.
+ */
+static void CheckReloadInFlight(spi3dma_handle_t *spi3, spi3_frame_t *frame)
+{
+	const sim_spi_stats_t *spi = &simStats.spi[SIM_SPI_INSTANCE - 1];
+
+	frame->length = 256;
+	CHECK(SetSPI3WordMode(spi3, 0) == 0);
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+	FillTxBuffer(frame->length);
+
+	SimClearStats();
+	SimSetPad(0);
+	SimRun(50 * SIM_PS_PER_US);
+	CHECK((spi->words > 0) && (spi->words < 256));
+
+	frame->length = 64;
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+	CHECK(spi->words == 256); // returned only after the last byte
+	SimSetPad(1);
+	SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+	CHECK(spi->words == 256);
+	CHECK(simStats.dmaErrors == 0);
+	CHECK(memcmp(rxBuffer, txBuffer, 256) == 0);
+
+	printf("reload while a 256 byte frame is in flight, then 64 bytes:\n");
+	SimFrame(frame->length, 0);
+}
+
+/*
+ * The Rx setup calls reload the Rx TCD of a running handle, the SCK divider
+ * disables the LPSPI.  Called while a 64 byte frame is on the wire each one has
+ * to wait for it, then the next edge runs a whole frame with Rx and Tx in step.
+ */
+enum
+{
+	RX_SETUP_RING,      /* SetSPI3RxRing() */
+	RX_SETUP_BATCH,     /* SetSPI3RxBatch() on the ring */
+	RX_SETUP_STREAM,    /* SetSPI3RxStream() into the ring buffer */
+	RX_SETUP_TIMESTAMP, /* EnableSPI3FrameTimestamp() on the ring, stays on */
+	RX_SETUP_SCK,       /* SetSPI3SckDivider() with the ring on, disables the LPSPI */
+	RX_SETUP_COUNT
+};
+
+static const char *const rxSetupNames[RX_SETUP_COUNT] = { "ring", "batch", "stream", "timestamp", "SCK divider" };
+
+static int32_t RxSetup(spi3dma_handle_t *spi3, uint32_t step)
+{
+	switch (step)
+	{
+	case RX_SETUP_RING:
+		return SetSPI3RxRing(spi3, rxRing, SIM_RING_SLOTS);
+	case RX_SETUP_BATCH:
+		return SetSPI3RxBatch(spi3, 2);
+	case RX_SETUP_STREAM:
+		return SetSPI3RxStream(spi3, rxRing, 8);
+	case RX_SETUP_TIMESTAMP:
+		EnableSPI3FrameTimestamp(spi3);
+		return 0;
+	case RX_SETUP_SCK:
+		SetSPI3SckDivider(spi3, SIM_SCK_DIVIDER);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+static void CheckRxSetupInFlight(spi3dma_handle_t *spi3, spi3_frame_t *frame)
+{
+	const sim_spi_stats_t *spi = &simStats.spi[SIM_SPI_INSTANCE - 1];
+	uint32_t step;
+
+	frame->length = 64;
+	CHECK(SetSPI3WordMode(spi3, 0) == 0);
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+	FillTxBuffer(frame->length);
+
+	for (step = 0; step < RX_SETUP_COUNT; step++)
+	{
+		if ((step == RX_SETUP_BATCH) || (step == RX_SETUP_TIMESTAMP) || (step == RX_SETUP_SCK))
+			CHECK(SetSPI3RxRing(spi3, rxRing, SIM_RING_SLOTS) == 0);
+		memset(rxRing, 0, sizeof(rxRing));
+
+		SimClearStats();
+		SimSetPad(0);
+		if (step == RX_SETUP_SCK)
+		{
+			SimRun(100 * SIM_PS_PER_NS); // trigger chain running, nothing in the LPSPI yet (MBF 0)
+			CHECK(spi->words == 0);
+		}
+		else
+		{
+			SimRun(10 * SIM_PS_PER_US);
+			CHECK((spi->words > 0) && (spi->words < 64));
+		}
+		CHECK(RxSetup(spi3, step) == 0);
+		CHECK(spi->words == 64); // returned only after the last byte
+		SimSetPad(1);
+		SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+
+		SimSetPad(0);
+		SimRun(100 * SIM_PS_PER_US);
+		SimSetPad(1);
+		SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+		if ((simStats.dmaErrors != 0) || (spi->words != (2 * 64)) || (simStats.channel[CH_RX].majorLoops != 2)
+				|| (simStats.channel[CH_TX].majorLoops != 2) || (memcmp(rxRing, txBuffer, 64) != 0))
+		{
+			// every later reload would wait for an Rx channel that never finishes
+			printf("%s setup during a frame: Rx and Tx out of step\nspi3dma_sim: FAIL\n", rxSetupNames[step]);
+			exit(1);
+		}
+
+		CHECK(SetSPI3RxStream(spi3, 0, 0) == 0);
+		CHECK(SetSPI3RxBatch(spi3, 1) == 0);
+		CHECK(SetSPI3RxRing(spi3, 0, 0) == 0);
+	}
+}
+
+/*
+ * Word mode takes 4 byte aligned buffers only, byte mode any.
+ */
+static void CheckWordAlignment(spi3dma_handle_t *spi3, spi3_frame_t *frame)
+{
+	spi3_frame_t odd = *frame;
+
+	odd.length = 64;
+	CHECK(SetSPI3WordMode(spi3, 1) == 0);
+	odd.txBuffer = txBuffer + 1;
+	CHECK(SetSPI3Frame(spi3, &odd) == -1);
+	odd.txBuffer = txBuffer;
+	odd.rxBuffer = rxBuffer + 2;
+	CHECK(SetSPI3Frame(spi3, &odd) == -1);
+
+	CHECK(SetSPI3WordMode(spi3, 0) == 0);
+	CHECK(SetSPI3Frame(spi3, &odd) == 0);
+	CHECK(SetSPI3WordMode(spi3, 1) == -1);
+	odd.length = 3; // goes as bytes in word mode too
+	CHECK(SetSPI3Frame(spi3, &odd) == 0);
+	CHECK(SetSPI3WordMode(spi3, 1) == 0);
+	CHECK(SetSPI3WordMode(spi3, 0) == 0);
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+}
+
+/*
+ * A second edge while a 64 byte frame is in flight is dropped.  The timestamps
+ * are linked from the frame end, so frame 1 has to carry the time of the edge
+ * after the dropped one, one frame time after it, not the dropped edge's.
+ */
+static void CheckTimestampOverrun(spi3dma_handle_t *spi3, spi3_frame_t *frame)
+{
+	spi3_rx_frame_t rxFrame[2];
+	sim_time_t edge[2];
+	uint32_t expected;
+	uint32_t idx;
+
+	frame->length = 64;
+	CHECK(SetSPI3WordMode(spi3, 0) == 0);
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+	CHECK(SetSPI3RxBatch(spi3, 1) == 0);
+	CHECK(SetSPI3RxRing(spi3, rxRing, SIM_RING_SLOTS) == 0);
+	EnableSPI3FrameTimestamp(spi3);
+
+	SimClearStats();
+	edge[0] = SimNow();
+	SimSetPad(0);
+	SimRun(5 * SIM_PS_PER_US);
+	SimSetPad(1);
+	SimRun(5 * SIM_PS_PER_US);
+	SimSetPad(0); // frame 0 still on the wire
+	SimRun(100 * SIM_PS_PER_US);
+	SimSetPad(1);
+	SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+	edge[1] = SimNow();
+	SimSetPad(0);
+	SimRun(100 * SIM_PS_PER_US);
+	SimSetPad(1);
+	SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+
+	CHECK(simStats.spi[SIM_SPI_INSTANCE - 1].words == (2 * 64)); // the dropped edge started nothing
+	for (idx = 0; idx < 2; idx++)
+	{
+		CHECK(GetSPI3RxFrame(spi3, &rxFrame[idx]) == 0);
+		CHECK(rxFrame[idx].sequence == idx);
+	}
+	expected = (uint32_t)SIM_CYCLES(edge[1] - edge[0], SPI3_TIMESTAMP_HZ);
+	printf("frame timestamps %u ticks apart after a dropped edge, edges %u ticks apart\n",
+			rxFrame[1].timestamp - rxFrame[0].timestamp, expected);
+	CHECK((rxFrame[1].timestamp - rxFrame[0].timestamp) <= (expected + 2));
+	CHECK((rxFrame[1].timestamp - rxFrame[0].timestamp) >= (expected - 2));
+	for (idx = 0; idx < 2; idx++)
+	{
+		CHECK(ReleaseSPI3RxFrame(spi3, &rxFrame[idx]) == 0);
+	}
+	CHECK(SetSPI3RxRing(spi3, 0, 0) == 0);
+}
+
+/*
+ * One frame of a two frame batch, published by FlushSPI3RxBatch() with cache
+ * maintenance on: its two D-cache lines are invalidated before it is handed out.
+ */
+static void CheckFlushInvalidate(spi3dma_handle_t *spi3, spi3_frame_t *frame)
+{
+	spi3_rx_frame_t rxFrame;
+
+	frame->length = 64;
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+	CHECK(SetSPI3RxRing(spi3, rxRing, SIM_RING_SLOTS) == 0);
+	CHECK(SetSPI3RxBatch(spi3, 2) == 0);
+	SetSPI3RxCacheMaintenance(spi3, 1);
+
+	SimClearStats();
+	SimSetPad(0);
+	SimRun(100 * SIM_PS_PER_US);
+	SimSetPad(1);
+	SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+	CHECK(simStats.irqs == 0);
+	CHECK(GetSPI3RxFrame(spi3, &rxFrame) == -1);
+
+	CHECK(FlushSPI3RxBatch(spi3) == 1);
+	CHECK(simStats.dcacheInvalidates == (64 / 32));
+	CHECK(FlushSPI3RxBatch(spi3) == 1);
+	CHECK(simStats.dcacheInvalidates == (64 / 32)); // published already
+	CHECK(GetSPI3RxFrame(spi3, &rxFrame) == 0);
+	CHECK(ReleaseSPI3RxFrame(spi3, &rxFrame) == 0);
+
+	SetSPI3RxCacheMaintenance(spi3, 0);
+	CHECK(SetSPI3RxBatch(spi3, 1) == 0);
+	CHECK(SetSPI3RxRing(spi3, 0, 0) == 0);
+}
+
+static void SortSamples(uint32_t *sample, uint32_t count)
+{
+	uint32_t idx;
+	uint32_t pos;
+	uint32_t value;
+
+	for (idx = 1; idx < count; idx++)
+	{
+		value = sample[idx];
+		for (pos = idx; (pos > 0) && (sample[pos - 1] > value); pos--)
+		{
+			sample[pos] = sample[pos - 1];
+		}
+		sample[pos] = value;
+	}
+}
+
+/*
+ * min/mean/p99/max in ns and an 8 bin histogram, the layout of spi3Bench.c.
+ */
+static void PrintSamples(const char *name, uint32_t *sample, uint32_t count, uint32_t clockHz)
+{
+	uint64_t sum = 0;
+	uint32_t bin[8] = {0};
+	uint32_t span;
+	uint32_t idx;
+
+	SortSamples(sample, count);
+	for (idx = 0; idx < count; idx++)
+	{
+		sum += sample[idx];
+	}
+	span = sample[count - 1] - sample[0] + 1;
+	for (idx = 0; idx < count; idx++)
+	{
+		bin[((uint64_t)(sample[idx] - sample[0]) * 8) / span]++;
+	}
+
+	printf("%s ns: min %u mean %u p99 %u max %u\n", name,
+			(uint32_t)(((uint64_t)sample[0] * 1000000000U) / clockHz),
+			(uint32_t)(((sum / count) * 1000000000U) / clockHz),
+			(uint32_t)(((uint64_t)sample[(count * 99) / 100] * 1000000000U) / clockHz),
+			(uint32_t)(((uint64_t)sample[count - 1] * 1000000000U) / clockHz));
+	for (idx = 0; idx < 8; idx++)
+	{
+		printf("  %u.. : %u\n",
+				(uint32_t)(((uint64_t)(sample[0] + ((span * idx) / 8)) * 1000000000U) / clockHz), bin[idx]);
+	}
+}
+
+/*
+ * BenchTriggerLatency() on simulated time: the same GPT1 and DWT reads around the
+ * edge, one interrupt per frame, 4 byte frames into the ring.  The edges are
+ * spread over a bus clock period so the XBAR synchronizer sees every phase.
+ * Edge to first SCK comes from the LPSPI model, the target can not measure it.
+ */
+static void SimBenchLatency(spi3dma_handle_t *spi3, spi3_frame_t *frame)
+{
+	const sim_spi_stats_t *spi = &simStats.spi[SIM_SPI_INSTANCE - 1];
+	spi3_rx_frame_t rxFrame;
+	sim_time_t edge;
+	uint32_t producer;
+	uint32_t edgeTicks;
+	uint32_t edgeCycles;
+	uint32_t idx;
+
+	frame->length = 4;
+	CHECK(SetSPI3Frame(spi3, frame) == 0);
+	CHECK(SetSPI3RxBatch(spi3, 1) == 0);
+	CHECK(SetSPI3RxRing(spi3, rxRing, SIM_RING_SLOTS) == 0);
+	EnableSPI3FrameTimestamp(spi3);
+
+	for (idx = 0; idx < SIM_SAMPLES; idx++)
+	{
+		SimSetPad(1);
+		SimRun((SIM_SAMPLE_US * SIM_PS_PER_US) + ((idx * 7919U) % SIM_PS(1, SIM_BUS_HZ)));
+
+		producer = FlushSPI3RxBatch(spi3);
+		edgeTicks = GPT1->CNT;
+		edgeCycles = DWT_CYCCNT_REG;
+		SimClearStats();
+		edge = SimNow();
+		SimSetPad(0);
+
+		while ((GetSPI3RxProducerIndex(spi3) == producer) && ((SimNow() - edge) < (SIM_SAMPLE_US * SIM_PS_PER_US)))
+		{
+			SimRun(SIM_PS_PER_US);
+		}
+		if (GetSPI3RxProducerIndex(spi3) == producer)
+		{
+			printf("no frame for sample %u\n", idx);
+			failures++;
+			break;
+		}
+
+		sckSample[idx] = Nanoseconds(spi->firstSck - edge);
+		latencySample[idx] = GetSPI3RxTimestamp(spi3, producer) - edgeTicks;
+		frameSample[idx] = GetSPI3RxIrqCycles(spi3) - edgeCycles;
+		while (GetSPI3RxFrame(spi3, &rxFrame) == 0)
+		{
+			CHECK(ReleaseSPI3RxFrame(spi3, &rxFrame) == 0);
+		}
+	}
+	SimSetPad(1);
+	SimRun(SIM_EDGE_GAP_US * SIM_PS_PER_US);
+	CHECK(simStats.dmaErrors == 0);
+	CHECK(SetSPI3RxRing(spi3, 0, 0) == 0);
+	if (idx < SIM_SAMPLES)
+		return;
+
+	printf("\n%u samples, %u us apart, 4 byte frames\n", SIM_SAMPLES, SIM_SAMPLE_US);
+	PrintSamples("edge to SCK", sckSample, SIM_SAMPLES, 1000000000U);
+	PrintSamples("edge to Rx done", latencySample, SIM_SAMPLES, SPI3_TIMESTAMP_HZ);
+	PrintSamples("edge to frame done", frameSample, SIM_SAMPLES, (uint32_t)SIM_CORE_HZ);
+}
+
+int main(void)
+{
+	spi3dma_handle_t *spi3;
+	spi3_frame_t frame;
+	uint32_t idx;
+	uint8_t wordMode;
+
+	if (SimInit())
+	{
+		printf("register blocks can not be mapped, build non-PIE on a 64 bit host\n");
+		return 1;
+	}
+
+	spi3 = GetSPI3Handle(SIM_SPI_INSTANCE);
+	PoisonTriggerPath();
+	InitClocks();
+	InitSPI3Peripheral(spi3);
+	frame.length = frameLengths[0];
+	frame.txBuffer = txBuffer;
+	frame.rxBuffer = rxBuffer;
+	SetSPI3Frame(spi3, &frame);
+	InitDMAandEDMA(spi3);
+	InitGPIOTrigger(spi3, TRIGGER_INPUT);
+	RestSPI3Peripheral(spi3, frame.txBuffer, frame.rxBuffer);
+	NVIC_ISER0_REG = SPI3_DMA_IRQ_MASK(CH_RX); // as the example enables DMA0_DMA16_IRQn
+	CheckTriggerWiring();
+	SetSPI3SckDivider(spi3, SIM_SCK_DIVIDER);
+
+	printf("LPSPI3 SCK %u kHz, GPIO_AD_B0_15 falling edge per frame\n",
+			SPI3_LPSPI_CLK_HZ / (SIM_SCK_DIVIDER + 2) / 1000);
+	printf("bytes mode   edge>SCK    frame   bytes/s  rxRq  txRq trRq trLk  minor  beats  sga  irq\n");
+	printf("                   ns       ns\n");
+	for (wordMode = 0; wordMode < 2; wordMode++)
+	{
+		for (idx = 0; idx < (sizeof(frameLengths) / sizeof(frameLengths[0])); idx++)
+		{
+			frame.length = frameLengths[idx];
+			CHECK(SetSPI3WordMode(spi3, wordMode) == 0);
+			CHECK(SetSPI3Frame(spi3, &frame) == 0);
+			SimFrame(frame.length, wordMode);
+		}
+	}
+
+	CheckReloadInFlight(spi3, &frame);
+	CheckRxSetupInFlight(spi3, &frame);
+	CheckWordAlignment(spi3, &frame);
+	CheckTimestampOverrun(spi3, &frame);
+	CheckFlushInvalidate(spi3, &frame);
+	SimBenchLatency(spi3, &frame);
+
+	printf("spi3dma_sim: %s\n", failures ? "FAIL" : "pass");
+	return failures ? 1 : 0;
+}
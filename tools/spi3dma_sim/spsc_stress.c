@@ -0,0 +1,297 @@
+/*
+ * spsc_stress.c
+ *
+ *  Stress of the zero-copy Rx frame queue of source/spi3DMA.c on the host model
+ *  of sim.h.  A producer thread stands in for the Rx channel: at every frame
+ *  start it looks at the trigger channel's ERQ bit the way the XBAR request
+ *  would, writes the frame sequence into the ring slot and raises the batch
+ *  interrupt as SIGUSR1 on the main thread, whose handler runs DMA_irq().  The
+ *  main thread is the application: it takes frames with GetSPI3RxFrame(), holds
+ *  them for a random time and gives them back with ReleaseSPI3RxFrame().  The
+ *  next batch keeps being captured while the interrupt is on its way, so a
+ *  pause decided one batch late shows up as a slot written while it is held.
+ *
+ *  The injected runs hold each batch interrupt back until the next frame
+ *  starts, or until the application writes SERQ to resume the trigger: then it
+ *  is raised right in front of that SERQ, between the test in
+ *  ReleaseSPI3RxFrame() and the write, where the NVIC has to keep it pending.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spi3DMAApi.h"
+#include "spi3DMA.h"
+#include "sim.h"
+
+#define STRESS_SPI_INSTANCE  (3U)
+#define STRESS_SLOTS         (8U)
+#define STRESS_FRAME_LENGTH  (64U)
+#define STRESS_FRAMES        (100000U) /* per batch size, a multiple of every batch */
+#define STRESS_INJECT_FRAMES (20000U)  /* injected runs, each resume costs a few signals */
+#define STRESS_SPIN          (400U)    /* upper bound of the random busy loops */
+#define STRESS_HOLD_YIELDS   (20U)     /* injected: the paused producer raises a held interrupt after this */
+
+#define CH_RX      (0U)               /* LPSPI3 channels, firstChannel 0 */
+#define CH_TRIG_TX (2U)
+
+#define TRIGGER_INPUT (25U)           /* XBAR1_IN25, GPIO_AD_B0_15 ALT1 */
+
+static int failures;
+
+#define CHECK(condition)                                                   \
+	do                                                                     \
+	{                                                                      \
+		if (!(condition))                                                  \
+		{                                                                  \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #condition); \
+			failures++;                                                    \
+		}                                                                  \
+	} while (0)
+
+static const uint32_t batchSizes[] = { 1, 2, 4 };
+
+/* the eDMA only reaches the low 4 GiB, static data of a non-PIE build is there */
+static uint8_t txBuffer[STRESS_FRAME_LENGTH] __attribute__((aligned(32)));
+static uint8_t rxBuffer[STRESS_FRAME_LENGTH] __attribute__((aligned(32)));
+static uint8_t rxRing[STRESS_SLOTS * STRESS_FRAME_LENGTH] __attribute__((aligned(32)));
+
+static spi3dma_handle_t *spi3;
+static pthread_t consumerThread;
+static uint32_t producerBatch;
+static uint32_t stressFrames;
+static uint32_t injectMode;
+
+static volatile uint32_t irqRaised;     /* producer: batch interrupts raised */
+static volatile uint32_t irqTaken;      /* consumer: DMA_irq() calls returned */
+static volatile uint32_t consumerDone;  /* consumer: frames it will not read again */
+static volatile uint32_t overwrites;    /* producer: slots written while held */
+static volatile uint32_t irqHeld;       /* injected: a raised batch interrupt not sent yet */
+static uint32_t injected;               /* interrupts raised in front of a SERQ */
+static uint32_t mismatches;             /* consumer: slots that changed under it */
+
+static void Spin(uint32_t loops)
+{
+	volatile uint32_t count;
+
+	for (count = 0; count < loops; count++)
+	{
+	}
+}
+
+static void DmaIrq(int signal)
+{
+	(void)signal;
+	if (!SimIrqEnabled(CH_RX))
+	{
+		SimIrqPend(CH_RX); // masked by ReleaseSPI3RxFrame(), taken when it enables the vector again
+		return;
+	}
+	DMA_irq(spi3);
+	irqTaken = irqTaken + 1;
+}
+
+static void SendHeldIrq(void)
+{
+	if (__sync_bool_compare_and_swap(&irqHeld, 1, 0))
+		pthread_kill(consumerThread, SIGUSR1);
+}
+
+/* injected runs: the held interrupt arrives between the resume test and its SERQ */
+static uint8_t InjectBeforeSerq(uint32_t address, uint8_t write)
+{
+	if (!write || (address != (uint32_t)(uintptr_t)&DMA0->SERQ) || !__sync_bool_compare_and_swap(&irqHeld, 1, 0))
+		return 0;
+	injected++;
+	return 1;
+}
+
+static void *Producer(void *argument)
+{
+	volatile uint32_t *erq = (volatile uint32_t *)SimImage((uint32_t)(uintptr_t)&DMA0->ERQ);
+	uint32_t *slot;
+	uint32_t sequence = 0;
+	uint32_t word;
+	uint32_t idle = 0;
+	unsigned int seed = 1;
+
+	(void)argument;
+	while (sequence < stressFrames)
+	{
+		if (!(*erq & (1U << CH_TRIG_TX)))
+		{
+			if (++idle > STRESS_HOLD_YIELDS)
+				SendHeldIrq();
+			sched_yield(); // trigger held off, no frame starts
+			continue;
+		}
+		idle = 0;
+		SendHeldIrq(); // injected: the last batch interrupt arrives one frame late
+
+		if ((sequence - consumerDone) >= STRESS_SLOTS)
+			overwrites = overwrites + 1;
+		slot = (uint32_t *)&rxRing[(sequence % STRESS_SLOTS) * STRESS_FRAME_LENGTH];
+		for (word = 0; word < (STRESS_FRAME_LENGTH / 4); word++)
+		{
+			slot[word] = sequence;
+		}
+		sequence++;
+
+		if (!(sequence % producerBatch))
+		{
+			while (irqTaken != irqRaised)
+			{
+				sched_yield(); // the previous batch interrupt is still pending
+			}
+			irqRaised = irqRaised + 1;
+			__sync_synchronize();
+			if (injectMode)
+				irqHeld = 1;
+			else
+				pthread_kill(consumerThread, SIGUSR1);
+		}
+		Spin(rand_r(&seed) % STRESS_SPIN);
+	}
+	SendHeldIrq();
+	return 0;
+}
+
+static void CheckSlot(const spi3_rx_frame_t *frame)
+{
+	const uint32_t *data = (const uint32_t *)frame->data;
+	uint32_t word;
+
+	for (word = 0; word < (frame->length / 4); word++)
+	{
+		if (data[word] != frame->sequence)
+		{
+			mismatches++;
+			return;
+		}
+	}
+}
+
+static void Release(spi3_rx_frame_t *frame)
+{
+	CheckSlot(frame);
+	consumerDone = frame->sequence + 1; // done with the slot before the driver can re-arm the trigger
+	CHECK(ReleaseSPI3RxFrame(spi3, frame) == 0);
+}
+
+static void StressBatch(uint32_t batch, uint32_t inject)
+{
+	spi3_rx_frame_t held[STRESS_SLOTS];
+	pthread_t producer;
+	uint32_t pauses = GetSPI3RxPauseCount(spi3);
+	uint32_t read = 0;
+	uint32_t released = 0;
+	unsigned int seed = 2;
+
+	CHECK(SetSPI3RxRing(spi3, rxRing, STRESS_SLOTS) == 0);
+	CHECK(SetSPI3RxBatch(spi3, batch) == 0);
+	memset(rxRing, 0xFF, sizeof(rxRing));
+	producerBatch = batch;
+	injectMode = inject;
+	stressFrames = inject ? STRESS_INJECT_FRAMES : STRESS_FRAMES;
+	irqHeld = 0;
+	injected = 0;
+	irqRaised = 0;
+	irqTaken = 0;
+	consumerDone = 0;
+	overwrites = 0;
+	mismatches = 0;
+	__sync_synchronize();
+
+	if (pthread_create(&producer, 0, Producer, 0))
+	{
+		printf("producer thread can not be started\n");
+		failures++;
+		return;
+	}
+
+	while (released < stressFrames)
+	{
+		if (((read - released) < STRESS_SLOTS) && (GetSPI3RxFrame(spi3, &held[read % STRESS_SLOTS]) == 0))
+		{
+			CHECK(held[read % STRESS_SLOTS].sequence == read);
+			CheckSlot(&held[read % STRESS_SLOTS]);
+			read++;
+			if (rand_r(&seed) % 4)
+				continue; // keep it for now
+		}
+		else
+		{
+			sched_yield();
+			if (rand_r(&seed) % 2)
+				continue; // nothing new, keep holding what it has
+			while (released < read)
+			{
+				Release(&held[released % STRESS_SLOTS]);
+				released++;
+			}
+			continue;
+		}
+
+		Spin(rand_r(&seed) % STRESS_SPIN);
+		Release(&held[released % STRESS_SLOTS]);
+		released++;
+	}
+	pthread_join(producer, 0);
+
+	pauses = GetSPI3RxPauseCount(spi3) - pauses;
+	printf("%5u %4u %7u %7u %8u %10u %10u\n", batch, STRESS_SLOTS, stressFrames, pauses, injected, overwrites,
+			mismatches);
+	CHECK(irqTaken == (stressFrames / batch));
+	CHECK(pauses > 0);
+	CHECK(!inject || (injected > 0));
+	CHECK(overwrites == 0);
+	CHECK(mismatches == 0);
+}
+
+int main(void)
+{
+	struct sigaction action;
+	spi3_frame_t frame;
+	uint32_t idx;
+
+	if (SimInit())
+	{
+		printf("register blocks can not be mapped, build non-PIE on a 64 bit host\n");
+		return 1;
+	}
+
+	spi3 = GetSPI3Handle(STRESS_SPI_INSTANCE);
+	InitClocks();
+	InitSPI3Peripheral(spi3);
+	frame.length = STRESS_FRAME_LENGTH;
+	frame.txBuffer = txBuffer;
+	frame.rxBuffer = rxBuffer;
+	SetSPI3Frame(spi3, &frame);
+	InitDMAandEDMA(spi3);
+	InitGPIOTrigger(spi3, TRIGGER_INPUT);
+	RestSPI3Peripheral(spi3, frame.txBuffer, frame.rxBuffer);
+
+	consumerThread = pthread_self();
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = DmaIrq;
+	sigaction(SIGUSR1, &action, 0);
+	NVIC_ISER0_REG = SPI3_DMA_IRQ_MASK(CH_RX); // as the example enables DMA0_DMA16_IRQn
+
+	printf("batch slots  frames  pauses injected overwrites mismatches\n");
+	for (idx = 0; idx < (sizeof(batchSizes) / sizeof(batchSizes[0])); idx++)
+	{
+		StressBatch(batchSizes[idx], 0);
+	}
+	SimSetAccessHook(InjectBeforeSerq);
+	for (idx = 0; idx < (sizeof(batchSizes) / sizeof(batchSizes[0])); idx++)
+	{
+		StressBatch(batchSizes[idx], 1);
+	}
+	SimSetAccessHook(0);
+
+	printf("spsc_stress: %s\n", failures ? "FAIL" : "pass");
+	return failures ? 1 : 0;
+}
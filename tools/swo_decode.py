@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Split the SWO stream of a kSerialPort_Swo debug console into its ITM ports.
+
+The console sets the TPIU up with the formatter off, so the pin carries plain
+ITM packets.  The PRINTF port is written as text, DBG_LOG() records on their
+own port are decoded with the ELF the way dbglog_decode.py does for the UART.
+
+    swo_decode.py capture.swo
+    swo_decode.py capture.swo --elf Debug/SPI3_DMA_Example.axf
+    swo_decode.py tcp:localhost:2332 --elf Debug/SPI3_DMA_Example.axf
+    swo_decode.py capture.swo --port 1 --raw > records.bin
+
+The input is a raw SWO capture, '-' (stdin) or the SWO server of a probe
+(tcp:host:port).  Synchronization, overflow, timestamp, extension and hardware
+source (DWT) packets are skipped.
+"""
+
+import argparse
+import socket
+import sys
+
+import dbglog_decode
+
+SYNC_END = 0x80
+OVERFLOW = 0x70
+PAYLOAD_SIZE = (0, 1, 2, 4)
+
+
+class ItmParser:
+    """Turns SWO bytes into (port, payload) of instrumentation packets."""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.overflows = 0
+
+    def feed(self, data):
+        buf = self.pending
+        buf += data
+        packets = []
+        pos = 0
+        while pos < len(buf):
+            header = buf[pos]
+            if header == 0:
+                # synchronization, at least 47 zero bits then a one
+                end = pos
+                while end < len(buf) and buf[end] == 0:
+                    end += 1
+                if end == len(buf):
+                    break
+                pos = end + 1 if buf[end] == SYNC_END else end
+                continue
+            if header == OVERFLOW:
+                self.overflows += 1
+                pos += 1
+                continue
+            size = PAYLOAD_SIZE[header & 0x03]
+            if size:
+                if pos + 1 + size > len(buf):
+                    break
+                if not header & 0x04:
+                    packets.append((header >> 3, bytes(buf[pos + 1:pos + 1 + size])))
+                pos += 1 + size
+                continue
+            # protocol packet, bit 7 of every byte says another one follows
+            end = pos
+            while buf[end] & 0x80:
+                end += 1
+                if end == len(buf):
+                    break
+            else:
+                pos = end + 1
+                continue
+            break
+        del buf[:pos]
+        return packets
+
+
+def open_input(name):
+    if name == '-':
+        return sys.stdin.buffer
+    if name.startswith('tcp:'):
+        _, host, port = name.split(':')
+        return socket.create_connection((host, int(port))).makefile('rb', buffering=0)
+    return open(name, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input', help="SWO capture file, '-' for stdin or tcp:host:port")
+    parser.add_argument('--port', type=int, default=0, help='stimulus port of the PRINTF text')
+    parser.add_argument('--log-port', type=int, default=1, help='stimulus port of the DBG_LOG records')
+    parser.add_argument('--elf', help='the .axf the target runs, decodes the DBG_LOG records')
+    parser.add_argument('--raw', action='store_true', help='write the bytes of --port as they are')
+    parser.add_argument('--clock', type=float, default=600e6, help='core clock the DWT timestamps count, Hz')
+    options = parser.parse_args()
+
+    stream = open_input(options.input)
+    elf = dbglog_decode.ElfImage(options.elf) if options.elf and not options.raw else None
+    itm = ItmParser()
+    records = bytearray()
+    out = sys.stdout.buffer if options.raw else sys.stdout
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        for port, payload in itm.feed(chunk):
+            if port == options.port:
+                if options.raw:
+                    out.write(payload)
+                else:
+                    out.write(''.join(chr(b) if b < 0x80 else '\\x%02x' % b for b in payload))
+            elif port == options.log_port and elf is not None:
+                records += payload
+                del records[:dbglog_decode.decode_records(records, elf, options.clock, out)]
+        out.flush()
+    if itm.overflows:
+        sys.stderr.write('%d ITM overflow packets, output was lost\n' % itm.overflows)
+
+
+if __name__ == '__main__':
+    main()
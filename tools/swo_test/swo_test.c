@@ -0,0 +1,194 @@
+/*
+ * swo_test.c
+ *
+ *  Host test of the kSerialPort_Swo debug console.  utilities/fsl_debug_console.c
+ *  is built unchanged against tools/host_stubs, where the ITM, TPI and CoreDebug
+ *  registers are plain memory and every stimulus port store becomes the ITM
+ *  packet the SWO pin would carry.  The test checks the register setup and the
+ *  packets, then writes the stream to swo_capture.bin and what the decoder has
+ *  to get out of it to swo_port0.txt and swo_port1.bin (make run compares).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fsl_debug_console.h"
+#include "fsl_adapter_uart.h"
+
+#define TEST_TRACE_CLOCK (132000000U)
+#define TEST_SWO_RATE    (6000000U)
+#define TEST_LOG_PORT    (1U)
+
+static int failures;
+
+#define CHECK(condition)                                                   \
+	do                                                                     \
+	{                                                                      \
+		if (!(condition))                                                  \
+		{                                                                  \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #condition); \
+			failures++;                                                    \
+		}                                                                  \
+	} while (0)
+
+/* The UART is not used, the adapter only has to link. */
+hal_uart_status_t HAL_UartInit(hal_uart_handle_t handle, const hal_uart_config_t *config)
+{
+	(void)handle;
+	(void)config;
+	return kStatus_HAL_UartSuccess;
+}
+
+hal_uart_status_t HAL_UartDeinit(hal_uart_handle_t handle)
+{
+	(void)handle;
+	return kStatus_HAL_UartSuccess;
+}
+
+hal_uart_status_t HAL_UartSendBlocking(hal_uart_handle_t handle, const uint8_t *data, size_t length)
+{
+	(void)handle;
+	(void)data;
+	(void)length;
+	failures++;
+	return kStatus_HAL_UartSuccess;
+}
+
+hal_uart_status_t HAL_UartReceiveBlocking(hal_uart_handle_t handle, uint8_t *data, size_t length)
+{
+	(void)handle;
+	(void)data;
+	(void)length;
+	return kStatus_HAL_UartError;
+}
+
+/*
+ * The packets DbgConsole sends for a block on one port: a 32 bit store while
+ * four bytes are left, then byte stores.
+ */
+static size_t ExpectedPackets(uint8_t *packets, uint32_t port, const uint8_t *data, size_t length)
+{
+	size_t used = 0;
+
+	while (length > 0)
+	{
+		size_t size = (length >= 4) ? 4 : 1;
+
+		packets[used++] = (uint8_t)((port << 3) | ((size == 4) ? 3U : 1U));
+		memcpy(&packets[used], data, size);
+		used += size;
+		data += size;
+		length -= size;
+	}
+	return used;
+}
+
+/* The capture grew by exactly these packets. */
+static void CheckSent(size_t before, uint32_t port, const uint8_t *data, size_t length)
+{
+	uint8_t expected[256];
+	const uint8_t *capture;
+	size_t captured = StubItmCapture(&capture);
+	size_t packets  = ExpectedPackets(expected, port, data, length);
+
+	CHECK((captured - before) == packets);
+	if ((captured - before) == packets)
+	{
+		CHECK(memcmp(&capture[before], expected, packets) == 0);
+	}
+}
+
+static int WriteFile(const char *name, const void *data, size_t length)
+{
+	FILE *file = fopen(name, "wb");
+
+	if (file == NULL)
+	{
+		perror(name);
+		return -1;
+	}
+	fwrite(data, 1, length, file);
+	fclose(file);
+	return 0;
+}
+
+int main(void)
+{
+	static const uint8_t sync[]      = {0x00, 0x00, 0x00, 0x00, 0x00, 0x80};
+	static const uint8_t timestamp[] = {0xC0, 0x85, 0x02};
+	static const uint8_t hardware[]  = {0x0E, 0x34, 0x12}; /* DWT packet, 2 byte payload */
+	static const uint8_t overflow[]  = {0x70};
+	static const uint8_t record[]    = {0xF1, 0x10, 0x20, 0x30, 0x40, 0x01, 0x02, 0x03, 0x04, 0x2A, 0x00, 0x00, 0x00};
+	static const char text[]         = "frame 7 ok\r\n";
+	char port0[64];
+	size_t port0Length = 0;
+	const uint8_t *capture;
+	size_t before;
+
+	StubItmReset();
+
+	/* Bad arguments leave the console off. */
+	CHECK(DbgConsole_Init(32U, TEST_SWO_RATE, kSerialPort_Swo, TEST_TRACE_CLOCK) == kStatus_Fail);
+	CHECK(DbgConsole_Init(0U, TEST_TRACE_CLOCK * 2U, kSerialPort_Swo, TEST_TRACE_CLOCK) == kStatus_Fail);
+	CHECK(DbgConsole_Printf("lost") == -1);
+
+	/* Register setup. */
+	CHECK(DbgConsole_Init(0U, TEST_SWO_RATE, kSerialPort_Swo, TEST_TRACE_CLOCK) == kStatus_Success);
+	CHECK(StubTpi.ACPR == 21U);
+	CHECK(StubTpi.SPPR == 2U);
+	CHECK(StubTpi.FFCR == TPI_FFCR_TrigIn_Msk);
+	CHECK((StubCoreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0U);
+	CHECK(StubItm.LAR == 0xC5ACCE55U);
+	CHECK(StubItm.TCR == (ITM_TCR_ITMENA_Msk | ITM_TCR_SYNCENA_Msk | (1UL << ITM_TCR_TraceBusID_Pos)));
+	CHECK(StubItm.TER == 0xFFFFFFFFU);
+	CHECK(StubItmCapture(&capture) == 0);
+
+	StubItmInject(sync, sizeof(sync));
+
+	/* PRINTF text, 32 bit stores on the console port. */
+	before = StubItmCapture(&capture);
+	CHECK(DbgConsole_Printf("frame %d ok\r\n", 7) == (int)strlen(text));
+	CheckSent(before, 0U, (const uint8_t *)text, strlen(text));
+	memcpy(&port0[port0Length], text, strlen(text));
+	port0Length += strlen(text);
+
+	StubItmInject(timestamp, sizeof(timestamp));
+
+	/* A 13 byte record on its own port, three words and a byte. */
+	before = StubItmCapture(&capture);
+	CHECK(DbgConsole_WritePort(TEST_LOG_PORT, record, sizeof(record)) == (int)sizeof(record));
+	CheckSent(before, TEST_LOG_PORT, record, sizeof(record));
+
+	StubItmInject(hardware, sizeof(hardware));
+	StubItmInject(overflow, sizeof(overflow));
+
+	/* PUTCHAR, one byte store. */
+	before = StubItmCapture(&capture);
+	CHECK(DbgConsole_Putchar('x') == 1);
+	CheckSent(before, 0U, (const uint8_t *)"x", 1);
+	port0[port0Length++] = 'x';
+
+	/* A port the debugger disabled gets nothing, and never blocks. */
+	StubItm.TER &= ~(1UL << TEST_LOG_PORT);
+	before = StubItmCapture(&capture);
+	CHECK(DbgConsole_WritePort(TEST_LOG_PORT, record, sizeof(record)) == (int)sizeof(record));
+	CHECK(StubItmCapture(&capture) == before);
+	StubItm.TER = 0xFFFFFFFFU;
+
+	/* No receive direction on SWO. */
+	CHECK(DbgConsole_Getchar() == -1);
+	CHECK(DbgConsole_Flush() == kStatus_Success);
+
+	if ((WriteFile("swo_capture.bin", capture, StubItmCapture(&capture)) != 0) ||
+		(WriteFile("swo_port0.txt", port0, port0Length) != 0) ||
+		(WriteFile("swo_port1.bin", record, sizeof(record)) != 0))
+	{
+		failures++;
+	}
+
+	CHECK(DbgConsole_Deinit() == kStatus_Success);
+	CHECK(DbgConsole_Printf("lost") == -1);
+
+	printf("swo_test: %s\n", (failures == 0) ? "pass" : "FAIL");
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -28,6 +28,34 @@
 /*! @brief This definition is maximum line that debugconsole can scanf each time.*/
 #define IO_MAXLINE 20U
 
+/*! @brief This definition is the stack buffer printf formats into, longer output is sent in several pieces.*/
+#define PRINTF_LINE_SIZE 128U
+
+/*! @brief ITM lock access key, unlocks the ITM registers for writes.*/
+#define DEBUG_CONSOLE_ITM_UNLOCK 0xC5ACCE55U
+
+/*! @brief Stores to an ITM stimulus port, a host build can replace them to capture the ITM output.*/
+#ifndef DEBUG_CONSOLE_ITM_STORE32
+#define DEBUG_CONSOLE_ITM_STORE32(port, value) (ITM->PORT[(port)].u32 = (uint32_t)(value))
+#define DEBUG_CONSOLE_ITM_STORE8(port, value)  (ITM->PORT[(port)].u8 = (uint8_t)(value))
+#endif /* DEBUG_CONSOLE_ITM_STORE32 */
+
+/*! @brief Fraction digits %f computes, a larger precision is padded with zeros.*/
+#define PRINTF_FLOAT_MAX_PRECISION 9U
+
+/*! @brief Integer digits of the largest double, 1.8e308.*/
+#define PRINTF_FLOAT_MAX_INT_DIGITS 309U
+
+/*! @brief 32 bit words of the largest double as an integer, 53 bit mantissa shifted by up to 971.*/
+#define PRINTF_FLOAT_BIG_WORDS 33U
+
+/*! @brief Converted number buffer: leading NUL, integer digits, '.' and fraction digits.*/
+#if PRINTF_FLOAT_ENABLE
+#define PRINTF_NUMBER_BUFFER_SIZE (PRINTF_FLOAT_MAX_INT_DIGITS + PRINTF_FLOAT_MAX_PRECISION + 2U)
+#else
+#define PRINTF_NUMBER_BUFFER_SIZE 33U
+#endif /* PRINTF_FLOAT_ENABLE */
+
 /*! @brief The overflow value.*/
 #ifndef HUGE_VAL
 #define HUGE_VAL (99.e99)
@@ -44,10 +72,16 @@ typedef struct DebugConsoleState
                                  uint8_t *data,
                                  size_t length); /*!< get char function pointer */
     serial_port_type_t type;                     /*!< The initialized port of the debug console. */
+    uint8_t itmPort;                             /*!< Stimulus port of the console with kSerialPort_Swo. */
+    LPUART_Type *base;                           /*!< LPUART of the console with kSerialPort_Uart. */
 } debug_console_state_t;
 
-/*! @brief Type of KSDK printf function pointer. */
-typedef int (*PUTCHAR_FUNC)(int a);
+/*! @brief Output of one printf call, collected on the stack and sent with one putChar call. */
+typedef struct DebugConsoleLine
+{
+    uint32_t length;                 /*!< Characters in the buffer. */
+    char buffer[PRINTF_LINE_SIZE];   /*!< Formatted characters not sent yet. */
+} debug_console_line_t;
 
 #if PRINTF_ADVANCED_ENABLE
 /*! @brief Specification modifier flags for printf. */
@@ -88,17 +122,58 @@ enum _debugconsole_scanf_flag
     kSCANF_TypeSinged = 0x2000U,           /*!< TypeSinged Flag. */
 };
 
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+#if (defined(UART_ADAPTER_NON_BLOCKING_MODE) && (UART_ADAPTER_NON_BLOCKING_MODE > 0U))
+#error "DEBUG_CONSOLE_TX_ASYNC owns the LPUART interrupt, disable the UART adapter non-blocking mode."
+#endif
+#if ((DEBUG_CONSOLE_TX_RING_SIZE & (DEBUG_CONSOLE_TX_RING_SIZE - 1U)) != 0U)
+#error "DEBUG_CONSOLE_TX_RING_SIZE must be a power of 2."
+#endif
+#if ((DEBUG_CONSOLE_RX_RING_SIZE & (DEBUG_CONSOLE_RX_RING_SIZE - 1U)) != 0U)
+#error "DEBUG_CONSOLE_RX_RING_SIZE must be a power of 2."
+#endif
+
+/*! @brief Asynchronous transmit ring, single producer (printing thread), single consumer (LPUART interrupt). */
+typedef struct DebugConsoleTxRing
+{
+    uint8_t buffer[DEBUG_CONSOLE_TX_RING_SIZE];
+    volatile uint32_t head;      /*!< Free running write index, only written by the producer. */
+    volatile uint32_t tail;      /*!< Free running read index, only written by the interrupt. */
+    volatile uint32_t dropCount; /*!< Characters lost because the ring was full. */
+} debug_console_tx_ring_t;
+
+/*! @brief Receive ring, single producer (LPUART interrupt), single consumer (DbgConsole_TryGetchar()). */
+typedef struct DebugConsoleRxRing
+{
+    uint8_t buffer[DEBUG_CONSOLE_RX_RING_SIZE];
+    volatile uint32_t head; /*!< Free running write index, only written by the interrupt. */
+    volatile uint32_t tail; /*!< Free running read index, only written by the reader. */
+} debug_console_rx_ring_t;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 /*! @brief Debug UART state information. */
 static debug_console_state_t s_debugConsole;
 
+/*! @brief LPUART base addresses, indexed by the console instance. */
+static LPUART_Type *const s_debugConsoleLpuartBase[] = LPUART_BASE_PTRS;
+
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+/*! @brief Debug UART transmit and receive rings. */
+static debug_console_tx_ring_t s_debugConsoleTxRing;
+static debug_console_rx_ring_t s_debugConsoleRxRing;
+/*! @brief LPUART interrupts, indexed by the console instance. */
+static const IRQn_Type s_debugConsoleLpuartIrq[] = LPUART_RX_TX_IRQS;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 #if SDK_DEBUGCONSOLE
-static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt, va_list ap);
+static int DbgConsole_PrintfFormattedData(debug_console_line_t *line, const char *fmt, va_list ap);
+static void DbgConsole_LineFlush(debug_console_line_t *line);
 static int DbgConsole_ScanfFormattedData(const char *line_ptr, char *format, va_list args_ptr);
 #endif /* SDK_DEBUGCONSOLE */
 
@@ -108,12 +183,120 @@ static int DbgConsole_ScanfFormattedData(const char *line_ptr, char *format, va_
 
 /*************Code for DbgConsole Init, Deinit, Printf, Scanf *******************************/
 
+#if (SDK_DEBUGCONSOLE || defined(SDK_DEBUGCONSOLE_UART))
+/*!
+ * @brief Sends a block on one ITM stimulus port, 32 bit writes while four bytes are left.
+ *
+ * @note Nothing is sent while the ITM or the port is disabled (no debugger or trace clock), the
+ * port never reports ready then.
+ *
+ * @param[in] port    Stimulus port.
+ * @param[in] data    Bytes to send.
+ * @param[in] length  Number of bytes.
+ */
+static void DbgConsole_ItmWrite(uint32_t port, const uint8_t *data, size_t length)
+{
+    uint32_t word;
+
+    if ((0UL == (ITM->TCR & ITM_TCR_ITMENA_Msk)) || (0UL == (ITM->TER & (1UL << port))))
+    {
+        return;
+    }
+    while (length >= 4U)
+    {
+        (void)memcpy(&word, data, 4U);
+        /* A port reads 0 while its FIFO is full. */
+        while (0UL == ITM->PORT[port].u32)
+        {
+        }
+        DEBUG_CONSOLE_ITM_STORE32(port, word);
+        data += 4U;
+        length -= 4U;
+    }
+    while (length > 0U)
+    {
+        while (0UL == ITM->PORT[port].u32)
+        {
+        }
+        DEBUG_CONSOLE_ITM_STORE8(port, *data);
+        data++;
+        length--;
+    }
+}
+#endif /* SDK_DEBUGCONSOLE || SDK_DEBUGCONSOLE_UART */
+
 #if ((SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_SDK) || defined(SDK_DEBUGCONSOLE_UART))
+/* putChar of kSerialPort_Swo, sends on the console stimulus port. */
+static hal_uart_status_t DbgConsole_ItmSend(hal_uart_handle_t handle, const uint8_t *data, size_t length)
+{
+    (void)handle;
+    DbgConsole_ItmWrite(s_debugConsole.itmPort, data, length);
+
+    return kStatus_HAL_UartSuccess;
+}
+
+/* getChar of kSerialPort_Swo, SWO has no receive direction. */
+static hal_uart_status_t DbgConsole_ItmReceive(hal_uart_handle_t handle, uint8_t *data, size_t length)
+{
+    (void)handle;
+    (void)data;
+    (void)length;
+
+    return kStatus_HAL_UartError;
+}
+
+/*!
+ * @brief Sets up the ITM and the TPIU for SWO output in NRZ encoding with the formatter off, so the
+ * pin carries plain ITM packets.
+ *
+ * @param[in] port        Stimulus port of the console.
+ * @param[in] baudRate    SWO bit rate.
+ * @param[in] clkSrcFreq  Trace clock the TPIU divides down.
+ *
+ * @return kStatus_Success, or kStatus_Fail for a port or bit rate out of range.
+ */
+static status_t DbgConsole_ItmInit(uint8_t port, uint32_t baudRate, uint32_t clkSrcFreq)
+{
+    uint32_t prescaler;
+
+    if ((port > 31U) || (0U == baudRate) || (clkSrcFreq < baudRate))
+    {
+        return kStatus_Fail;
+    }
+    /* Nearest divider, the host decoder has to run at clkSrcFreq / (prescaler + 1). */
+    prescaler = ((clkSrcFreq + (baudRate / 2U)) / baudRate) - 1U;
+    if (prescaler > TPI_ACPR_PRESCALER_Msk)
+    {
+        return kStatus_Fail;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    TPI->SPPR = 2U;
+    TPI->ACPR = prescaler;
+    TPI->FFCR = TPI_FFCR_TrigIn_Msk;
+    ITM->LAR  = DEBUG_CONSOLE_ITM_UNLOCK;
+    ITM->TCR  = ITM_TCR_ITMENA_Msk | ITM_TCR_SYNCENA_Msk | (1UL << ITM_TCR_TraceBusID_Pos);
+    ITM->TPR  = 0U;
+    /* Every port, the host picks the ones it shows. */
+    ITM->TER = 0xFFFFFFFFU;
+
+    s_debugConsole.type    = kSerialPort_Swo;
+    s_debugConsole.itmPort = port;
+    s_debugConsole.putChar = DbgConsole_ItmSend;
+    s_debugConsole.getChar = DbgConsole_ItmReceive;
+
+    return kStatus_Success;
+}
+
 /* See fsl_debug_console.h for documentation of this function. */
 status_t DbgConsole_Init(uint8_t instance, uint32_t baudRate, serial_port_type_t device, uint32_t clkSrcFreq)
 {
     hal_uart_config_t usrtConfig;
 
+    if (kSerialPort_Swo == device)
+    {
+        return DbgConsole_ItmInit(instance, baudRate, clkSrcFreq);
+    }
     if (kSerialPort_Uart != device)
     {
         return kStatus_Fail;
@@ -140,6 +323,19 @@ status_t DbgConsole_Init(uint8_t instance, uint32_t baudRate, serial_port_type_t
     /* Set the function pointer for send and receive for this kind of device. */
     s_debugConsole.putChar = HAL_UartSendBlocking;
     s_debugConsole.getChar = HAL_UartReceiveBlocking;
+    s_debugConsole.base    = s_debugConsoleLpuartBase[instance];
+
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    s_debugConsoleTxRing.head      = 0U;
+    s_debugConsoleTxRing.tail      = 0U;
+    s_debugConsoleTxRing.dropCount = 0U;
+    s_debugConsoleRxRing.head      = 0U;
+    s_debugConsoleRxRing.tail      = 0U;
+    s_debugConsole.base->CTRL |= LPUART_CTRL_RIE_MASK | LPUART_CTRL_ORIE_MASK;
+    /* Lowest urgency, the console must never delay a data path interrupt. */
+    NVIC_SetPriority(s_debugConsoleLpuartIrq[instance], (1UL << __NVIC_PRIO_BITS) - 1UL);
+    (void)EnableIRQ(s_debugConsoleLpuartIrq[instance]);
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
 
     return kStatus_Success;
 }
@@ -152,6 +348,17 @@ status_t DbgConsole_Deinit(void)
         return kStatus_Success;
     }
 
+    if (kSerialPort_Swo == s_debugConsole.type)
+    {
+        /* The ITM and TPIU stay on, the debugger may be using them. */
+        (void)DbgConsole_Flush();
+        s_debugConsole.type = kSerialPort_None;
+        return kStatus_Success;
+    }
+
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    (void)DbgConsole_Flush();
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
     (void)HAL_UartDeinit((hal_uart_handle_t)&s_debugConsole.uartHandleBuffer[0]);
 
     s_debugConsole.type = kSerialPort_None;
@@ -161,9 +368,108 @@ status_t DbgConsole_Deinit(void)
 #endif /* DEBUGCONSOLE_REDIRECT_TO_SDK */
 
 #if SDK_DEBUGCONSOLE
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+/*!
+ * @brief Queues one character, drops and counts it when the ring is full.
+ *
+ * @param ch Character to queue.
+ * @return 1 when queued, -1 when dropped.
+ */
+static int DbgConsole_TxRingPut(int ch)
+{
+    uint32_t head = s_debugConsoleTxRing.head;
+
+    if ((head - s_debugConsoleTxRing.tail) >= DEBUG_CONSOLE_TX_RING_SIZE)
+    {
+        s_debugConsoleTxRing.dropCount++;
+        return -1;
+    }
+    s_debugConsoleTxRing.buffer[head & (DEBUG_CONSOLE_TX_RING_SIZE - 1U)] = (uint8_t)ch;
+    /* The character is in the ring before the interrupt can see the new head. */
+    __DMB();
+    s_debugConsoleTxRing.head = head + 1U;
+
+    return 1;
+}
+
+/*!
+ * @brief Lets the transmit interrupt drain the ring.
+ *
+ * Only the interrupt clears TIE, and only once the ring is empty, so a read-modify-write that
+ * races with it at worst costs one spurious interrupt.
+ */
+static void DbgConsole_TxRingKick(void)
+{
+    s_debugConsole.base->CTRL |= LPUART_CTRL_TIE_MASK;
+}
+
+/*!
+ * @brief Moves queued characters into the LPUART while it has room, stops the interrupt when empty.
+ */
+static void DbgConsole_TxRingDrain(void)
+{
+    LPUART_Type *base = s_debugConsole.base;
+    uint32_t tail     = s_debugConsoleTxRing.tail;
+
+    while ((tail != s_debugConsoleTxRing.head) && (0U != (base->STAT & LPUART_STAT_TDRE_MASK)))
+    {
+        base->DATA = s_debugConsoleTxRing.buffer[tail & (DEBUG_CONSOLE_TX_RING_SIZE - 1U)];
+        tail++;
+    }
+    s_debugConsoleTxRing.tail = tail;
+
+    if (tail == s_debugConsoleTxRing.head)
+    {
+        base->CTRL &= ~LPUART_CTRL_TIE_MASK;
+    }
+}
+
+/*!
+ * @brief Moves received characters into the receive ring, characters that do not fit are lost.
+ */
+static void DbgConsole_RxRingFill(void)
+{
+    LPUART_Type *base = s_debugConsole.base;
+    uint32_t head     = s_debugConsoleRxRing.head;
+
+    /* Reception stops while OR is set. */
+    if (0U != (base->STAT & LPUART_STAT_OR_MASK))
+    {
+        base->STAT = LPUART_STAT_OR_MASK;
+    }
+    while (0U != (base->STAT & LPUART_STAT_RDRF_MASK))
+    {
+        if ((head - s_debugConsoleRxRing.tail) < DEBUG_CONSOLE_RX_RING_SIZE)
+        {
+            s_debugConsoleRxRing.buffer[head & (DEBUG_CONSOLE_RX_RING_SIZE - 1U)] = (uint8_t)base->DATA;
+            head++;
+        }
+        else
+        {
+            (void)base->DATA;
+        }
+    }
+    /* The characters are in the ring before the reader can see the new head. */
+    __DMB();
+    s_debugConsoleRxRing.head = head;
+}
+
+/*!
+ * @brief LPUART interrupt of the console instance, fills the receive ring and drains the transmit ring.
+ */
+void DEBUG_CONSOLE_TX_IRQ_HANDLER(void);
+void DEBUG_CONSOLE_TX_IRQ_HANDLER(void)
+{
+    DbgConsole_RxRingFill();
+    DbgConsole_TxRingDrain();
+    SDK_ISR_EXIT_BARRIER;
+}
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
 /* See fsl_debug_console.h for documentation of this function. */
 int DbgConsole_Printf(const char *fmt_s, ...)
 {
+    debug_console_line_t line;
     va_list ap;
     int result;
 
@@ -173,7 +479,10 @@ int DbgConsole_Printf(const char *fmt_s, ...)
         return -1;
     }
     va_start(ap, fmt_s);
-    result = DbgConsole_PrintfFormattedData(DbgConsole_Putchar, fmt_s, ap);
+    /* Format into the stack buffer, then send the line with one putChar call or one ring write. */
+    line.length = 0U;
+    result      = DbgConsole_PrintfFormattedData(&line, fmt_s, ap);
+    DbgConsole_LineFlush(&line);
     va_end(ap);
 
     return result;
@@ -187,11 +496,115 @@ int DbgConsole_Putchar(int ch)
     {
         return -1;
     }
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    /* The ring feeds the LPUART, ITM writes are fast enough to go out directly. */
+    if (kSerialPort_Uart == s_debugConsole.type)
+    {
+        if (DbgConsole_TxRingPut(ch) < 0)
+        {
+            return -1;
+        }
+        DbgConsole_TxRingKick();
+        return 1;
+    }
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
     (void)s_debugConsole.putChar((hal_uart_handle_t)&s_debugConsole.uartHandleBuffer[0], (uint8_t *)(&ch), 1);
 
     return 1;
 }
 
+/* See fsl_debug_console.h for documentation of this function. */
+int DbgConsole_Write(const uint8_t *data, size_t length)
+{
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    uint32_t head;
+    size_t i;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
+    /* Do nothing if the debug UART is not initialized. */
+    if (kSerialPort_None == s_debugConsole.type)
+    {
+        return -1;
+    }
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    if (kSerialPort_Uart == s_debugConsole.type)
+    {
+        head = s_debugConsoleTxRing.head;
+        if ((DEBUG_CONSOLE_TX_RING_SIZE - (head - s_debugConsoleTxRing.tail)) < length)
+        {
+            s_debugConsoleTxRing.dropCount += length;
+            return -1;
+        }
+        for (i = 0U; i < length; i++)
+        {
+            s_debugConsoleTxRing.buffer[(head + i) & (DEBUG_CONSOLE_TX_RING_SIZE - 1U)] = data[i];
+        }
+        /* The block is in the ring before the interrupt can see the new head. */
+        __DMB();
+        s_debugConsoleTxRing.head = head + length;
+        DbgConsole_TxRingKick();
+        return (int)length;
+    }
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+    (void)s_debugConsole.putChar((hal_uart_handle_t)&s_debugConsole.uartHandleBuffer[0], data, length);
+
+    return (int)length;
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+int DbgConsole_WritePort(uint8_t port, const uint8_t *data, size_t length)
+{
+    if ((kSerialPort_Swo != s_debugConsole.type) || (port > 31U))
+    {
+        return DbgConsole_Write(data, length);
+    }
+    DbgConsole_ItmWrite(port, data, length);
+
+    return (int)length;
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+status_t DbgConsole_Flush(void)
+{
+    /* Do nothing if the debug UART is not initialized. */
+    if (kSerialPort_None == s_debugConsole.type)
+    {
+        return kStatus_Fail;
+    }
+    if (kSerialPort_Swo == s_debugConsole.type)
+    {
+        while (0UL != (ITM->TCR & ITM_TCR_BUSY_Msk))
+        {
+        }
+        return kStatus_Success;
+    }
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    while (s_debugConsoleTxRing.tail != s_debugConsoleTxRing.head)
+    {
+        /* With interrupts masked the interrupt can not drain, do it here, it can not race. */
+        if (0U != __get_PRIMASK())
+        {
+            DbgConsole_TxRingDrain();
+        }
+    }
+    while (0U == (s_debugConsole.base->STAT & LPUART_STAT_TC_MASK))
+    {
+    }
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
+    return kStatus_Success;
+}
+
+/* See fsl_debug_console.h for documentation of this function. */
+uint32_t DbgConsole_GetDropCount(void)
+{
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    return s_debugConsoleTxRing.dropCount;
+#else
+    return 0U;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+}
+
 /* See fsl_debug_console.h for documentation of this function. */
 int DbgConsole_Scanf(char *fmt_ptr, ...)
 {
@@ -251,15 +664,68 @@ int DbgConsole_Scanf(char *fmt_ptr, ...)
     return (int)result;
 }
 
+/* See fsl_debug_console.h for documentation of this function. */
+int DbgConsole_TryGetchar(void)
+{
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    uint32_t tail;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+    int ch;
+
+    /* Only the UART has a receive direction. */
+    if (kSerialPort_Uart != s_debugConsole.type)
+    {
+        return -1;
+    }
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    tail = s_debugConsoleRxRing.tail;
+    if (tail == s_debugConsoleRxRing.head)
+    {
+        return -1;
+    }
+    ch = (int)s_debugConsoleRxRing.buffer[tail & (DEBUG_CONSOLE_RX_RING_SIZE - 1U)];
+    /* The character is read before the interrupt may reuse its place. */
+    __DMB();
+    s_debugConsoleRxRing.tail = tail + 1U;
+#else
+    if (0U != (s_debugConsole.base->STAT & LPUART_STAT_OR_MASK))
+    {
+        s_debugConsole.base->STAT = LPUART_STAT_OR_MASK;
+    }
+    if (0U == (s_debugConsole.base->STAT & LPUART_STAT_RDRF_MASK))
+    {
+        return -1;
+    }
+    ch = (int)(uint8_t)s_debugConsole.base->DATA;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
+    return ch;
+}
+
 /* See fsl_debug_console.h for documentation of this function. */
 int DbgConsole_Getchar(void)
 {
     char ch;
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    int next;
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
     /* Do nothing if the debug UART is not initialized. */
     if (kSerialPort_None == s_debugConsole.type)
     {
         return -1;
     }
+#if (defined(DEBUG_CONSOLE_TX_ASYNC) && (DEBUG_CONSOLE_TX_ASYNC > 0U))
+    /* The interrupt owns the receiver, wait on the ring. */
+    if (kSerialPort_Uart == s_debugConsole.type)
+    {
+        do
+        {
+            next = DbgConsole_TryGetchar();
+        } while (next < 0);
+        return next;
+    }
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
     while (kStatus_HAL_UartSuccess !=
            s_debugConsole.getChar((hal_uart_handle_t)&s_debugConsole.uartHandleBuffer[0], (uint8_t *)(&ch), 1))
     {
@@ -291,6 +757,35 @@ static uint32_t DbgConsole_ScanIgnoreWhiteSpace(const char **s)
     return count;
 }
 
+/*!
+ * @brief Sends the collected characters in one piece and empties the line buffer.
+ *
+ * @param[in] line  Line buffer.
+ */
+static void DbgConsole_LineFlush(debug_console_line_t *line)
+{
+    if (0U != line->length)
+    {
+        (void)DbgConsole_Write((const uint8_t *)line->buffer, line->length);
+        line->length = 0U;
+    }
+}
+
+/*!
+ * @brief Appends one character to the line buffer, sends the buffer first when it is full.
+ *
+ * @param[in] line  Line buffer.
+ * @param[in] c     Character to append.
+ */
+static inline void DbgConsole_LinePut(debug_console_line_t *line, char c)
+{
+    if (line->length == PRINTF_LINE_SIZE)
+    {
+        DbgConsole_LineFlush(line);
+    }
+    line->buffer[line->length++] = c;
+}
+
 /*!
  * @brief This function puts padding character.
  *
@@ -298,20 +793,68 @@ static uint32_t DbgConsole_ScanIgnoreWhiteSpace(const char **s)
  * @param[in] curlen    Length of current formatted string .
  * @param[in] width     Width of expected formatted string.
  * @param[in] count     Number of characters.
- * @param[in] func_ptr  Function to put character out.
+ * @param[in] line      Line buffer the characters go to.
  */
 static void DbgConsole_PrintfPaddingCharacter(
-    char c, int32_t curlen, int32_t width, int32_t *count, PUTCHAR_FUNC func_ptr)
+    char c, int32_t curlen, int32_t width, int32_t *count, debug_console_line_t *line)
 {
     int32_t i;
 
     for (i = curlen; i < width; i++)
     {
-        (void)func_ptr(c);
+        DbgConsole_LinePut(line, c);
         (*count)++;
     }
 }
 
+/*! @brief Two decimal digits per table lookup, "00" to "99". */
+static const char s_decimalPairs[200] = {
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+    '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+    '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+    '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+    '4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+    '5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+    '6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+    '7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+    '8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9'};
+
+/*!
+ * @brief Writes the decimal digits of a 32 bit value in reverse order.
+ *
+ * @param[in] nstrp  Where the least significant digit goes.
+ * @param[in] value  The value, 0 gives one digit.
+
+ * @return Position behind the most significant digit.
+ */
+static char *DbgConsole_ConvertDecimalToString(char *nstrp, uint32_t value)
+{
+    uint32_t q;
+    uint32_t pair;
+
+    while (value >= 100U)
+    {
+        /* value / 100 for every 32 bit value: multiply by 2^37 / 100 rounded up. */
+        q        = (uint32_t)(((uint64_t)value * 0x51EB851FU) >> 37U);
+        pair     = value - (q * 100U);
+        value    = q;
+        *nstrp++ = s_decimalPairs[(pair * 2U) + 1U];
+        *nstrp++ = s_decimalPairs[pair * 2U];
+    }
+    if (value >= 10U)
+    {
+        *nstrp++ = s_decimalPairs[(value * 2U) + 1U];
+        *nstrp++ = s_decimalPairs[value * 2U];
+    }
+    else
+    {
+        *nstrp++ = (char)('0' + value);
+    }
+
+    return nstrp;
+}
+
 /*!
  * @brief Converts a radix number to a string and return its length.
  *
@@ -325,241 +868,275 @@ static void DbgConsole_PrintfPaddingCharacter(
  */
 static int32_t DbgConsole_ConvertRadixNumToString(char *numstr, void *nump, int32_t neg, int32_t radix, bool use_caps)
 {
+    const char *digits = use_caps ? "0123456789ABCDEF" : "0123456789abcdef";
 #if PRINTF_ADVANCED_ENABLE
-    int64_t a;
-    int64_t b;
-    int64_t c;
-
     uint64_t ua;
-    uint64_t ub;
-    uint64_t uc;
-#else
-    int32_t a;
-    int32_t b;
-    int32_t c;
-
-    uint32_t ua;
-    uint32_t ub;
-    uint32_t uc;
 #endif /* PRINTF_ADVANCED_ENABLE */
-
-    int32_t nlen;
+    uint32_t ua32;
+#if PRINTF_ADVANCED_ENABLE
+    uint32_t pair;
+#endif /* PRINTF_ADVANCED_ENABLE */
+    uint32_t shift;
     char *nstrp;
 
-    nlen     = 0;
     nstrp    = numstr;
     *nstrp++ = '\0';
 
-#if !(PRINTF_ADVANCED_ENABLE > 0)
-    neg = 0;
-#endif
-
+#if PRINTF_ADVANCED_ENABLE
+    /* Work on the magnitude, the caller prints the sign. */
     if (0 != neg)
     {
-#if PRINTF_ADVANCED_ENABLE
-        a = *(int64_t *)nump;
+        ua = (*(int64_t *)nump < 0) ? (0U - (uint64_t)(*(int64_t *)nump)) : (uint64_t)(*(int64_t *)nump);
+    }
+    else
+    {
+        ua = *(uint64_t *)nump;
+    }
 #else
-        a = *(int32_t *)nump;
+    (void)neg;
+    ua32 = *(uint32_t *)nump;
 #endif /* PRINTF_ADVANCED_ENABLE */
-        if (a == 0)
+
+    /* The string is built in reverse order, least significant digit first. */
+    if (10 == radix)
+    {
+#if PRINTF_ADVANCED_ENABLE
+        /* 64 bit values need library division until they fit 32 bits. */
+        while (ua > 0xFFFFFFFFU)
         {
-            *nstrp = '0';
-            ++nlen;
-            return nlen;
+            pair     = (uint32_t)(ua % 100U);
+            ua       = ua / 100U;
+            *nstrp++ = s_decimalPairs[(pair * 2U) + 1U];
+            *nstrp++ = s_decimalPairs[pair * 2U];
         }
-        while (a != 0)
-        {
-#if PRINTF_ADVANCED_ENABLE
-            b = (int64_t)a / (int64_t)radix;
-            c = (int64_t)a - ((int64_t)b * (int64_t)radix);
-            if (c < 0)
-            {
-                c = (int64_t)'0' - c;
-            }
-#else
-            b = a / radix;
-            c = a - (b * radix);
-            if (c < 0)
-            {
-                c = (int32_t)'0' - c;
-            }
+        ua32 = (uint32_t)ua;
 #endif /* PRINTF_ADVANCED_ENABLE */
-            else
-            {
-                c = c + '0';
-            }
-            a        = b;
-            *nstrp++ = (char)c;
-            ++nlen;
-        }
+        nstrp = DbgConsole_ConvertDecimalToString(nstrp, ua32);
     }
     else
     {
+        /* 16, 8 and 2 are powers of two, shift and mask. */
+        shift = (16 == radix) ? 4U : ((8 == radix) ? 3U : 1U);
 #if PRINTF_ADVANCED_ENABLE
-        ua = *(uint64_t *)nump;
+        do
+        {
+            *nstrp++ = digits[(uint32_t)ua & ((uint32_t)radix - 1U)];
+            ua >>= shift;
+        } while (ua != 0U);
 #else
-        ua = *(uint32_t *)nump;
+        do
+        {
+            *nstrp++ = digits[ua32 & ((uint32_t)radix - 1U)];
+            ua32 >>= shift;
+        } while (ua32 != 0U);
 #endif /* PRINTF_ADVANCED_ENABLE */
-        if (ua == 0U)
+    }
+
+    return (int32_t)(nstrp - numstr) - 1;
+}
+
+#if PRINTF_FLOAT_ENABLE
+/*! @brief 10^n as a scale for the fraction, exact in double. */
+static const double s_floatScale[PRINTF_FLOAT_MAX_PRECISION + 1U] = {1e0, 1e1, 1e2, 1e3, 1e4,
+                                                                    1e5, 1e6, 1e7, 1e8, 1e9};
+/*! @brief 10^n as the limit a rounded fraction carries into the integer part at. */
+static const uint32_t s_floatLimit[PRINTF_FLOAT_MAX_PRECISION + 1U] = {
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U};
+
+/*!
+ * @brief Writes the integer digits of a double of 2^64 and above, least significant first.
+ *
+ * @note The slow path: the value is its mantissa times 2^exponent, expanded into 32 bit
+ * words and divided by 10^9 until nothing is left, so every digit is exact.
+ *
+ * @param[in] nstrp  Where the least significant digit goes.
+ * @param[in] m      The magnitude, finite and at least 2^64.
+ *
+ * @return Position after the most significant digit.
+ */
+static char *DbgConsole_ConvertLargeFloatToString(char *nstrp, double m)
+{
+    uint32_t words[PRINTF_FLOAT_BIG_WORDS];
+    uint64_t bits;
+    uint64_t rem;
+    uint32_t count;
+    uint32_t shift;
+    uint32_t chunk;
+    uint32_t i;
+
+    (void)memcpy(&bits, &m, sizeof(bits));
+    /* At least 2^64, so normal and the exponent is 12 or more. */
+    shift = (uint32_t)((bits >> 52) & 0x7FFU) - 1075U;
+    bits  = (bits & 0x000FFFFFFFFFFFFFULL) | 0x0010000000000000ULL;
+
+    count = shift / 32U;
+    shift = shift % 32U;
+    for (i = 0U; i < count; i++)
+    {
+        words[i] = 0U;
+    }
+    words[count]      = (uint32_t)(bits << shift);
+    words[count + 1U] = (uint32_t)(bits >> (32U - shift));
+    words[count + 2U] = (shift > 0U) ? (uint32_t)(bits >> (64U - shift)) : 0U;
+    count += 3U;
+
+    while (count > 0U)
+    {
+        while ((count > 0U) && (words[count - 1U] == 0U))
         {
-            *nstrp = '0';
-            ++nlen;
-            return nlen;
+            count--;
         }
-        while (ua != 0U)
+        rem = 0U;
+        for (i = count; i > 0U; i--)
         {
-#if PRINTF_ADVANCED_ENABLE
-            ub = (uint64_t)ua / (uint64_t)radix;
-            uc = (uint64_t)ua - ((uint64_t)ub * (uint64_t)radix);
-#else
-            ub = ua / (uint32_t)radix;
-            uc = ua - (ub * (uint32_t)radix);
-#endif /* PRINTF_ADVANCED_ENABLE */
-
-            if (uc < 10U)
-            {
-                uc = uc + '0';
-            }
-            else
-            {
-                uc = uc - 10U + (use_caps ? 'A' : 'a');
-            }
-            ua       = ub;
-            *nstrp++ = (char)uc;
-            ++nlen;
+            rem           = (rem << 32) | words[i - 1U];
+            words[i - 1U] = (uint32_t)(rem / 1000000000U);
+            rem           = rem % 1000000000U;
+        }
+        while ((count > 0U) && (words[count - 1U] == 0U))
+        {
+            count--;
+        }
+        /* Nine digits, the leading zeros of the most significant group left out. */
+        chunk = (uint32_t)rem;
+        for (i = 0U; (i < 9U) && ((count > 0U) || (chunk != 0U)); i++)
+        {
+            *nstrp++ = (char)('0' + (chunk % 10U));
+            chunk    = chunk / 10U;
         }
     }
-    return nlen;
+
+    return nstrp;
 }
 
-#if PRINTF_FLOAT_ENABLE
 /*!
  * @brief Converts a floating radix number to a string and return its length.
  *
+ * @note The fraction is scaled once by 10^precision, rounded half up and converted as an
+ * integer, so the cost does not depend on the value. The caller prints the sign. NaN and
+ * infinity print as nan and inf. Magnitudes of 2^64 and above are integers, their digits
+ * come from the slow DbgConsole_ConvertLargeFloatToString(). Fraction digits past
+ * PRINTF_FLOAT_MAX_PRECISION are not in the string, the caller prints *zeros of them.
+ *
  * @param[in] numstr            Converted string of the number.
  * @param[in] nump              Pointer to the number.
- * @param[in] radix             The radix to be converted to.
+ * @param[in] radix             The radix to be converted to, only 10.
  * @param[in] precision_width   Specify the precision width.
+ * @param[out] zeros            Zeros the caller appends to the fraction.
 
  * @return Length of the converted string.
  */
 static int32_t DbgConsole_ConvertFloatRadixNumToString(char *numstr,
                                                        void *nump,
                                                        int32_t radix,
-                                                       uint32_t precision_width)
+                                                       uint32_t precision_width,
+                                                       uint32_t *zeros)
 {
-    int32_t a;
-    int32_t b;
-    int32_t c;
-    uint32_t i;
-    double fa;
-    double dc;
-    double fb;
+    const char *special;
     double r;
-    double fractpart;
-    double intpart;
-
-    int32_t nlen;
+    double m;
+    uint64_t intpart;
+    uint32_t fractpart;
+    uint32_t pair;
+    uint32_t i;
     char *nstrp;
-    nlen     = 0;
+
+    (void)radix;
     nstrp    = numstr;
     *nstrp++ = '\0';
     r        = *(double *)nump;
-    if (0.0 == r)
-    {
-        *nstrp = '0';
-        ++nlen;
-        return nlen;
-    }
-    fractpart = modf((double)r, (double *)&intpart);
-    /* Process fractional part. */
-    for (i = 0; i < precision_width; i++)
-    {
-        fractpart *= (double)radix;
-    }
-    if (r >= 0.0)
+    m        = (r < 0.0) ? -r : r;
+    *zeros   = 0U;
+
+    /* Reversed like the digits. */
+    if ((r != r) || (isinf(m) != 0))
     {
-        fa = fractpart + (double)0.5;
-        if (fa >= pow((double)10, (double)precision_width))
+        for (special = (r != r) ? "nan" : "fni"; *special != '\0'; special++)
         {
-            intpart++;
+            *nstrp++ = *special;
         }
+        return 3;
     }
-    else
+    if (precision_width > PRINTF_FLOAT_MAX_PRECISION)
     {
-        fa = fractpart - (double)0.5;
-        if (fa <= -pow((double)10, (double)precision_width))
-        {
-            intpart--;
-        }
+        *zeros          = precision_width - PRINTF_FLOAT_MAX_PRECISION;
+        precision_width = PRINTF_FLOAT_MAX_PRECISION;
     }
-    for (i = 0; i < precision_width; i++)
+
+    if (m >= 18446744073709551616.0)
     {
-        fb = fa / (double)radix;
-        dc = (fa - (double)(int64_t)fb * (double)radix);
-        c  = (int32_t)dc;
-        if (c < 0)
+        /* No fraction bits left at this size. */
+        for (i = 0U; i < precision_width; i++)
         {
-            c = (int32_t)'0' - c;
+            *nstrp++ = '0';
         }
-        else
+        if (precision_width > 0U)
         {
-            c = c + '0';
+            *nstrp++ = '.';
         }
-        fa       = fb;
-        *nstrp++ = (char)c;
-        ++nlen;
+        nstrp = DbgConsole_ConvertLargeFloatToString(nstrp, m);
+        return (int32_t)(nstrp - numstr) - 1;
     }
-    *nstrp++ = (char)'.';
-    ++nlen;
-    a = (int32_t)intpart;
-    if (a == 0)
+
+    /* Below 2^32 the FPU converts, above the library does. */
+    intpart = (m < 4294967296.0) ? (uint64_t)(uint32_t)m : (uint64_t)m;
+    /* m - intpart is exact, the only rounding is the scaling. */
+    fractpart = (uint32_t)(((m - (double)intpart) * s_floatScale[precision_width]) + 0.5);
+    if (fractpart >= s_floatLimit[precision_width])
     {
-        *nstrp++ = '0';
-        ++nlen;
+        fractpart -= s_floatLimit[precision_width];
+        intpart++;
     }
-    else
+
+    /* Fraction, least significant digit first and with its leading zeros. */
+    for (i = precision_width; i >= 2U; i -= 2U)
     {
-        while (a != 0)
-        {
-            b = (int32_t)a / (int32_t)radix;
-            c = (int32_t)a - ((int32_t)b * (int32_t)radix);
-            if (c < 0)
-            {
-                c = (int32_t)'0' - c;
-            }
-            else
-            {
-                c = c + '0';
-            }
-            a        = b;
-            *nstrp++ = (char)c;
-            ++nlen;
-        }
+        pair      = fractpart % 100U;
+        fractpart = fractpart / 100U;
+        *nstrp++  = s_decimalPairs[(pair * 2U) + 1U];
+        *nstrp++  = s_decimalPairs[pair * 2U];
     }
-    return nlen;
+    if (i == 1U)
+    {
+        *nstrp++ = (char)('0' + fractpart);
+    }
+    if (precision_width > 0U)
+    {
+        *nstrp++ = '.';
+    }
+
+    while (intpart > 0xFFFFFFFFU)
+    {
+        pair     = (uint32_t)(intpart % 100U);
+        intpart  = intpart / 100U;
+        *nstrp++ = s_decimalPairs[(pair * 2U) + 1U];
+        *nstrp++ = s_decimalPairs[pair * 2U];
+    }
+    nstrp = DbgConsole_ConvertDecimalToString(nstrp, (uint32_t)intpart);
+
+    return (int32_t)(nstrp - numstr) - 1;
 }
 #endif /* PRINTF_FLOAT_ENABLE */
 
 /*!
  * @brief This function outputs its parameters according to a formatted string.
  *
- * @note I/O is performed by calling given function pointer using following
- * (*func_ptr)(c);
+ * @note The output is collected in the line buffer, a full buffer is sent and reused, the
+ * caller sends what is left with DbgConsole_LineFlush().
  *
- * @param[in] func_ptr  Function to put character out.
+ * @param[in] line      Line buffer the characters go to.
  * @param[in] fmt_ptr   Format string for printf.
  * @param[in] args_ptr  Arguments to printf.
  *
  * @return Number of characters
  */
-static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt, va_list ap)
+static int DbgConsole_PrintfFormattedData(debug_console_line_t *line, const char *fmt, va_list ap)
 {
     /* va_list ap; */
     const char *p;
     char c;
 
-    char vstr[33];
+    char vstr[PRINTF_NUMBER_BUFFER_SIZE];
     char *vstrp  = NULL;
     int32_t vlen = 0;
 
@@ -587,6 +1164,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
 
 #if PRINTF_FLOAT_ENABLE
     double fval;
+    uint32_t fzeros = 0U;
 #endif /* PRINTF_FLOAT_ENABLE */
 
     /* Start parsing apart the format string and display appropriate formats and data. */
@@ -606,7 +1184,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
          */
         if (c != '%')
         {
-            (void)func_ptr(c);
+            DbgConsole_LinePut(line, c);
             count++;
             p++;
             /* By using 'continue', the next iteration of the loop is used, skipping the code that follows. */
@@ -798,22 +1376,22 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     {
                         if ('\0' != schar)
                         {
-                            (void)func_ptr(schar);
+                            DbgConsole_LinePut(line, schar);
                             count++;
                         }
                         dschar = true;
 
-                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, func_ptr);
+                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, line);
                         vlen = (int32_t)field_width;
                     }
                     else
                     {
                         if (0U == (flags_used & (uint32_t)kPRINTF_Minus))
                         {
-                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                             if ('\0' != schar)
                             {
-                                (void)func_ptr(schar);
+                                DbgConsole_LinePut(line, schar);
                                 count++;
                             }
                             dschar = true;
@@ -822,7 +1400,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     /* The string was built in reverse order, now display in correct order. */
                     if ((!dschar) && ('\0' != schar))
                     {
-                        (void)func_ptr(schar);
+                        DbgConsole_LinePut(line, schar);
                         count++;
                     }
 #endif /* PRINTF_ADVANCED_ENABLE */
@@ -832,8 +1410,9 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                 if ((c == 'f') || (c == 'F'))
                 {
                     fval  = (double)va_arg(ap, double);
-                    vlen  = DbgConsole_ConvertFloatRadixNumToString(vstr, &fval, 10, precision_width);
+                    vlen  = DbgConsole_ConvertFloatRadixNumToString(vstr, &fval, 10, precision_width, &fzeros);
                     vstrp = &vstr[vlen];
+                    vlen += (int32_t)fzeros;
 
 #if PRINTF_ADVANCED_ENABLE
                     if (fval < 0.0)
@@ -866,21 +1445,21 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     {
                         if ('\0' != schar)
                         {
-                            (void)func_ptr(schar);
+                            DbgConsole_LinePut(line, schar);
                             count++;
                         }
                         dschar = true;
-                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, func_ptr);
+                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, line);
                         vlen = (int32_t)field_width;
                     }
                     else
                     {
                         if (0U == (flags_used & (uint32_t)kPRINTF_Minus))
                         {
-                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                             if ('\0' != schar)
                             {
-                                (void)func_ptr(schar);
+                                DbgConsole_LinePut(line, schar);
                                 count++;
                             }
                             dschar = true;
@@ -888,7 +1467,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     }
                     if ((!dschar) && ('\0' != schar))
                     {
-                        (void)func_ptr(schar);
+                        DbgConsole_LinePut(line, schar);
                         count++;
                     }
 #endif /* PRINTF_ADVANCED_ENABLE */
@@ -919,13 +1498,13 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     {
                         if (0U != (flags_used & (uint32_t)kPRINTF_Pound))
                         {
-                            (void)func_ptr('0');
-                            (void)func_ptr((use_caps ? 'X' : 'x'));
+                            DbgConsole_LinePut(line, '0');
+                            DbgConsole_LinePut(line, (use_caps ? 'X' : 'x'));
                             count += 2;
                             /*vlen += 2;*/
                             dschar = true;
                         }
-                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, func_ptr);
+                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, line);
                         vlen = (int32_t)field_width;
                     }
                     else
@@ -936,11 +1515,11 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                             {
                                 vlen += 2;
                             }
-                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                             if (0U != (flags_used & (uint32_t)kPRINTF_Pound))
                             {
-                                (void)func_ptr('0');
-                                (void)func_ptr(use_caps ? 'X' : 'x');
+                                DbgConsole_LinePut(line, '0');
+                                DbgConsole_LinePut(line, (use_caps ? 'X' : 'x'));
                                 count += 2;
 
                                 dschar = true;
@@ -950,8 +1529,8 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
 
                     if ((0U != (flags_used & (uint32_t)kPRINTF_Pound)) && (!dschar))
                     {
-                        (void)func_ptr('0');
-                        (void)func_ptr(use_caps ? 'X' : 'x');
+                        DbgConsole_LinePut(line, '0');
+                        DbgConsole_LinePut(line, (use_caps ? 'X' : 'x'));
                         count += 2;
                         vlen += 2;
                     }
@@ -992,40 +1571,44 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
 #if PRINTF_ADVANCED_ENABLE
                     if (0U != (flags_used & (uint32_t)kPRINTF_Zero))
                     {
-                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, func_ptr);
+                        DbgConsole_PrintfPaddingCharacter('0', vlen, (int32_t)field_width, &count, line);
                         vlen = (int32_t)field_width;
                     }
                     else
                     {
                         if (0U == (flags_used & (uint32_t)kPRINTF_Minus))
                         {
-                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                            DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                         }
                     }
 #endif /* PRINTF_ADVANCED_ENABLE */
                 }
 #if !PRINTF_ADVANCED_ENABLE
-                DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
 #endif /* !PRINTF_ADVANCED_ENABLE */
                 if (vstrp != NULL)
                 {
                     while ('\0' != *vstrp)
                     {
-                        (void)func_ptr(*vstrp--);
+                        DbgConsole_LinePut(line, *vstrp--);
                         count++;
                     }
                 }
+#if PRINTF_FLOAT_ENABLE
+                DbgConsole_PrintfPaddingCharacter('0', 0, (int32_t)fzeros, &count, line);
+                fzeros = 0U;
+#endif /* PRINTF_FLOAT_ENABLE */
 #if PRINTF_ADVANCED_ENABLE
                 if (0U != (flags_used & (uint32_t)kPRINTF_Minus))
                 {
-                    DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                    DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                 }
 #endif /* PRINTF_ADVANCED_ENABLE */
             }
             else if (c == 'c')
             {
                 cval = (int32_t)va_arg(ap, uint32_t);
-                (void)func_ptr(cval);
+                DbgConsole_LinePut(line, (char)cval);
                 count++;
             }
             else if (c == 's')
@@ -1049,7 +1632,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     if (0U == (flags_used & (uint32_t)kPRINTF_Minus))
 #endif /* PRINTF_ADVANCED_ENABLE */
                     {
-                        DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                        DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                     }
 
 #if PRINTF_ADVANCED_ENABLE
@@ -1057,7 +1640,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
                     {
                         while (('\0' != *sval) && (vlen > 0))
                         {
-                            (void)func_ptr(*sval++);
+                            DbgConsole_LinePut(line, *sval++);
                             count++;
                             vlen--;
                         }
@@ -1069,7 +1652,7 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
 #endif /* PRINTF_ADVANCED_ENABLE */
                         while ('\0' != *sval)
                         {
-                            (void)func_ptr(*sval++);
+                            DbgConsole_LinePut(line, *sval++);
                             count++;
                         }
 #if PRINTF_ADVANCED_ENABLE
@@ -1079,14 +1662,14 @@ static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt
 #if PRINTF_ADVANCED_ENABLE
                     if (0U != (flags_used & (uint32_t)kPRINTF_Minus))
                     {
-                        DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, func_ptr);
+                        DbgConsole_PrintfPaddingCharacter(' ', vlen, (int32_t)field_width, &count, line);
                     }
 #endif /* PRINTF_ADVANCED_ENABLE */
                 }
             }
             else
             {
-                (void)func_ptr(c);
+                DbgConsole_LinePut(line, c);
                 count++;
             }
         }
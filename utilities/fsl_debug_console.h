@@ -67,6 +67,32 @@
 #define SCANF_ADVANCED_ENABLE 0U
 #endif /* SCANF_ADVANCED_ENABLE */
 
+/*! @brief Definition to queue PRINTF and PUTCHAR output in a ring drained by the LPUART transmit interrupt.
+ *
+ * The caller only pays for formatting, characters that do not fit the ring are dropped and counted
+ * (DbgConsole_GetDropCount()). The ring has one producer: print from thread level only, not from
+ * interrupts. The same interrupt puts received characters into a second ring, DbgConsole_TryGetchar()
+ * reads it without waiting, GETCHAR and SCANF wait on it.
+ */
+#ifndef DEBUG_CONSOLE_TX_ASYNC
+#define DEBUG_CONSOLE_TX_ASYNC 0U
+#endif /* DEBUG_CONSOLE_TX_ASYNC */
+
+/*! @brief Definition of the asynchronous transmit ring size in bytes, power of 2. */
+#ifndef DEBUG_CONSOLE_TX_RING_SIZE
+#define DEBUG_CONSOLE_TX_RING_SIZE 2048U
+#endif /* DEBUG_CONSOLE_TX_RING_SIZE */
+
+/*! @brief Definition of the asynchronous receive ring size in bytes, power of 2. */
+#ifndef DEBUG_CONSOLE_RX_RING_SIZE
+#define DEBUG_CONSOLE_RX_RING_SIZE 256U
+#endif /* DEBUG_CONSOLE_RX_RING_SIZE */
+
+/*! @brief Definition of the LPUART interrupt handler that serves both rings, the vector of the console instance. */
+#ifndef DEBUG_CONSOLE_TX_IRQ_HANDLER
+#define DEBUG_CONSOLE_TX_IRQ_HANDLER LPUART1_IRQHandler
+#endif /* DEBUG_CONSOLE_TX_IRQ_HANDLER */
+
 /*! @brief Definition to select redirect toolchain printf, scanf to uart or not.
  *
  *  if SDK_DEBUGCONSOLE defined to 0,it represents select toolchain printf, scanf.
@@ -95,6 +121,7 @@ typedef enum _serial_port_type
 {
     kSerialPort_None = 0U, /*!< Serial port is none */
     kSerialPort_Uart = 1U, /*!< Serial port UART */
+    kSerialPort_Swo  = 3U, /*!< ITM stimulus ports over the SWO pin */
 } serial_port_type_t;
 
 /*******************************************************************************
@@ -123,10 +150,14 @@ extern "C" {
  *                      is LPUART1.
  *                      If the uart_adapter.c is added to the current project, the UART periheral
  *                      is UART1.
- * @param baudRate      The desired baud rate in bits per second.
+ *                      If the device is kSerialPort_Swo, the instance is the ITM stimulus port
+ *                      (0..31) PRINTF and PUTCHAR write to.
+ * @param baudRate      The desired baud rate in bits per second, the SWO bit rate for kSerialPort_Swo.
  * @param device        Low level device type for the debug console, can be one of the following.
  *                      @arg kSerialPort_Uart.
- * @param clkSrcFreq    Frequency of peripheral source clock.
+ *                      @arg kSerialPort_Swo, output only: the ITM and the TPIU (SWO, NRZ encoding,
+ *                      formatter off) are set up, the SWO pin mux and trace clock are the caller's.
+ * @param clkSrcFreq    Frequency of peripheral source clock, the trace clock for kSerialPort_Swo.
  *
  * @return              Indicates whether initialization was successful or not.
  * @retval kStatus_Success          Execution successfully
@@ -211,6 +242,59 @@ int DbgConsole_Scanf(char *fmt_ptr, ...);
  */
 int DbgConsole_Getchar(void);
 
+/*!
+ * @brief Reads a character from stdin without waiting.
+ *
+ * With DEBUG_CONSOLE_TX_ASYNC the character comes from the receive ring the LPUART interrupt fills,
+ * otherwise the LPUART is polled once, so input that arrives while nobody calls this is lost.
+ *
+ * @return Returns the character read, or -1 if none is waiting or the console has no input (SWO).
+ */
+int DbgConsole_TryGetchar(void);
+
+/*!
+ * @brief Writes a block of raw bytes to stdout.
+ *
+ * With DEBUG_CONSOLE_TX_ASYNC the block is queued as a whole or, when the ring has no room for
+ * all of it, dropped as a whole and counted, so binary records never arrive cut.
+ *
+ * @param   data   Bytes to send.
+ * @param   length Number of bytes.
+ * @return  Returns length, or -1 if the block was dropped or the debug console is not initialized.
+ */
+int DbgConsole_Write(const uint8_t *data, size_t length);
+
+/*!
+ * @brief Writes a block of raw bytes to one ITM stimulus port.
+ *
+ * With kSerialPort_Swo the block goes out on the given stimulus port so the host can tell it from
+ * the text on the console port, with the UART it is the same as DbgConsole_Write().
+ *
+ * @param   port   ITM stimulus port, 0..31.
+ * @param   data   Bytes to send.
+ * @param   length Number of bytes.
+ * @return  Returns length, or -1 if the block was dropped or the debug console is not initialized.
+ */
+int DbgConsole_WritePort(uint8_t port, const uint8_t *data, size_t length);
+
+/*!
+ * @brief Waits until all queued output has been sent.
+ *
+ * With DEBUG_CONSOLE_TX_ASYNC the ring is drained and the last stop bit has left the UART when
+ * this returns, it also works with interrupts masked. In blocking mode there is nothing to wait for.
+ * With kSerialPort_Swo it waits until the ITM has passed everything on to the TPIU.
+ *
+ * @return Returns kStatus_Success, or kStatus_Fail if the debug console is not initialized.
+ */
+status_t DbgConsole_Flush(void);
+
+/*!
+ * @brief Returns the number of characters dropped because the transmit ring was full.
+ *
+ * @return Returns the drop count since DbgConsole_Init(), always 0 in blocking mode.
+ */
+uint32_t DbgConsole_GetDropCount(void);
+
 #endif /* SDK_DEBUGCONSOLE */
 
 /*! @} */